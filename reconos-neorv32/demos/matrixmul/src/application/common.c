@@ -7,20 +7,21 @@
 #include "mmp.h"
 #include <sys/time.h>
 #include "matrix_functions.h"
+#include "reconos.h"
 
 //#define xmalloc_aligned(a,b) malloc(a)
 void *xmalloc_aligned(size_t size, size_t alignment)
 {
-	int ret;
-	void *ptr;
-
 	assert(size!=0);
+	assert(alignment<=PAGE_SIZE);
 
-	ret = posix_memalign(&ptr, alignment, size);
-	
-	assert(ret==0);
+	// pre-faulted and pinned to avoid page faults of the hardware threads
+	return reconos_alloc_shared(size, RECONOS_ALLOC_PIN);
+}
 
-	return ptr;
+void xfree_aligned(void *ptr)
+{
+	reconos_free_shared(ptr);
 }
 
 
@@ -108,7 +109,11 @@ void print_matrix(int *matrix, char matrix_name, int matrix_size) {
 int compare_result(int *result, int *compare, int matrix_size) {
 	int i;
 	for (i=0; i<matrix_size*matrix_size; ++i) {
+#if MMP_FRAC_BITS > 0
+		if (abs(result[i] - compare[i]) > MMP_FRAC_TOLERANCE) {
+#else
 		if (result[i] != compare[i]) {
+#endif
 			return i;
 		}
 	}
@@ -9,6 +9,16 @@
  * with new constraints, if you change STD_MMP_MATRIX_SIZE.
  */
 #define STD_MMP_MATRIX_SIZE 128
+
+/*
+ * Number of fractional bits of the elements, 0 for integer matrices.
+ * Must match MMP_FRAC_BITS of a hardware thread using fixed point
+ * (HwSource = hls,MMP_TYPE=MMP_FIXED,MMP_FRAC_BITS=...). Products are rounded per block
+ * multiplication, so that the Strassen result may deviate from the
+ * direct product by up to MMP_FRAC_TOLERANCE.
+ */
+#define MMP_FRAC_BITS 0
+#define MMP_FRAC_TOLERANCE 64
 //#define STR_MMP_INPUT_MATRIX_SIZE 512
 
 // 2 recursive steps (512->256->128) => 7^2=49
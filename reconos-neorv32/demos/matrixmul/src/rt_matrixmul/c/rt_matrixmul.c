@@ -9,19 +9,20 @@
 
 void std_matrix_mul(int *i_matrix_a, int *i_matrix_b, int *o_matrix_c, int matrix_size) {
 	int i, j, k;
-	printf("std_matrix_mul i:");fflush(0);
 	for (i=0; i<matrix_size; ++i) {
-		printf(" %i ", i);fflush(0);
 		for (j=0; j<matrix_size; ++j) {
+#if MMP_FRAC_BITS > 0
+			long long temp = 0;
+#else
 			int temp = 0;
+#endif
 			int pos = i*matrix_size;
 			for (k=0; k<matrix_size; ++k) {
-				temp += i_matrix_a[pos+k]*i_matrix_b[k*matrix_size+j];
+				temp += (long long)i_matrix_a[pos+k]*i_matrix_b[k*matrix_size+j];
 			}
-			o_matrix_c[pos+j] = temp;
+			o_matrix_c[pos+j] = (int)(temp >> MMP_FRAC_BITS);
 		}
 	}
-	printf ("\n");
 }
 
 THREAD_ENTRY() {
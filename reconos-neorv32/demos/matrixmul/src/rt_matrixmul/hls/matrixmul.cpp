@@ -0,0 +1,166 @@
+// request whole pages to stream the matrices at full bandwidth
+#define MEMIF_CHUNK_WORDS 1024
+
+#include "reconos_calls.h"
+#include "reconos_thread.h"
+
+#include "stdint.h"
+
+/*
+ * Matrix multiplication of STD_MMP_MATRIX_SIZE blocks on a systolic array
+ * of MMP_TILE x MMP_TILE processing elements. The thread receives the
+ * address of the pointers to the matrices a, b and c from the Strassen
+ * driver (see str_mmp.c), reads b once, and then for each panel of
+ * MMP_TILE rows of a computes the corresponding rows of c tile by tile.
+ *
+ * The tile size and the type of the elements are selected in build.cfg
+ * by options of the hardware source, e.g.
+ * "HwSource = hls,MMP_TILE=16,MMP_TYPE=MMP_INT16":
+ *
+ *   MMP_INT32 - 32 bit integers (default)
+ *   MMP_INT16 - 16 bit integers, halving ram and multipliers, the
+ *               elements in memory remain ints but must fit 16 bit
+ *   MMP_FIXED - fixed point numbers with MMP_FRAC_BITS fractional bits,
+ *               which must be given as well and match MMP_FRAC_BITS of
+ *               the application, e.g. "MMP_TYPE=MMP_FIXED,MMP_FRAC_BITS=16"
+ */
+
+#define MMP_INT32 0
+#define MMP_INT16 1
+#define MMP_FIXED 2
+
+// must match STD_MMP_MATRIX_SIZE of the application (see mmp.h)
+#ifndef MMP_SIZE
+#define MMP_SIZE 128
+#endif
+
+#ifndef MMP_TILE
+#define MMP_TILE 16
+#endif
+
+#ifndef MMP_TYPE
+#define MMP_TYPE MMP_INT32
+#endif
+
+// no default, since it must match MMP_FRAC_BITS of the application
+#if MMP_TYPE == MMP_FIXED && !defined(MMP_FRAC_BITS)
+#error "MMP_FIXED requires MMP_FRAC_BITS matching the application (see mmp.h)"
+#endif
+
+#if MMP_TYPE == MMP_INT16
+typedef int16_t mmp_t;
+typedef int32_t mmp_acc_t;
+#elif MMP_TYPE == MMP_FIXED
+typedef int32_t mmp_t;
+typedef int64_t mmp_acc_t;
+#else
+typedef int32_t mmp_t;
+typedef int32_t mmp_acc_t;
+#endif
+
+/*
+ * Computes the tile of c at column tj of the panel of rows of a. The
+ * rows of a enter the array from the left and the columns of b from the
+ * top, each skewed by one cycle per row or column, and are passed on to
+ * the neighbouring elements every cycle, while every element accumulates
+ * its result locally.
+ */
+void mmp_tile(mmp_t a[MMP_TILE * MMP_SIZE], mmp_t b[MMP_SIZE * MMP_SIZE],
+              int32_t c[MMP_TILE * MMP_SIZE], unsigned int tj) {
+	mmp_t a_reg[MMP_TILE][MMP_TILE];
+	mmp_t b_reg[MMP_TILE][MMP_TILE];
+	mmp_acc_t acc[MMP_TILE][MMP_TILE];
+#pragma HLS array_partition variable=a_reg complete dim=0
+#pragma HLS array_partition variable=b_reg complete dim=0
+#pragma HLS array_partition variable=acc complete dim=0
+
+	for (unsigned int i = 0; i < MMP_TILE; i++) {
+#pragma HLS unroll
+		for (unsigned int j = 0; j < MMP_TILE; j++) {
+#pragma HLS unroll
+			a_reg[i][j] = 0;
+			b_reg[i][j] = 0;
+			acc[i][j] = 0;
+		}
+	}
+
+	for (unsigned int t = 0; t < MMP_SIZE + 2 * MMP_TILE - 2; t++) {
+#pragma HLS pipeline II=1
+		// update from the last element to use the old values of the
+		// neighbours as inputs
+		for (int i = MMP_TILE - 1; i >= 0; i--) {
+#pragma HLS unroll
+			for (int j = MMP_TILE - 1; j >= 0; j--) {
+#pragma HLS unroll
+				mmp_t a_in, b_in;
+
+				if (j == 0) {
+					unsigned int k = t - i;
+					a_in = (t >= (unsigned int)i && k < MMP_SIZE) ? a[i * MMP_SIZE + k] : (mmp_t)0;
+				} else {
+					a_in = a_reg[i][j - 1];
+				}
+
+				if (i == 0) {
+					unsigned int k = t - j;
+					b_in = (t >= (unsigned int)j && k < MMP_SIZE) ? b[k * MMP_SIZE + tj * MMP_TILE + j] : (mmp_t)0;
+				} else {
+					b_in = b_reg[i - 1][j];
+				}
+
+				acc[i][j] += (mmp_acc_t)a_in * b_in;
+				a_reg[i][j] = a_in;
+				b_reg[i][j] = b_in;
+			}
+		}
+	}
+
+	for (unsigned int j = 0; j < MMP_TILE; j++) {
+#pragma HLS pipeline II=1
+		for (unsigned int i = 0; i < MMP_TILE; i++) {
+#pragma HLS unroll
+#if MMP_TYPE == MMP_FIXED
+			c[i * MMP_SIZE + tj * MMP_TILE + j] = (int32_t)(acc[i][j] >> MMP_FRAC_BITS);
+#else
+			c[i * MMP_SIZE + tj * MMP_TILE + j] = acc[i][j];
+#endif
+		}
+	}
+}
+
+THREAD_ENTRY() {
+	// the panels of a and c are partitioned by rows and b by columns to
+	// feed all rows and columns of the array in parallel
+	mmp_t a[MMP_TILE * MMP_SIZE];
+	mmp_t b[MMP_SIZE * MMP_SIZE];
+	int32_t c[MMP_TILE * MMP_SIZE];
+#pragma HLS array_partition variable=a block factor=MMP_TILE
+#pragma HLS array_partition variable=b cyclic factor=MMP_TILE
+#pragma HLS array_partition variable=c block factor=MMP_TILE
+	uint32_t ptrs[4];
+
+	THREAD_INIT();
+
+	while (1) {
+		uint32_t addr = MBOX_GET(resources_address);
+		if (addr == 0xFFFFFFFF) {
+			THREAD_EXIT();
+		}
+
+		// pointers to a, b and c followed by the position in the list
+		MEM_READ(addr, ptrs, 16);
+		MEM_READ(ptrs[1], b, MMP_SIZE * MMP_SIZE * 4);
+
+		for (unsigned int ti = 0; ti < MMP_SIZE / MMP_TILE; ti++) {
+			MEM_READ(ptrs[0] + ti * MMP_TILE * MMP_SIZE * 4, a, MMP_TILE * MMP_SIZE * 4);
+
+			for (unsigned int tj = 0; tj < MMP_SIZE / MMP_TILE; tj++) {
+				mmp_tile(a, b, c, tj);
+			}
+
+			MEM_WRITE(c, ptrs[2] + ti * MMP_TILE * MMP_SIZE * 4, MMP_TILE * MMP_SIZE * 4);
+		}
+
+		MBOX_PUT(resources_acknowledge, ptrs[2]);
+	}
+}
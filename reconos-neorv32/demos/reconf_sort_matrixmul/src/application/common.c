@@ -7,20 +7,21 @@
 #include "mmp.h"
 #include <sys/time.h>
 #include "matrix_functions.h"
+#include "reconos.h"
 
 //#define xmalloc_aligned(a,b) malloc(a)
 void *xmalloc_aligned(size_t size, size_t alignment)
 {
-	int ret;
-	void *ptr;
-
 	assert(size!=0);
+	assert(alignment<=PAGE_SIZE);
 
-	ret = posix_memalign(&ptr, alignment, size);
-	
-	assert(ret==0);
+	// pre-faulted and pinned to avoid page faults of the hardware threads
+	return reconos_alloc_shared(size, RECONOS_ALLOC_PIN);
+}
 
-	return ptr;
+void xfree_aligned(void *ptr)
+{
+	reconos_free_shared(ptr);
 }
 
 
@@ -8,6 +8,7 @@
 #define PAGE_SIZE 4096
 
 void *xmalloc_aligned(size_t size, size_t alignment);
+void xfree_aligned(void *ptr);
 
 void generate_data(int *input_matrixes[2], int **output_matrix, int matrix_size);
 void generate_result(int *input_matrixes[2], int **res, int matrix_size);
@@ -48,130 +48,6 @@ void print_help() {
 	);
 }
 
-/* functions for the reconfiguration */
-
-int reconfigure_xdevcfg(char* filename,unsigned int partial){
-
-	FILE *bitfile;
-	unsigned int size;
-	char *bitstream;
-
-	bitfile = fopen(filename, "rb");
-	if(!bitfile){
-		log("Error opening bitstream file %s\n",filename);
-		return -1;
-	}
-
-	fseek(bitfile,0L,SEEK_END);
-	size=ftell(bitfile);
-	rewind(bitfile);
-
-	bitstream = (char *)malloc(size*sizeof(char));
-	if(!bitstream){
-		log("Error allocating memory for bitstream %s\n",filename);
-		return -1;
-	}
-	fread(bitstream, sizeof(char), size, bitfile);
-	fclose(bitfile);
-
-	int fd_partial = open("/sys/devices/soc0/amba/f8007000.devcfg/is_partial_bitstream", O_RDWR);
-	if(fd_partial < 0){
-		log("Failed to open xdevcfg attribute 'is_partial_bitstream' when configuring %s\n",filename);
-		return -1;
-	}
-
-	char partial_flag[2];
-	if(!partial) {
-		strcpy(partial_flag,"0");
-	}
-	else {
-		strcpy(partial_flag,"1");
-	}
-	write(fd_partial, partial_flag, 2);
-	close(fd_partial);
-
-	fd_partial = open("/dev/xdevcfg", O_RDWR);
-	if(fd_partial < 0){
-		log("Failed to open xdevcfg device when configuring %s\n",filename);
-		return -1;
-	}
-	log("Opened xdevcfg. Configuring with %u bytes\n",size);
-	write(fd_partial, bitstream, size);
-	int fd_finish_flag = open("/sys/devices/soc0/amba/f8007000.devcfg/prog_done", O_RDWR);
-	char finish_flag = '0';
-
-	/* wait until reconfiguration is finished */
-	while(finish_flag != '1'){
-		read(fd_finish_flag,&finish_flag,1);
-	}
-	log("Reconfiguration with bitfile %s finished\n",filename);
-	close(fd_partial);
-	close(fd_finish_flag);
-
-	return 0;
-}
-
-int reconfigure_fpga_manager(char* filename,unsigned int partial){
-
-	//Check if bitstream file exists. For the FPGA Manager, it needs to be located at /lib/firmware/
-	char path [114] = "/lib/firmware/";
-	struct stat buffer;
-  	if (stat(strcat(path, filename), &buffer) != 0){
-		log("Bitstream file %s could not be found at /lib/firmware/\n",filename);
-		return -1;
-	}
-
-	int fd_partial = open("/sys/class/fpga_manager/fpga0/flags", O_RDWR);
-	if(fd_partial < 0){
-		log("Failed to open FPGA Manager attribute 'flags' when configuring %s\n",filename);
-		return -1;
-	}
-
-	char partial_flag[2];
-	if(!partial){
-		strcpy(partial_flag,"0");
-	}
-	else {
-		strcpy(partial_flag,"1");
-	}
-
-	write(fd_partial, partial_flag, 2);
-	close(fd_partial);
-
-	fd_partial = open("/sys/class/fpga_manager/fpga0/firmware", O_WRONLY);
-	if(fd_partial < 0){
-		log("Failed to open FPGA Manager attribute 'firmware' when configuring %s\n",filename);
-		return -1;
-	}
-	log("Opened FPGA Manager. Initiating bitstream reconfiguration\n");
-	write(fd_partial, filename, strlen(filename));
-
-	int fd_finish_flag = open("/sys/class/fpga_manager/fpga0/state", O_RDONLY);
-	char finish_flag[32];
-
-	/* wait until reconfiguration is finished */
-	while(strncmp(finish_flag, "operating", 9)){
-		read(fd_finish_flag,finish_flag,32);
-	}
-	log("Reconfiguration with bitfile %s finished\n",filename);
-	close(fd_partial);
-	close(fd_finish_flag);
-
-	return 0;
-}
-
-int reconfigure(char* filename,unsigned int partial){
-	struct stat buffer;
-	if (stat("/dev/xdevcfg", &buffer) == 0){
-		//Xilinx xdevcfg driver found (older kernel versions)
-		return reconfigure_xdevcfg(filename, partial);
-	}
-	else{
-		//Xilinx xdevcfg driver NOT found. Use FPGA Manager (newer kernel versions)
-		return reconfigure_fpga_manager(filename, partial);
-	}
-}
-
 /* functions for sortdemo */
 
 int cmp_uint32t(const void *a, const void *b) {
@@ -256,10 +132,12 @@ int main(int argc, char **argv) {
 	}
 
 	t_reconfiguration_full = timer_get();
-	if(reconfigure("config_sortdemo.bit.bin",0) < 0){
+	struct reconos_reconfig *reconfig_full = reconos_reconfig_submit(RECONOS_RECONFIG_FULL, "config_sortdemo.bit.bin", NULL, NULL);
+	if(reconos_reconfig_wait(reconfig_full) < 0){
 		printf("Failed to load static bitfile of sortdemo\n");
 		return -1;
 	}
+	reconos_reconfig_free(reconfig_full);
 	t_reconfiguration_full = timer_get() - t_reconfiguration_full;
 
 	reconos_init();
@@ -338,6 +216,8 @@ int main(int argc, char **argv) {
 
 	/* reconfiguration */
 
+	struct reconos_reconfig **reconfigs = (struct reconos_reconfig **) malloc(num_hwts * sizeof(struct reconos_reconfig *));
+
 	for(i = 0; i < num_hwts; i++){
 		/*construct name of bitfile*/
 		
@@ -347,20 +227,17 @@ int main(int argc, char **argv) {
 		strcat(filename,id);
 		strcat(filename,"_partial.bit.bin");
 
-		/*suspend each thread and reconfigure */
+		/*suspend each thread and queue its reconfiguration, the other slots keep running */
 		log("Suspending HWT %d\n",i);
 		t_suspend[i] = timer_get();
 		reconos_thread_suspend_block(reconos_hwts[i]);
 		t_suspend[i] = timer_get() - t_suspend[i];
 
 		t_reconfiguration[i] = timer_get();
-		if(reconfigure(filename,1) < 0){
-			return -1;
-		}
-		t_reconfiguration[i] = timer_get() - t_reconfiguration[i];
+		reconfigs[i] = reconos_reconfig_submit(i, filename, NULL, NULL);
 	}
 
-	/* terminate sortdemo software threads */
+	/* terminate sortdemo software threads while the slots are reconfigured */
 	for(i = 0; i < num_swts;i++){
 		mbox_put(resources_address,UINT_MAX);
 	}
@@ -370,6 +247,16 @@ int main(int argc, char **argv) {
 		log("SWT %d was terminated\n",i);
 	}
 
+	/* wait for the reconfiguration (measured from submission until done) */
+	for(i = 0; i < num_hwts; i++){
+		if(reconos_reconfig_wait(reconfigs[i]) < 0){
+			return -1;
+		}
+		t_reconfiguration[i] = timer_get() - t_reconfiguration[i];
+		reconos_reconfig_free(reconfigs[i]);
+	}
+	free(reconfigs);
+
 	/* resume hardware threads */
 	for(i = 0; i < num_hwts; i++){
 		log("Resume HWT %d\n",i);
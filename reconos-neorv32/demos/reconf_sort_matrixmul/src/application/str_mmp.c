@@ -112,8 +112,8 @@ void str_matrix_split(int *i_matrix_a, int *i_matrix_b, MATRIXES **std_mmp_matri
 	add_matrixes(o_matrixes[6][1], b21, b22, o_matrix_size);
 
 	//printf("str_matrix_split: freeing pointers...\n");
-	free(a11); free(a12); free(a21); free(a22);
-	free(b11); free(b12); free(b21); free(b22);
+	xfree_aligned(a11); xfree_aligned(a12); xfree_aligned(a21); xfree_aligned(a22);
+	xfree_aligned(b11); xfree_aligned(b12); xfree_aligned(b21); xfree_aligned(b22);
 
 	if (o_matrix_size <= STD_MMP_MATRIX_SIZE) {
 		//printf("str_matrix_split appending to list...\n");
@@ -175,8 +175,8 @@ int str_matrix_combine_step(MATRIXES **str_mmp_matrixes, MATRIXES **std_mmp_matr
 
 	append_list_single(str_mmp_matrixes, o_matrix);
 
-	free(temp1); free(temp2);
-	free(c11); free(c12); free(c21); free(c22);
+	xfree_aligned(temp1); xfree_aligned(temp2);
+	xfree_aligned(c11); xfree_aligned(c12); xfree_aligned(c21); xfree_aligned(c22);
 
 	return o_matrix_size;
 }
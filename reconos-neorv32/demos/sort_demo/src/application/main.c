@@ -18,18 +18,22 @@ void print_help() {
 	       "Sorts a buffer full of data with a variable number of sw and hw threads.\n"
 	       "\n"
 	       "Usage:\n"
-	       "    sort_demo <num_hw_threads> <num_sw_threads> <num_of_blocks>\n"
+	       "    sort_demo <num_hw_threads> <num_sw_threads> <num_of_blocks> [bench]\n"
 	       "\n"
 	       "    <num_hw_threads> - Number of hardware threads to create. The maximum number is\n"
 	       "                       limited by the hardware design.\n"
 	       "    <num_sw_threads> - Number of software threads to create.\n"
 	       "    <num_of_blocks>  - Number of blocks to create and sort. This must be a multiple of 2.\n"
+	       "    bench            - Benchmarks the sorting kernel on random data at a fixed\n"
+	       "                       clock to compare the kernels selected in build.cfg.\n"
 	       "\n"
 	);
 }
 
 int cmp_uint32t(const void *a, const void *b) {
-	return *(uint32_t *)a - *(uint32_t *)b;
+	uint32_t x = *(uint32_t *)a, y = *(uint32_t *)b;
+
+	return (x > y) - (x < y);
 }
 
 void _merge(uint32_t *data, uint32_t *tmp,
@@ -77,11 +81,11 @@ int main(int argc, char **argv) {
 	int num_hwts, num_swts, num_blocks;
 	uint32_t *data, *copy;
 	int data_count;
-	int clk;
+	int clk, bench;
 
 	unsigned int t_start, t_gen, t_sort, t_merge, t_check;
 
-	if (argc != 4) {
+	if (argc != 4 && !(argc == 5 && strcmp(argv[4], "bench") == 0)) {
 		print_help();
 		return 0;
 	}
@@ -89,6 +93,7 @@ int main(int argc, char **argv) {
 	num_hwts = atoi(argv[1]);
 	num_swts = atoi(argv[2]);
 	num_blocks = atoi(argv[3]);
+	bench = argc == 5;
 
 	if (num_blocks % 2 != 0)
 	{
@@ -121,8 +126,9 @@ int main(int argc, char **argv) {
 	data_count = num_blocks * BLOCK_SIZE;
 	data = (uint32_t *)malloc(data_count * sizeof(uint32_t));
 	copy = (uint32_t *)malloc(data_count * sizeof(uint32_t));
+	srand(1);
 	for (i = 0; i < data_count; i++) {
-		data[i] = data_count - i - 1;
+		data[i] = bench ? (uint32_t)rand() : data_count - i - 1;
 	}
 	memcpy(copy, data, data_count * sizeof(uint32_t));
 	t_gen = timer_get() - t_start;
@@ -141,8 +147,10 @@ int main(int argc, char **argv) {
 		mbox_get(resources_acknowledge);
 		log(".");
 	}
-	clk = reconos_clock_threads_set(20000);
-	log("[@%dMHz]", clk / 1000);
+	if (!bench) {
+		clk = reconos_clock_threads_set(20000);
+		log("[@%dMHz]", clk / 1000);
+	}
 	for (i = 0; i < num_blocks / 2; i++) {
 		mbox_get(resources_acknowledge);
 		log(".");
@@ -188,6 +196,15 @@ int main(int argc, char **argv) {
 	    timer_toms(t_gen), timer_toms(t_sort), timer_toms(t_merge),
 	    timer_toms(t_check), timer_toms(t_sort + t_merge));
 
+	if (bench) {
+		log("Benchmark (%d hw-threads @%dMHz, %d sw-threads):\n"
+		    "  Sort time per block: %f ms\n"
+		    "  Sort throughput    : %f Mwords/s\n",
+		    num_hwts, clk / 1000, num_swts,
+		    timer_toms(t_sort) / num_blocks,
+		    data_count / timer_toms(t_sort) / 1000);
+	}
+
 	timer_cleanup();
 	reconos_app_cleanup();
 	reconos_cleanup();
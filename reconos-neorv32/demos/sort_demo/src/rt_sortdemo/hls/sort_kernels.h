@@ -0,0 +1,226 @@
+/*
+ * Library of sorting kernels for hls threads. All kernels sort a block of
+ * SORT_SIZE words in the local ram in ascending order and share the same
+ * signature, so that they can be exchanged by a define:
+ *
+ *   ram - block to sort
+ *   tmp - scratch ram of the same size (unused by the in-place kernels)
+ *
+ * Available kernels:
+ *
+ *   sort_bubble  - bubble sort, O(n^2) single compare per cycle
+ *   sort_net     - odd-even transposition network applied sequentially,
+ *                  O(n^2) single compare per cycle
+ *   sort_bitonic - sorts runs of SORT_NET_WIDTH words by a fully unrolled
+ *                  bitonic network and merges them, O(n log(n / width))
+ *   sort_merge   - bottom-up merge sort, one word per cycle, O(n log n)
+ *   sort_radix   - lsd radix sort on digits of SORT_RADIX_BITS bits,
+ *                  O(n * 32 / SORT_RADIX_BITS)
+ *
+ * SORT_SIZE and SORT_NET_WIDTH must be powers of two.
+ */
+
+#ifndef SORT_KERNELS_H
+#define SORT_KERNELS_H
+
+#include "stdint.h"
+
+#ifndef SORT_SIZE
+#define SORT_SIZE 2048
+#endif
+
+#ifndef SORT_NET_WIDTH
+#define SORT_NET_WIDTH 16
+#endif
+
+#ifndef SORT_RADIX_BITS
+#define SORT_RADIX_BITS 8
+#endif
+
+#define SORT_RADIX_BUCKETS (1 << SORT_RADIX_BITS)
+
+void sort_bubble(uint32_t ram[SORT_SIZE], uint32_t tmp[SORT_SIZE]) {
+	unsigned int i, j;
+	uint32_t t;
+	for (i = 0; i < SORT_SIZE; i++) {
+		for (j = 0; j < SORT_SIZE - 1; j++) {
+			if (ram[j] > ram[j + 1]) {
+				t = ram[j];
+				ram[j] = ram[j + 1];
+				ram[j + 1] = t;
+			}
+		}
+	}
+}
+
+void sort_net(uint32_t ram[SORT_SIZE], uint32_t tmp[SORT_SIZE]) {
+	unsigned int i, k, stage;
+	uint32_t t;
+
+	for(stage = 1; stage <= SORT_SIZE; stage++){
+		k = (stage % 2 == 1) ? 0 : 1;
+		for(i = k; i < SORT_SIZE - 1; i += 2){
+			if (ram[i] > ram[i + 1]) {
+				t = ram[i];
+				ram[i] = ram[i + 1];
+				ram[i + 1] = t;
+			}
+		}
+	}
+}
+
+/*
+ * Copies a block from one ram to another.
+ */
+void sort_copy(uint32_t src[SORT_SIZE], uint32_t dst[SORT_SIZE]) {
+	for (unsigned int i = 0; i < SORT_SIZE; i++) {
+#pragma HLS pipeline II=1
+		dst[i] = src[i];
+	}
+}
+
+/*
+ * Merges pairs of sorted runs of length run from src into sorted runs
+ * of twice the length in dst, producing one word per cycle.
+ */
+void sort_merge_pass(uint32_t src[SORT_SIZE], uint32_t dst[SORT_SIZE],
+                     unsigned int run) {
+	for (unsigned int b = 0; b < SORT_SIZE; b += 2 * run) {
+		unsigned int l = b, le = b + run;
+		unsigned int r = b + run, re = b + 2 * run;
+
+		for (unsigned int i = b; i < re; i++) {
+#pragma HLS pipeline II=1
+			uint32_t lv = src[l < le ? l : le - 1];
+			uint32_t rv = src[r < re ? r : re - 1];
+
+			if (r == re || (l < le && lv <= rv)) {
+				dst[i] = lv;
+				l++;
+			} else {
+				dst[i] = rv;
+				r++;
+			}
+		}
+	}
+}
+
+/*
+ * Merges the sorted runs of length run in ram until the whole block is
+ * sorted, alternating between ram and tmp.
+ */
+void sort_merge_runs(uint32_t ram[SORT_SIZE], uint32_t tmp[SORT_SIZE],
+                     unsigned int run) {
+	bool in_tmp = false;
+
+	for (; run < SORT_SIZE; run *= 2) {
+		if (in_tmp) {
+			sort_merge_pass(tmp, ram, run);
+		} else {
+			sort_merge_pass(ram, tmp, run);
+		}
+		in_tmp = !in_tmp;
+	}
+
+	if (in_tmp) {
+		sort_copy(tmp, ram);
+	}
+}
+
+void sort_merge(uint32_t ram[SORT_SIZE], uint32_t tmp[SORT_SIZE]) {
+	sort_merge_runs(ram, tmp, 1);
+}
+
+/*
+ * Sorts SORT_NET_WIDTH words held in registers by a bitonic network of
+ * log2(width) * (log2(width) + 1) / 2 stages of compare-exchanges.
+ */
+void sort_bitonic_net(uint32_t v[SORT_NET_WIDTH]) {
+#pragma HLS inline
+	for (unsigned int k = 2; k <= SORT_NET_WIDTH; k *= 2) {
+#pragma HLS unroll
+		for (unsigned int j = k / 2; j > 0; j /= 2) {
+#pragma HLS unroll
+			for (unsigned int i = 0; i < SORT_NET_WIDTH; i++) {
+#pragma HLS unroll
+				unsigned int p = i ^ j;
+				if (p > i && (v[i] > v[p]) == ((i & k) == 0)) {
+					uint32_t t = v[i];
+					v[i] = v[p];
+					v[p] = t;
+				}
+			}
+		}
+	}
+}
+
+void sort_bitonic(uint32_t ram[SORT_SIZE], uint32_t tmp[SORT_SIZE]) {
+	for (unsigned int c = 0; c < SORT_SIZE; c += SORT_NET_WIDTH) {
+#pragma HLS pipeline
+		uint32_t v[SORT_NET_WIDTH];
+#pragma HLS array_partition variable=v complete
+
+		for (unsigned int i = 0; i < SORT_NET_WIDTH; i++) {
+			v[i] = ram[c + i];
+		}
+
+		sort_bitonic_net(v);
+
+		for (unsigned int i = 0; i < SORT_NET_WIDTH; i++) {
+			ram[c + i] = v[i];
+		}
+	}
+
+	sort_merge_runs(ram, tmp, SORT_NET_WIDTH);
+}
+
+/*
+ * Distributes the words of src into dst stably by the digit at shift.
+ */
+void sort_radix_pass(uint32_t src[SORT_SIZE], uint32_t dst[SORT_SIZE],
+                     unsigned int shift) {
+	uint32_t hist[SORT_RADIX_BUCKETS];
+	uint32_t sum = 0;
+
+	for (unsigned int d = 0; d < SORT_RADIX_BUCKETS; d++) {
+#pragma HLS pipeline II=1
+		hist[d] = 0;
+	}
+
+	for (unsigned int i = 0; i < SORT_SIZE; i++) {
+#pragma HLS pipeline
+		hist[(src[i] >> shift) & (SORT_RADIX_BUCKETS - 1)]++;
+	}
+
+	for (unsigned int d = 0; d < SORT_RADIX_BUCKETS; d++) {
+#pragma HLS pipeline II=1
+		uint32_t n = hist[d];
+		hist[d] = sum;
+		sum += n;
+	}
+
+	for (unsigned int i = 0; i < SORT_SIZE; i++) {
+#pragma HLS pipeline
+		uint32_t v = src[i];
+		dst[hist[(v >> shift) & (SORT_RADIX_BUCKETS - 1)]++] = v;
+	}
+}
+
+void sort_radix(uint32_t ram[SORT_SIZE], uint32_t tmp[SORT_SIZE]) {
+	bool in_tmp = false;
+
+	for (unsigned int shift = 0; shift < 32; shift += SORT_RADIX_BITS) {
+		if (in_tmp) {
+			sort_radix_pass(tmp, ram, shift);
+		} else {
+			sort_radix_pass(ram, tmp, shift);
+		}
+		in_tmp = !in_tmp;
+	}
+
+	if (in_tmp) {
+		sort_copy(tmp, ram);
+	}
+}
+
+#endif /* SORT_KERNELS_H */
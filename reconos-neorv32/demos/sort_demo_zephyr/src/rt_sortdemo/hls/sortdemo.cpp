@@ -1,3 +1,6 @@
+// request whole pages of the block to stream it at full bandwidth
+#define MEMIF_CHUNK_WORDS 1024
+
 #include "reconos_calls.h"
 #include "reconos_thread.h"
 
@@ -5,38 +8,18 @@
 
 #define BLOCK_SIZE 2048
 
-void sort_bubble(uint32_t ram[BLOCK_SIZE]) {
-	unsigned int i, j;
-	uint32_t tmp;
-	for (i = 0; i < BLOCK_SIZE; i++) {
-		for (j = 0; j < BLOCK_SIZE - 1; j++) {
-			if (ram[j] > ram[j + 1]) {
-				tmp = ram[j];
-				ram[j] = ram[j + 1];
-				ram[j + 1] = tmp;
-			}
-		}
-	}
-}
+// the sorting kernel is selected in build.cfg by an option of the hardware
+// source, e.g. "HwSource = hls,SORT_KERNEL=sort_merge"
+#ifndef SORT_KERNEL
+#define SORT_KERNEL sort_bubble
+#endif
 
-void sort_net(uint32_t ram[BLOCK_SIZE]) {
-	unsigned int i, k, stage;
-	uint32_t tmp;
-
-	for(stage = 1; stage <= BLOCK_SIZE; stage++){
-		k = (stage % 2 == 1) ? 0 : 1;
-		for(i = k; i < BLOCK_SIZE - 1; i += 2){
-			if (ram[i] > ram[i + 1]) {
-				tmp = ram[i];
-				ram[i] = ram[i + 1];
-				ram[i + 1] = tmp;
-			}
-		}
-	}
-}
+#define SORT_SIZE BLOCK_SIZE
+#include "sort_kernels.h"
 
 THREAD_ENTRY() {
 	RAM(uint32_t, BLOCK_SIZE, ram);
+	RAM(uint32_t, BLOCK_SIZE, tmp);
 
 	THREAD_INIT();
 
@@ -44,7 +27,7 @@ THREAD_ENTRY() {
 		uint32_t addr = MBOX_GET(resources_address);
 		MEM_READ(addr, ram, BLOCK_SIZE * 4);
 
-		sort_bubble(ram);
+		SORT_KERNEL(ram, tmp);
 
 		MEM_WRITE(ram, addr, BLOCK_SIZE * 4);
 		MBOX_PUT(resources_acknowledge, addr);
@@ -0,0 +1,179 @@
+--
+-- bitonic_sorter.vhd
+-- Bitonic sort module. Sorts the contents of an attached single-port
+-- block RAM by applying the compare-exchanges of a bitonic sorting network
+-- sequentially. Needs log2(G_LEN) * (log2(G_LEN) + 1) / 2 passes over
+-- G_LEN / 2 pairs instead of up to G_LEN passes of the bubble sorter, and
+-- has the same interface to be used as drop-in replacement.
+--
+-- G_LEN must be a power of two.
+--
+-- This file is part of the ReconOS project <http://www.reconos.de>.
+-- University of Paderborn, Computer Engineering Group.
+--
+
+library IEEE;
+use IEEE.STD_LOGIC_1164.all;
+use IEEE.NUMERIC_STD.all;
+
+entity bitonic_sorter is
+
+  generic (
+    G_LEN    : integer := 2048;         -- number of words to sort
+    G_AWIDTH : integer := 11;           -- in bits
+    G_DWIDTH : integer := 32            -- in bits
+    );
+
+  port (
+    clk   : in std_logic;
+    reset : in std_logic;
+
+    -- local ram interface
+    o_RAMAddr : out std_logic_vector(0 to G_AWIDTH-1);
+    o_RAMData : out std_logic_vector(0 to G_DWIDTH-1);
+    i_RAMData : in  std_logic_vector(0 to G_DWIDTH-1);
+    o_RAMWE   : out std_logic;
+    start     : in  std_logic;
+    done      : out std_logic
+    );
+end bitonic_sorter;
+
+architecture Behavioral of bitonic_sorter is
+
+  type state_t is (STATE_IDLE, STATE_ADDR_A, STATE_ADDR_B, STATE_LOAD_A, STATE_LOAD_B, STATE_COMPARE, STATE_WRITE_B, STATE_NEXT);
+
+  signal state : state_t := STATE_IDLE;
+
+  -- the network consists of merge stages of size k, each split into steps
+  -- comparing words at distance j, which are one-hot encoded, and the
+  -- pair n of a step compares the words at the positions i and p
+  signal k    : unsigned(G_AWIDTH downto 0);
+  signal j    : unsigned(G_AWIDTH-1 downto 0);
+  signal n    : unsigned(G_AWIDTH-1 downto 0);
+  signal i    : unsigned(G_AWIDTH-1 downto 0);
+  signal p    : unsigned(G_AWIDTH-1 downto 0);
+  signal ptr  : unsigned(G_AWIDTH-1 downto 0);
+  signal a    : std_logic_vector(0 to G_DWIDTH-1);
+  signal b    : std_logic_vector(0 to G_DWIDTH-1);
+  signal up   : boolean;
+  signal swap : boolean;
+
+begin
+
+  -- set RAM address
+  o_RAMAddr <= std_logic_vector(ptr);
+
+  -- position of the pair, inserting a zero at the bit of the distance
+  i <= shift_left(n and not (j - 1), 1) or (n and (j - 1));
+  p <= i or j;
+
+  -- concurrent signal assignments
+  up   <= (resize(i, G_AWIDTH+1) and k) = 0;           -- sort ascending?
+  swap <= (unsigned(a) > unsigned(b)) = up;            -- should a and b be swapped?
+
+  -- sorting state machine
+  sort_proc : process(clk)
+  begin
+
+  if rising_edge(clk) then
+    if reset = '1' then
+      k         <= to_unsigned(2, G_AWIDTH+1);
+      j         <= to_unsigned(1, G_AWIDTH);
+      n         <= (others => '0');
+      ptr       <= (others => '0');
+      o_RAMData <= (others => '0');
+      o_RAMWE   <= '0';
+      done      <= '0';
+      a         <= (others => '0');
+      b         <= (others => '0');
+      state     <= STATE_IDLE;
+    else
+
+      o_RAMWE   <= '0';
+      o_RAMData <= (others => '0');
+
+      case state is
+
+        when STATE_IDLE =>
+          done <= '0';
+          k    <= to_unsigned(2, G_AWIDTH+1);
+          j    <= to_unsigned(1, G_AWIDTH);
+          n    <= (others => '0');
+          -- start sorting on 'start' signal
+          if start = '1' then
+            if G_LEN > 1 then
+              state <= STATE_ADDR_A;
+            else
+              done  <= '1';
+            end if;
+          end if;
+
+          -- address A
+        when STATE_ADDR_A =>
+          ptr   <= i;
+          state <= STATE_ADDR_B;
+
+          -- address B, wait for A to appear on RAM outputs
+        when STATE_ADDR_B =>
+          ptr   <= p;
+          state <= STATE_LOAD_A;
+
+          -- read A value from RAM
+        when STATE_LOAD_A =>
+          a     <= i_RAMData;
+          state <= STATE_LOAD_B;
+
+          -- read B value from RAM
+        when STATE_LOAD_B =>
+          b     <= i_RAMData;
+          state <= STATE_COMPARE;
+
+          -- compare A and B and write them back swapped if necessary
+        when STATE_COMPARE =>
+          if swap then
+            ptr       <= i;
+            o_RAMData <= b;
+            o_RAMWE   <= '1';
+            state     <= STATE_WRITE_B;
+          else
+            state     <= STATE_NEXT;
+          end if;
+
+        when STATE_WRITE_B =>
+          ptr       <= p;
+          o_RAMData <= a;
+          o_RAMWE   <= '1';
+          state     <= STATE_NEXT;
+
+          -- advance to the next pair, step or stage
+        when STATE_NEXT =>
+          state <= STATE_ADDR_A;
+
+          if n = G_LEN/2 - 1 then
+            n <= (others => '0');
+
+            if j = 1 then
+              if k = G_LEN then
+                done  <= '1';
+                state <= STATE_IDLE;
+              else
+                k <= shift_left(k, 1);
+                j <= resize(k, G_AWIDTH);
+              end if;
+            else
+              j <= shift_right(j, 1);
+            end if;
+          else
+            n <= n + 1;
+          end if;
+
+        when others =>
+          state <= STATE_IDLE;
+
+      end case;
+
+    end if;
+  end if;
+  end process;
+
+end Behavioral;
@@ -89,6 +89,30 @@ architecture implementation of rt_sortdemo is
 			done      : out std_logic
 		);
   	end component;
+
+	component bitonic_sorter is
+		generic (
+			G_LEN    : integer := 512;  -- number of words to sort
+			G_AWIDTH : integer := 9;  -- in bits
+			G_DWIDTH : integer := 32  -- in bits
+		);
+
+		port (
+			clk   : in std_logic;
+			reset : in std_logic;
+			-- local ram interface
+			o_RAMAddr : out std_logic_vector(0 to G_AWIDTH-1);
+			o_RAMData : out std_logic_vector(0 to G_DWIDTH-1);
+			i_RAMData : in  std_logic_vector(0 to G_DWIDTH-1);
+			o_RAMWE   : out std_logic;
+			start     : in  std_logic;
+			done      : out std_logic
+		);
+	end component;
+
+	-- Selects the sorting module, the bitonic sorter requires the size of the
+	-- local RAM to be a power of two.
+	constant C_SORTER_BITONIC : boolean := true;
 	
 	-- The sorting application reads 'C_LOCAL_RAM_SIZE' 32-bit words into the local RAM,
 	-- from a given address (send in a message box), sorts them and writes them back into main memory.
@@ -171,6 +195,7 @@ begin
 	
 
 	-- instantiate bubble_sorter module
+	bubble_gen : if not C_SORTER_BITONIC generate
 	sorter_i : bubble_sorter
 		generic map (
 			G_LEN     => C_LOCAL_RAM_SIZE,
@@ -187,6 +212,27 @@ begin
 			start     => sort_start,
 			done      => sort_done
 	);
+	end generate;
+
+	-- instantiate bitonic_sorter module
+	bitonic_gen : if C_SORTER_BITONIC generate
+	sorter_i : bitonic_sorter
+		generic map (
+			G_LEN     => C_LOCAL_RAM_SIZE,
+			G_AWIDTH  => C_LOCAL_RAM_ADDRESS_WIDTH,
+			G_DWIDTH  => 32
+		)
+		port map (
+			clk       => HWT_Clk,
+			reset     => HWT_Rst,
+			o_RAMAddr => o_RAMAddr_sorter,
+			o_RAMData => o_RAMData_sorter,
+			i_RAMData => i_RAMData_sorter,
+			o_RAMWE   => o_RAMWE_sorter,
+			start     => sort_start,
+			done      => sort_done
+	);
+	end generate;
 
 	-- ReconOS initilization
 	osif_setup (
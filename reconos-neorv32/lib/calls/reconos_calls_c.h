@@ -168,6 +168,19 @@
  */
 #define MEM_WRITE(src, dst, len)
 
+/*
+ * Reads a single word from the main memory.
+ *
+ *   addr - address to read from
+ */
+#define CACHED_READ(addr)\
+	(*(volatile uint32_t *)(addr))
+
+/*
+ * Invalidates the cache of the slot, nothing to do in software.
+ */
+#define CACHE_INVALIDATE()
+
 /*
  * Terminates the current ReconOS thread.
  */
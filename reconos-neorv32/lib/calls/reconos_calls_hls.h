@@ -29,12 +29,92 @@
 /*
  * General constants
  *
- *   MEMIF_CHUNK_WORDS - size of one memory request in words
- *                       (a request might be split up to meet this)
+ *   MEMIF_DATA_WIDTH  - width of the memif in bit (32, 64 or 128), set
+ *                       by the build from MemifWidth in build.cfg. Wider
+ *                       memifs transfer several words per cycle, hence
+ *                       all addresses and lengths of memory transfers
+ *                       must be aligned to MEMIF_DATA_BYTES.
+ *   MEMIF_DATA_WORDS  - number of 32 bit words per memif word
+ *   MEMIF_DATA_BYTES  - number of bytes per memif word
+ *
+ *   MEMIF_CHUNK_WORDS - maximum size of one memory request in words
+ *                       (a request might be split up to meet this).
+ *                       Defaults to 64 and may be raised by defining it
+ *                       before including this header. Larger requests
+ *                       reduce the overhead of the arbiter but hold the
+ *                       memif longer against other threads.
+ *
+ *   MEMIF_OUTSTANDING - number of read requests issued before their
+ *                       data is consumed, so that the memif continues
+ *                       with the next request right after the previous
+ *                       one. Every request occupies two words of the
+ *                       hwt2mem fifo, which must hold all of them.
+ *
+ *   MEMIF_PAGE_BYTES    - size of a small page
+ *   MEMIF_SECTION_BYTES - size of a section mapping
+ *
+ *   MEMIF_SPLIT_BYTES - requests never cross a border aligned to this
+ *                       size, since the mmu translates only the start
+ *                       address of a request. Defaults to the chunk size
+ *                       but at most a page and may be raised by defining
+ *                       it before including this header, up to the size
+ *                       of the mapping backing all buffers of the thread
+ *                       (e.g. MEMIF_SECTION_BYTES for section mapped
+ *                       memory).
+ *
+ *   MEMIF_LENGTH_MAX  - maximum length of a request supported by the
+ *                       length field of the memif command
  */
+#ifndef MEMIF_DATA_WIDTH
+#define MEMIF_DATA_WIDTH 32
+#endif
+
+#if MEMIF_DATA_WIDTH == 32
+#define MEMIF_DATA_WORDS 1
+#elif MEMIF_DATA_WIDTH == 64
+#define MEMIF_DATA_WORDS 2
+#elif MEMIF_DATA_WIDTH == 128
+#define MEMIF_DATA_WORDS 4
+#else
+#error "MEMIF_DATA_WIDTH must be 32, 64 or 128"
+#endif
+#define MEMIF_DATA_BYTES (MEMIF_DATA_WORDS * 4)
+
+#ifndef MEMIF_CHUNK_WORDS
 #define MEMIF_CHUNK_WORDS 64
+#endif
 #define MEMIF_CHUNK_BYTES (MEMIF_CHUNK_WORDS * 4)
-#define MEMIF_CHUNK_MASK  0x000000FF
+#define MEMIF_CHUNK_MASK  (MEMIF_CHUNK_BYTES - 1)
+
+#ifndef MEMIF_OUTSTANDING
+#define MEMIF_OUTSTANDING 2
+#endif
+
+#define MEMIF_PAGE_BYTES    0x00001000
+#define MEMIF_SECTION_BYTES 0x00100000
+
+#ifndef MEMIF_SPLIT_BYTES
+#if MEMIF_CHUNK_BYTES < MEMIF_PAGE_BYTES
+#define MEMIF_SPLIT_BYTES MEMIF_CHUNK_BYTES
+#else
+#define MEMIF_SPLIT_BYTES MEMIF_PAGE_BYTES
+#endif
+#endif
+#define MEMIF_SPLIT_MASK  (MEMIF_SPLIT_BYTES - 1)
+
+#define MEMIF_LENGTH_MAX  0x00FFFFFC
+
+#if MEMIF_CHUNK_BYTES > MEMIF_LENGTH_MAX
+#error "MEMIF_CHUNK_WORDS exceeds the length field of the memif"
+#endif
+
+#if MEMIF_CHUNK_BYTES % MEMIF_DATA_BYTES != 0
+#error "MEMIF_CHUNK_WORDS must be a multiple of the memif width"
+#endif
+
+#if MEMIF_OUTSTANDING < 1
+#error "MEMIF_OUTSTANDING must be at least one"
+#endif
 
 /*
  * Definition of the osif commands
@@ -74,6 +154,29 @@
  */
 #define MEMIF_CMD_READ 0x00000000
 #define MEMIF_CMD_WRITE 0xF0000000
+#define MEMIF_CMD_READ_SG 0x01000000
+#define MEMIF_CMD_WRITE_SG 0xF1000000
+#define MEMIF_CMD_READ_CACHED 0x02000000
+#define MEMIF_CMD_CACHE_INV 0x03000000
+
+/*
+ * Size of a scatter-gather descriptor in bytes
+ *
+ *   @see struct reconos_sg_desc
+ */
+#define MEMIF_SG_DESC_BYTES 16
+
+/*
+ * Definition of a memif word. Command and address words occupy its lower
+ * 32 bits, data words hold MEMIF_DATA_WORDS words with the lowest address
+ * in the lower bits.
+ */
+#if MEMIF_DATA_WORDS == 1
+typedef uint32_t memif_word_t;
+#else
+#include "ap_int.h"
+typedef ap_uint<MEMIF_DATA_WIDTH> memif_word_t;
+#endif
 
 
 /* == Internal functions =============================================== */
@@ -107,18 +210,334 @@ inline uint32_t stream_read(hls::stream<uint32_t> &stream) {
 	return data;
 }
 
+#if MEMIF_DATA_WORDS > 1
+/*
+ * @see stream_write, writes a memif word
+ */
+inline void stream_write(hls::stream<memif_word_t> &stream, memif_word_t data) {
+#pragma HLS inline
+	while (!stream.write_nb(data)){}
+}
+#endif
+
+/*
+ * Extracts a single 32 bit word of a memif word.
+ *
+ *   data - memif word
+ *   lane - index of the word
+ *
+ *   @returns extracted word
+ */
+inline uint32_t memif_word_get(memif_word_t data, uint32_t lane) {
+#pragma HLS inline
+#if MEMIF_DATA_WORDS == 1
+	return data;
+#else
+	return data.range(32 * lane + 31, 32 * lane);
+#endif
+}
+
+/*
+ * Inserts a single 32 bit word into a memif word.
+ *
+ *   data - reference to memif word
+ *   lane - index of the word
+ *   word - word to insert
+ */
+inline void memif_word_set(memif_word_t &data, uint32_t lane, uint32_t word) {
+#pragma HLS inline
+#if MEMIF_DATA_WORDS == 1
+	data = word;
+#else
+	data.range(32 * lane + 31, 32 * lane) = word;
+#endif
+}
+
+/*
+ * Calculates the length of the next memory request, which is at most
+ * MEMIF_CHUNK_BYTES and does not cross a border of MEMIF_SPLIT_BYTES.
+ *
+ *   addr - start address of the request
+ *   rem  - remaining number of bytes to transmit
+ *
+ *   @returns length of the request in bytes
+ */
+inline uint32_t memif_request_len(uint32_t addr, uint32_t rem) {
+#pragma HLS inline
+	uint32_t len = MEMIF_SPLIT_BYTES - (addr & MEMIF_SPLIT_MASK);
+	if (rem < len)
+		len = rem;
+	if (MEMIF_CHUNK_BYTES < len)
+		len = MEMIF_CHUNK_BYTES;
+	return len;
+}
+
+/*
+ * Reads a single 32 bit word through the cache of the slot. The cache
+ * returns the memif word including the address.
+ *
+ *   hwt2mem - reference to the memif stream to the memory
+ *   mem2hwt - reference to the memif stream from the memory
+ *   addr    - address to read from (aligned to 4 bytes)
+ *
+ *   @returns read word
+ */
+inline uint32_t memif_cached_read(hls::stream<memif_word_t> &hwt2mem,
+                                  hls::stream<memif_word_t> &mem2hwt,
+                                  uint32_t addr) {
+#pragma HLS inline
+	stream_write(hwt2mem, MEMIF_CMD_READ_CACHED | MEMIF_DATA_BYTES);
+	stream_write(hwt2mem, addr & ~(uint32_t)(MEMIF_DATA_BYTES - 1));
+	return memif_word_get(mem2hwt.read(), (addr / 4) % MEMIF_DATA_WORDS);
+}
+
+/*
+ * Expands to a pragma composed of macro arguments, since _Pragma only
+ * accepts a single string literal. Macros in the content are expanded.
+ *
+ *   x - content of the pragma
+ */
+#define HLS_PRAGMA(x) HLS_PRAGMA_STR(x)
+#define HLS_PRAGMA_STR(x) _Pragma(#x)
+
+/*
+ * State of a split-phase memory transfer
+ *
+ *   addr - address of the next request to issue (writes)
+ *   rem  - remaining number of bytes to transfer
+ *   len  - remaining number of bytes of the current request (writes)
+ *   hdr  - number of header words of the current request still to
+ *          send (writes)
+ *   i    - index of the next word in the local ram
+ */
+struct memif_transfer {
+	uint32_t addr;
+	uint32_t rem;
+	uint32_t len;
+	uint32_t hdr;
+	uint32_t i;
+};
+
+/*
+ * Starts a split-phase read by issuing all of its requests at once. Hence,
+ * the command words (two per request) must fit into the hwt2mem fifo.
+ *
+ *   hwt2mem - reference to the memif stream to the memory
+ *   t       - state of the transfer
+ *   src     - start address to read from the main memory
+ *   len     - number of bytes to transmit
+ */
+inline void memif_read_start(hls::stream<memif_word_t> &hwt2mem,
+                             memif_transfer &t, uint32_t src, uint32_t len) {
+#pragma HLS inline
+	uint32_t addr = src, rem = len, req;
+
+	t.rem = len;
+	t.i = 0;
+
+	while (rem > 0) {
+		req = memif_request_len(addr, rem);
+		stream_write(hwt2mem, MEMIF_CMD_READ | req);
+		stream_write(hwt2mem, addr);
+		addr += req;
+		rem -= req;
+	}
+}
+
+/*
+ * Receives a single memif word of a split-phase read if available.
+ *
+ *   mem2hwt - reference to the memif stream from the memory
+ *   t       - state of the transfer
+ *   dst     - array to write data into
+ */
+template<typename T>
+inline void memif_read_poll(hls::stream<memif_word_t> &mem2hwt,
+                            memif_transfer &t, T *dst) {
+#pragma HLS inline
+	memif_word_t data;
+
+	if (t.rem > 0 && mem2hwt.read_nb(data)) {
+		for (uint32_t l = 0; l < MEMIF_DATA_WORDS; l++) {
+#pragma HLS unroll
+			dst[t.i + l] = memif_word_get(data, l);
+		}
+		t.i += MEMIF_DATA_WORDS;
+		t.rem -= MEMIF_DATA_BYTES;
+	}
+}
+
+/*
+ * Receives the remaining words of a split-phase read.
+ *
+ *   mem2hwt - reference to the memif stream from the memory
+ *   t       - state of the transfer
+ *   dst     - array to write data into
+ */
+template<typename T>
+inline void memif_read_wait(hls::stream<memif_word_t> &mem2hwt,
+                            memif_transfer &t, T *dst) {
+#pragma HLS inline
+	memif_word_t data;
+
+	for (; t.rem > 0; t.rem -= MEMIF_DATA_BYTES) {
+#pragma HLS pipeline II=1
+		data = mem2hwt.read();
+		for (uint32_t l = 0; l < MEMIF_DATA_WORDS; l++) {
+#pragma HLS unroll
+			dst[t.i + l] = memif_word_get(data, l);
+		}
+		t.i += MEMIF_DATA_WORDS;
+	}
+}
+
+/*
+ * Starts a split-phase write. No words are sent until polling or waiting.
+ *
+ *   t   - state of the transfer
+ *   dst - start address to write to the main memory
+ *   len - number of bytes to transmit
+ */
+inline void memif_write_start(memif_transfer &t, uint32_t dst, uint32_t len) {
+#pragma HLS inline
+	t.addr = dst;
+	t.rem = len;
+	t.len = 0;
+	t.hdr = 2;
+	t.i = 0;
+}
+
+/*
+ * Sends a single memif word of a split-phase write if the fifo is not
+ * full, which is either a header word of the next request or a data word.
+ * The arbiter is blocked for other hwts until the last data word of the
+ * current request is sent.
+ *
+ *   hwt2mem - reference to the memif stream to the memory
+ *   t       - state of the transfer
+ *   src     - array to read data from
+ */
+template<typename T>
+inline void memif_write_poll(hls::stream<memif_word_t> &hwt2mem,
+                             memif_transfer &t, T *src) {
+#pragma HLS inline
+	memif_word_t data;
+
+	if (t.rem == 0) {
+		return;
+	}
+
+	if (t.hdr == 2) {
+		t.len = memif_request_len(t.addr, t.rem);
+		if (hwt2mem.write_nb(MEMIF_CMD_WRITE | t.len)) {
+			t.hdr = 1;
+		}
+	} else if (t.hdr == 1) {
+		if (hwt2mem.write_nb(t.addr)) {
+			t.hdr = 0;
+		}
+	} else {
+		for (uint32_t l = 0; l < MEMIF_DATA_WORDS; l++) {
+#pragma HLS unroll
+			memif_word_set(data, l, src[t.i + l]);
+		}
+		if (hwt2mem.write_nb(data)) {
+			t.i += MEMIF_DATA_WORDS;
+			t.addr += MEMIF_DATA_BYTES;
+			t.rem -= MEMIF_DATA_BYTES;
+			t.len -= MEMIF_DATA_BYTES;
+			if (t.len == 0) {
+				t.hdr = 2;
+			}
+		}
+	}
+}
+
+/*
+ * Sends the remaining words of a split-phase write.
+ *
+ *   hwt2mem - reference to the memif stream to the memory
+ *   t       - state of the transfer
+ *   src     - array to read data from
+ */
+template<typename T>
+inline void memif_write_wait(hls::stream<memif_word_t> &hwt2mem,
+                             memif_transfer &t, T *src) {
+#pragma HLS inline
+	memif_word_t data;
+
+	while (t.rem > 0) {
+		if (t.hdr == 2) {
+			t.len = memif_request_len(t.addr, t.rem);
+			stream_write(hwt2mem, MEMIF_CMD_WRITE | t.len);
+		}
+		if (t.hdr >= 1) {
+			stream_write(hwt2mem, t.addr);
+		}
+
+		for (; t.len > 0; t.len -= MEMIF_DATA_BYTES) {
+#pragma HLS pipeline II=1
+			for (uint32_t l = 0; l < MEMIF_DATA_WORDS; l++) {
+#pragma HLS unroll
+				memif_word_set(data, l, src[t.i + l]);
+			}
+			hwt2mem.write(data);
+			t.i += MEMIF_DATA_WORDS;
+			t.addr += MEMIF_DATA_BYTES;
+			t.rem -= MEMIF_DATA_BYTES;
+		}
+		t.hdr = 2;
+	}
+}
+
 /* == Call functions =================================================== */
 
 /*
  * Creates a local ram to be used for mem functions. You may only pass
- * rams created by this macro to mem functions.
+ * rams created by this macro to mem functions. On a wide memif, the ram
+ * is partitioned to access all words of a memif word in one cycle.
  *
  *   type - datatype of the ram 
  *   size - size of the ram
  *   name - name of the ram
  */
+#if MEMIF_DATA_WORDS == 1
 #define RAM(type,size,name)\
 	type name[size]
+#else
+#define RAM(type,size,name)\
+	type name[size];\
+	HLS_PRAGMA(HLS array_partition variable=name cyclic factor=MEMIF_DATA_WORDS)
+#endif
+
+/*
+ * Creates two local rams to alternate between, e.g. to fetch the next
+ * block into one ram while computing on the other. The rams are
+ * partitioned into separate memories to be accessed concurrently.
+ *
+ *   type - datatype of the rams
+ *   size - size of each ram
+ *   name - name of the rams
+ */
+#if MEMIF_DATA_WORDS == 1
+#define PINGPONG_RAM(type,size,name)\
+	type name[2][size];\
+	HLS_PRAGMA(HLS array_partition variable=name complete dim=1)
+#else
+#define PINGPONG_RAM(type,size,name)\
+	type name[2][size];\
+	HLS_PRAGMA(HLS array_partition variable=name complete dim=1)\
+	HLS_PRAGMA(HLS array_partition variable=name cyclic factor=MEMIF_DATA_WORDS dim=2)
+#endif
+
+/*
+ * Selects one of the rams created by PINGPONG_RAM.
+ *
+ *   name - name of the rams
+ *   i    - index of the block, selecting the ram by its lowest bit
+ */
+#define PINGPONG(name,i)\
+	name[(i) & 1]
 
 /*
  * Initializes the thread and reads from the osif the resume status.
@@ -262,66 +681,257 @@ inline uint32_t stream_read(hls::stream<uint32_t> &stream) {
 /*
  * Reads several words from the main memory into the local ram. Therefore,
  * divides a large request into smaller ones of length at most
- * MEMIF_CHUNK_BYTES and splits request at page borders to guarantee
- * correct address translation.
+ * MEMIF_CHUNK_BYTES and splits request at borders of MEMIF_SPLIT_BYTES
+ * to guarantee correct address translation. Up to MEMIF_OUTSTANDING
+ * requests are issued ahead of the data, which is received by a loop
+ * pipelined to one memif word per cycle.
  *
  *   src - start address to read from the main memory
  *   dst - array to write data into
- *   len - number of bytes to transmit (bytes)
+ *   len - number of bytes to transmit (multiple of MEMIF_DATA_BYTES)
  *   
  */
 #define MEM_READ(src,dst,len){\
-	uint32_t __len, __rem;\
-	uint32_t __addr = (src), __i = 0;\
-	for (__rem = (len); __rem > 0;) {\
-		uint32_t __to_border = MEMIF_CHUNK_BYTES - (__addr & MEMIF_CHUNK_MASK);\
-		uint32_t __to_rem = __rem;\
-		if (__to_rem < __to_border)\
-			__len = __to_rem;\
-		else\
-			__len = __to_border;\
-		\
+	uint32_t __len, __i = 0;\
+	uint32_t __cmd_addr = (src), __cmd_rem = (len);\
+	uint32_t __addr = (src), __rem = (len);\
+	for (uint32_t __n = 0; __n < MEMIF_OUTSTANDING && __cmd_rem > 0; __n++) {\
+		__len = memif_request_len(__cmd_addr, __cmd_rem);\
 		stream_write(memif_hwt2mem, MEMIF_CMD_READ | __len);\
-		stream_write(memif_hwt2mem, __addr);\
+		stream_write(memif_hwt2mem, __cmd_addr);\
+		__cmd_addr += __len;\
+		__cmd_rem -= __len;\
+	}\
+	while (__rem > 0) {\
+		__len = memif_request_len(__addr, __rem);\
+		for (uint32_t __j = 0; __j < __len; __j += MEMIF_DATA_BYTES) {\
+			_Pragma("HLS pipeline II=1")\
+			memif_word_t __data = memif_mem2hwt.read();\
+			for (uint32_t __l = 0; __l < MEMIF_DATA_WORDS; __l++) {\
+				_Pragma("HLS unroll")\
+				(dst)[__i + __l] = memif_word_get(__data, __l);\
+			}\
+			__i += MEMIF_DATA_WORDS;\
+		}\
+		__addr += __len;\
+		__rem -= __len;\
 		\
-		for (; __len > 0; __len -= 4) {\
-			(dst)[__i++] = stream_read(memif_mem2hwt);\
-			__addr += 4;\
-			__rem -= 4;\
+		if (__cmd_rem > 0) {\
+			__len = memif_request_len(__cmd_addr, __cmd_rem);\
+			stream_write(memif_hwt2mem, MEMIF_CMD_READ | __len);\
+			stream_write(memif_hwt2mem, __cmd_addr);\
+			__cmd_addr += __len;\
+			__cmd_rem -= __len;\
 		}\
 	}}
 
 /*
  * Writes several words from the local ram into main memory. Therefore,
  * divides a large request into smaller ones of length at most
- * MEMIF_CHUNK_BYTES and splits request at page borders to guarantee
- * correct address translation.
+ * MEMIF_CHUNK_BYTES and splits request at borders of MEMIF_SPLIT_BYTES
+ * to guarantee correct address translation. The data of each request is
+ * sent by a loop pipelined to one memif word per cycle.
  *
  *   src - array to read data from
  *   dst - start address to write to the main memory
- *   len - number of bytes to transmit (bytes)
+ *   len - number of bytes to transmit (multiple of MEMIF_DATA_BYTES)
  */
 #define MEM_WRITE(src,dst,len){\
-	uint32_t __len, __rem;\
-	uint32_t __addr = (dst), __i = 0;\
-	for (__rem = (len); __rem > 0;) {\
-		uint32_t __to_border = MEMIF_CHUNK_BYTES - (__addr & MEMIF_CHUNK_MASK);\
-		uint32_t __to_rem = __rem;\
-		if (__to_rem < __to_border)\
-			__len = __to_rem;\
-		else\
-			__len = __to_border;\
-		\
+	uint32_t __len, __i = 0;\
+	uint32_t __addr = (dst), __rem = (len);\
+	while (__rem > 0) {\
+		__len = memif_request_len(__addr, __rem);\
 		stream_write(memif_hwt2mem, MEMIF_CMD_WRITE | __len);\
 		stream_write(memif_hwt2mem, __addr);\
-		\
-		for (; __len > 0; __len -= 4) {\
-			stream_write(memif_hwt2mem, (src)[__i++]);\
-			__addr += 4;\
-			__rem -= 4;\
+		for (uint32_t __j = 0; __j < __len; __j += MEMIF_DATA_BYTES) {\
+			_Pragma("HLS pipeline II=1")\
+			memif_word_t __data;\
+			for (uint32_t __l = 0; __l < MEMIF_DATA_WORDS; __l++) {\
+				_Pragma("HLS unroll")\
+				memif_word_set(__data, __l, (src)[__i + __l]);\
+			}\
+			memif_hwt2mem.write(__data);\
+			__i += MEMIF_DATA_WORDS;\
+		}\
+		__addr += __len;\
+		__rem -= __len;\
+	}}
+
+/*
+ * Reads the memory described by a list of scatter-gather descriptors
+ * into the local ram. Each descriptor describes count rows of len bytes,
+ * which start stride bytes apart, and the rows of all descriptors are
+ * received as one contiguous stream. The memif arbiter fetches the
+ * descriptors and splits the rows into requests, so that a strided or
+ * scattered access costs a single command.
+ *
+ *   desc - address of the descriptor list (aligned to MEMIF_SG_DESC_BYTES)
+ *   num  - number of descriptors in the list
+ *   dst  - array to write data into
+ *   len  - total number of bytes described by the list
+ */
+#define MEM_READ_SG(desc,num,dst,len){\
+	uint32_t __i = 0;\
+	stream_write(memif_hwt2mem, MEMIF_CMD_READ_SG | ((num) * MEMIF_SG_DESC_BYTES));\
+	stream_write(memif_hwt2mem, desc);\
+	stream_write(memif_hwt2mem, (len));\
+	for (uint32_t __j = 0; __j < (len); __j += MEMIF_DATA_BYTES) {\
+		_Pragma("HLS pipeline II=1")\
+		memif_word_t __data = memif_mem2hwt.read();\
+		for (uint32_t __l = 0; __l < MEMIF_DATA_WORDS; __l++) {\
+			_Pragma("HLS unroll")\
+			(dst)[__i + __l] = memif_word_get(__data, __l);\
+		}\
+		__i += MEMIF_DATA_WORDS;\
+	}}
+
+/*
+ * Writes the local ram into the memory described by a list of
+ * scatter-gather descriptors, the counterpart of MEM_READ_SG.
+ *
+ *   src  - array to read data from
+ *   desc - address of the descriptor list (aligned to MEMIF_SG_DESC_BYTES)
+ *   num  - number of descriptors in the list
+ *   len  - total number of bytes described by the list
+ */
+#define MEM_WRITE_SG(src,desc,num,len){\
+	uint32_t __i = 0;\
+	stream_write(memif_hwt2mem, MEMIF_CMD_WRITE_SG | ((num) * MEMIF_SG_DESC_BYTES));\
+	stream_write(memif_hwt2mem, desc);\
+	stream_write(memif_hwt2mem, (len));\
+	for (uint32_t __j = 0; __j < (len); __j += MEMIF_DATA_BYTES) {\
+		_Pragma("HLS pipeline II=1")\
+		memif_word_t __data;\
+		for (uint32_t __l = 0; __l < MEMIF_DATA_WORDS; __l++) {\
+			_Pragma("HLS unroll")\
+			memif_word_set(__data, __l, (src)[__i + __l]);\
 		}\
+		memif_hwt2mem.write(__data);\
+		__i += MEMIF_DATA_WORDS;\
 	}}
 
+/*
+ * Reads a single word from the main memory through the cache of the
+ * slot, which is enabled by the option MemifCache of the slot in
+ * build.cfg. Hits are served from the cache without accessing the main
+ * memory, which helps irregular accesses like following pointers. Only
+ * reads through the cache are cached, writes of the thread invalidate the
+ * affected lines. Without a cache the word is read from the main memory.
+ *
+ *   addr - address to read from (aligned to 4 bytes)
+ *
+ *   @returns read word
+ */
+#define CACHED_READ(addr)(\
+	memif_cached_read(memif_hwt2mem, memif_mem2hwt, addr))
+
+/*
+ * Invalidates the cache of the slot. Must be called whenever the data
+ * read by CACHED_READ may have been changed by others, e.g. after
+ * receiving a new job.
+ */
+#define CACHE_INVALIDATE(){\
+	stream_write(memif_hwt2mem, MEMIF_CMD_CACHE_INV);\
+	stream_write(memif_hwt2mem, 0);}
+
+/*
+ * Split-phase memory transfers, which allow to compute while the memif
+ * transfers data. A transfer is started, progressed word by word by
+ * polling (e.g. once per iteration of a compute loop) and completed by
+ * waiting. The memif processes all requests in the order they were
+ * issued, which imposes the following rules:
+ *
+ *   - transfers must be waited for in the order they were started
+ *   - no read and no blocking MEM_READ/MEM_WRITE may be started while a
+ *     split-phase write is in progress, i.e. start reads before writes
+ *   - a read issues all of its requests on start, so that the split-phase
+ *     reads in progress must not exceed half of the hwt2mem fifo in
+ *     requests of MEMIF_CHUNK_BYTES
+ *   - the memif arbiter keeps the grant of a write from its command until
+ *     its last data word, so that a write polled slowly stalls the memory
+ *     accesses of all other hwts, i.e. poll writes at least once per cycle
+ *     or use them only if the hwt is alone on the memif
+ *
+ * Example overlapping the fetch of block i + 1 with computing block i:
+ *
+ *   PINGPONG_RAM(uint32_t, BLOCK_SIZE, ram);
+ *   MEM_TRANSFER(rd);
+ *
+ *   MEM_READ(addr[0], PINGPONG(ram, 0), BLOCK_SIZE * 4);
+ *   for (i = 0; i < n; i++) {
+ *     if (i + 1 < n)
+ *       MEM_READ_START(rd, addr[i + 1], BLOCK_SIZE * 4);
+ *     compute(PINGPONG(ram, i));  // calls MEM_READ_POLL(rd, ...)
+ *     if (i + 1 < n)
+ *       MEM_READ_WAIT(rd, PINGPONG(ram, i + 1));
+ *     MEM_WRITE(PINGPONG(ram, i), addr[i], BLOCK_SIZE * 4);
+ *   }
+ */
+
+/*
+ * Declares the state of a split-phase transfer.
+ *
+ *   name - name of the transfer
+ */
+#define MEM_TRANSFER(name)\
+	memif_transfer name
+
+/*
+ * Starts reading several words from the main memory into the local ram.
+ *
+ *   t   - transfer declared by MEM_TRANSFER
+ *   src - start address to read from the main memory
+ *   len - number of bytes to transmit (bytes)
+ */
+#define MEM_READ_START(t,src,len)\
+	memif_read_start(memif_hwt2mem, t, src, len)
+
+/*
+ * Receives a single memif word of a started read if already available.
+ *
+ *   t   - transfer declared by MEM_TRANSFER
+ *   dst - array to write data into
+ */
+#define MEM_READ_POLL(t,dst)\
+	memif_read_poll(memif_mem2hwt, t, dst)
+
+/*
+ * Waits until a started read has completed.
+ *
+ *   t   - transfer declared by MEM_TRANSFER
+ *   dst - array to write data into
+ */
+#define MEM_READ_WAIT(t,dst)\
+	memif_read_wait(memif_mem2hwt, t, dst)
+
+/*
+ * Starts writing several words from the local ram into main memory.
+ *
+ *   t   - transfer declared by MEM_TRANSFER
+ *   dst - start address to write to the main memory
+ *   len - number of bytes to transmit (bytes)
+ */
+#define MEM_WRITE_START(t,dst,len)\
+	memif_write_start(t, dst, len)
+
+/*
+ * Sends a single memif word of a started write if the memif accepts it.
+ *
+ *   t   - transfer declared by MEM_TRANSFER
+ *   src - array to read data from
+ */
+#define MEM_WRITE_POLL(t,src)\
+	memif_write_poll(memif_hwt2mem, t, src)
+
+/*
+ * Waits until all words of a started write are passed to the memif.
+ *
+ *   t   - transfer declared by MEM_TRANSFER
+ *   src - array to read data from
+ */
+#define MEM_WRITE_WAIT(t,src)\
+	memif_write_wait(memif_hwt2mem, t, src)
+
 /*
  * Terminates the current ReconOS thread.
  */
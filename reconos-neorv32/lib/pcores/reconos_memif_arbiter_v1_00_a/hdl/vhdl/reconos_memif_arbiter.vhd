@@ -13,6 +13,19 @@
 --   description:  The arbiter connects the different HWTs
 --                 to the memory system of ReconOS. It acts as an
 --                 arbiter and controls the the memory access.
+--                 Requests are granted by a weighted round robin,
+--                 where each HWT may issue up to its weight of
+--                 requests per round. Reads are released as soon as
+--                 command and address are issued, and their data is
+--                 returned in order while the next requests are
+--                 already issued to the memory.
+--                 Scatter-gather commands are expanded by the arbiter,
+--                 which fetches the descriptors and issues a request
+--                 per chunk of each described row, while the data is
+--                 passed as one stream to and from the HWT.
+--                 Cache commands of HWTs without a cache are handled
+--                 by the arbiter, which issues cached reads as plain
+--                 reads and drops invalidates.
 --
 -- ======================================================================
 
@@ -33,10 +46,15 @@ entity reconos_memif_arbiter is
 	--
 	--   C_MEMIF_DATA_WIDTH - width of the memif
 	--
+	--   C_MAX_OUTSTANDING - maximum number of reads issued to the memory
+	--                       whose data is not yet returned
+	--
 	generic (
 		C_NUM_HWTS : integer := 1;
 
-		C_MEMIF_DATA_WIDTH : integer := 32
+		C_MEMIF_DATA_WIDTH : integer := 32;
+
+		C_MAX_OUTSTANDING : integer := 4
 	);
 
 	--
@@ -45,6 +63,14 @@ entity reconos_memif_arbiter is
 	--   MEMIF_Hwt2Mem_#i#_In_/MEMIF_Mem2Hwt_#i#_In_ - fifo signal inputs
 	--
 	--   MEMIF_Hwt2Mem_Out_/MEMIF_Mem2Hwt_Out_ - fifo signal outputs
+	--
+	--   PERF_Grant - hwt currently served by the memory, i.e. receiving
+	--                the data of the oldest outstanding read or else
+	--                granted to issue requests
+	--   PERF_Rd    - memif word transferred from memory to granted hwt
+	--   PERF_Wr    - memif word transferred from granted hwt to memory
+	--   PERF_Stall - hwt has a pending request but the memory side
+	--                does not transfer data
 	--   
 	--   SYS_Clk - system clock
 	--   SYS_Rst - system reset
@@ -70,6 +96,11 @@ entity reconos_memif_arbiter is
 		MEMIF_Mem2Hwt_Out_Full  : out std_logic;
 		MEMIF_Mem2Hwt_Out_WE    : in  std_logic;
 
+		PERF_Grant : out std_logic_vector(C_NUM_HWTS - 1 downto 0);
+		PERF_Rd    : out std_logic;
+		PERF_Wr    : out std_logic;
+		PERF_Stall : out std_logic_vector(C_NUM_HWTS - 1 downto 0);
+
 		SYS_Clk : in std_logic;
 		SYS_Rst : in std_logic
 	);
@@ -114,31 +145,146 @@ architecture imp of reconos_memif_arbiter is
 	--   state_type - vhdl type of the states
 	--   state      - instantiation of the state
 	--
-	type state_type is (STATE_WAIT,STATE_ARBITRATE,
-	                    STATE_CMD,STATE_ADDR,STATE_PROCESS);
+	type state_type is (STATE_WAIT,
+	                    STATE_CMD,STATE_ADDR,STATE_PROCESS,STATE_INV,
+	                    STATE_SG_LIST,STATE_SG_LEN,STATE_SG_DESC_CMD,STATE_SG_DESC_ADDR,
+	                    STATE_SG_DESC_DATA,STATE_SG_ROW,STATE_SG_CHUNK,
+	                    STATE_SG_CMD,STATE_SG_ADDR,STATE_SG_PROCESS);
 	signal state : state_type := STATE_WAIT;
 
 	--
-	-- Internal signals for round robin arbiter
+	-- Internal signals for weighted round robin arbiter
 	--
+	--   pnd  - pending request vector
 	--   req  - masked request vector
 	--   msk  - mask to disable previous grants
 	--   msb  - most significant bit of req
+	--   pmsb - most significant bit of pnd, granted if a new round starts
+	--   nxt  - grant vector of the next request
 	--   grnt - grant vector to multiplex signals
 	--   orr  - override for full and empty signals
+	--   wgt  - weights of the hwts, i.e. number of requests granted to
+	--          a hwt per round before the next hwt is granted
+	--   used - number of requests granted to a hwt in the current round
 	--
+	type weight_t is array (0 to C_NUM_HWTS - 1) of unsigned(3 downto 0);
+
+	signal pnd  : std_logic_vector(C_NUM_HWTS - 1 downto 0) := (others => '0');
 	signal req  : std_logic_vector(C_NUM_HWTS - 1 downto 0) := (others => '0');
 	signal msk  : std_logic_vector(C_NUM_HWTS - 1 downto 0) := (others => '1');
 	signal msb  : std_logic_vector(C_NUM_HWTS - 1 downto 0) := (others => '0');
+	signal pmsb : std_logic_vector(C_NUM_HWTS - 1 downto 0) := (others => '0');
+	signal nxt  : std_logic_vector(C_NUM_HWTS - 1 downto 0) := (others => '0');
 	signal grnt : std_logic_vector(C_NUM_HWTS - 1 downto 0) := (others => '0');
 	signal orr  : std_logic := '1';
+	signal wgt  : weight_t;
+	signal used : weight_t := (others => (others => '0'));
 
 	--
 	-- Internal signals
 	--
 	--   mem_count - counter of transferred bytes
+	--   mem_wr    - current request is a write
 	--
 	signal mem_count : unsigned(C_MEMIF_LENGTH_WIDTH - 1 downto 0) := (others => '0');
+	signal mem_wr    : std_logic := '0';
+
+	--
+	-- Signals for outstanding reads
+	--
+	--   The data of reads is returned by the memory in the order of the
+	--   requests. Therefore, the granted hwt and length of each issued
+	--   read is queued, and the data is passed to the hwt at the head of
+	--   the queue until its length is reached.
+	--
+	--   q_hwt     - grant vectors of the outstanding reads
+	--   q_len     - lengths of the outstanding reads
+	--   q_wr      - index of the next entry to write
+	--   q_rd      - index of the oldest entry
+	--   q_cnt     - number of outstanding reads
+	--   q_push    - read is issued in current cycle
+	--   q_pop     - last word of the oldest read is returned
+	--   rsp_count - counter of returned bytes of the oldest read
+	--   qgnt      - grant vector of the oldest read
+	--   rgnt      - grant vector to multiplex the returned data, which
+	--               falls back to grnt for scatter-gather transfers
+	--   rorr      - override for full signal if no hwt receives data
+	--   cmd_blk   - command of the granted hwt must wait for the
+	--               outstanding reads
+	--   sg_wait   - a scatter-gather command waits for the outstanding
+	--               reads to drain, so no further reads are issued
+	--   sg_hwt    - grant vector of the hwt with the waiting command
+	--
+	type q_hwt_t is array (0 to C_MAX_OUTSTANDING - 1) of std_logic_vector(C_NUM_HWTS - 1 downto 0);
+	type q_len_t is array (0 to C_MAX_OUTSTANDING - 1) of unsigned(C_MEMIF_LENGTH_WIDTH - 1 downto 0);
+
+	signal q_hwt     : q_hwt_t := (others => (others => '0'));
+	signal q_len     : q_len_t := (others => (others => '0'));
+	signal q_wr      : integer range 0 to C_MAX_OUTSTANDING - 1 := 0;
+	signal q_rd      : integer range 0 to C_MAX_OUTSTANDING - 1 := 0;
+	signal q_cnt     : integer range 0 to C_MAX_OUTSTANDING := 0;
+	signal q_push    : std_logic;
+	signal q_pop     : std_logic;
+	signal rsp_count : unsigned(C_MEMIF_LENGTH_WIDTH - 1 downto 0) := (others => '0');
+	signal qgnt      : std_logic_vector(C_NUM_HWTS - 1 downto 0);
+	signal rgnt      : std_logic_vector(C_NUM_HWTS - 1 downto 0);
+	signal rorr      : std_logic;
+	signal cmd_blk   : std_logic;
+	signal sg_wait   : std_logic := '0';
+	signal sg_hwt    : std_logic_vector(C_NUM_HWTS - 1 downto 0) := (others => '0');
+
+	--
+	-- Signals for scatter-gather transfers
+	--
+	--   sg_cmd     - command at the head of the granted fifo is a
+	--                scatter-gather command
+	--   sg_num     - number of descriptors left in the list
+	--   sg_list    - address of the next descriptor
+	--   sg_desc    - current descriptor (address of the next row, length,
+	--                stride and number of rows left)
+	--   sg_word    - index of the next descriptor word to receive
+	--   sg_addr    - address of the next request
+	--   sg_rem     - remaining bytes of the current row
+	--   sg_len     - length of the current request
+	--   sg_hdr     - command or address word issued by the arbiter
+	--   sg_own     - arbiter consumes the words of the granted hwt or
+	--                issues words to the memory in its place
+	--   sg_rcv     - arbiter receives a descriptor from the memory
+	--
+	type sg_desc_t is array (0 to 3) of unsigned(31 downto 0);
+
+	signal sg_cmd  : std_logic;
+	signal sg_num  : unsigned(C_MEMIF_LENGTH_WIDTH - 1 downto 0) := (others => '0');
+	signal sg_list : unsigned(31 downto 0) := (others => '0');
+	signal sg_desc : sg_desc_t := (others => (others => '0'));
+	signal sg_word : integer range 0 to 3 := 0;
+	signal sg_addr : unsigned(31 downto 0) := (others => '0');
+	signal sg_rem  : unsigned(C_MEMIF_LENGTH_WIDTH - 1 downto 0) := (others => '0');
+	signal sg_len  : unsigned(C_MEMIF_LENGTH_WIDTH - 1 downto 0) := (others => '0');
+	signal sg_hdr  : std_logic_vector(C_MEMIF_CMD_WIDTH - 1 downto 0);
+	signal sg_own  : std_logic;
+	signal sg_rcv  : std_logic;
+
+	--
+	-- Signals for cache commands
+	--
+	--   inv_cmd - command at the head of the granted fifo invalidates
+	--             a cache
+	--   rd_cmd  - command at the head of the granted fifo is a cached
+	--             read, which is issued as plain read
+	--
+	signal inv_cmd : std_logic;
+	signal rd_cmd  : std_logic_vector(C_MEMIF_CMD_WIDTH - 1 downto 0);
+
+	--
+	-- Signals for performance counting
+	--
+	--   xfer_rd, xfer_wr - data word transferred in current cycle
+	--   mem_stall        - granted request is stalled by memory side
+	--   rd_stall         - oldest outstanding read is stalled by memory
+	--                      side
+	--
+	signal xfer_rd, xfer_wr, mem_stall, rd_stall : std_logic;
 
 	--
 	-- Signals used for usage of multiplexed signals
@@ -153,10 +299,38 @@ begin
 	-- == Assignment of input signals =====================================
 
 	<<generate for SLOTS>>
-	req(<<_i>>) <= not MEMIF_Hwt2Mem_<<Id>>_In_Empty and msk(<<_i>>);
+	pnd(<<_i>>) <= not MEMIF_Hwt2Mem_<<Id>>_In_Empty;
+	wgt(<<_i>>) <= to_unsigned(<<MemifWeight>>, 4);
 	<<end generate>>
 
+	req <= pnd and msk;
 	msb <= req and std_logic_vector(unsigned(not(req)) + 1);
+	pmsb <= pnd and std_logic_vector(unsigned(not(pnd)) + 1);
+
+	-- if all pending hwts used their requests of the round, a new round
+	-- starts with all hwts unmasked
+	nxt <= msb when req /= (req'Range => '0') else pmsb;
+
+	sg_cmd <= '1' when hwt2mem_data(C_MEMIF_OP_RANGE) = MEMIF_CMD_READ_SG else
+	          '1' when hwt2mem_data(C_MEMIF_OP_RANGE) = MEMIF_CMD_WRITE_SG else
+	          '0';
+
+	inv_cmd <= '1' when hwt2mem_data(C_MEMIF_OP_RANGE) = MEMIF_CMD_CACHE_INV else '0';
+
+	rd_cmd <= MEMIF_CMD_READ & hwt2mem_data(C_MEMIF_LENGTH_RANGE)
+	            when hwt2mem_data(C_MEMIF_OP_RANGE) = MEMIF_CMD_READ_CACHED else
+	          hwt2mem_data(C_MEMIF_CMD_WIDTH - 1 downto 0);
+
+	-- scatter-gather commands receive descriptors from the memory and are
+	-- therefore only started without outstanding reads, reads only if
+	-- another one can be queued and no scatter-gather command waits, as
+	-- the reads of other hwts would otherwise starve it
+	cmd_blk <= '1' when state = STATE_CMD and sg_cmd = '1' and q_cnt /= 0 else
+	           '1' when state = STATE_CMD and (q_cnt = C_MAX_OUTSTANDING or sg_wait = '1')
+	                    and hwt2mem_data(C_MEMIF_OP_RANGE) = MEMIF_CMD_READ else
+	           '1' when state = STATE_CMD and (q_cnt = C_MAX_OUTSTANDING or sg_wait = '1')
+	                    and hwt2mem_data(C_MEMIF_OP_RANGE) = MEMIF_CMD_READ_CACHED else
+	           '0';
 
 
 	-- == Process definitions =============================================
@@ -164,67 +338,294 @@ begin
 	--
 	-- Arbitrate fifos based on requests and snoop
 	--
-	--   A state machine to implement a round robin arbiter. The arbiter
-	--   snoops on the fifos to figure out the end of a transaction.
+	--   A state machine to implement a weighted round robin arbiter. The
+	--   arbiter snoops on the fifos to figure out the end of a request
+	--   and grants the next hwt in the same cycle. Reads end after
+	--   the address, while their data is returned by the rsp process.
 	--
 	arb : process(SYS_Clk,SYS_Rst) is
-		variable i : integer range 1 to C_NUM_HWTS;
+		variable to_border : unsigned(C_MEMIF_LENGTH_WIDTH - 1 downto 0);
+		variable hand : boolean;
+		variable u : unsigned(3 downto 0);
+		variable m : std_logic;
 	begin
 		if SYS_Rst = '1' then
 			msk <= (others => '1');
+			used <= (others => (others => '0'));
 			grnt <= (others => '0');
+			sg_wait <= '0';
 
 			state <= STATE_WAIT;
 		elsif rising_edge(SYS_Clk) then
+			hand := false;
+
+			-- a blocked scatter-gather command keeps further reads from
+			-- being issued until it starts or its hwt is reset
+			if state = STATE_CMD and sg_cmd = '1' and (pnd and grnt) /= (pnd'Range => '0') then
+				if q_cnt /= 0 then
+					sg_wait <= '1';
+					sg_hwt <= grnt;
+				else
+					sg_wait <= '0';
+				end if;
+			elsif (pnd and sg_hwt) = (pnd'Range => '0') then
+				sg_wait <= '0';
+			end if;
+
 			case state is
 				when STATE_WAIT =>
-					if req = (req'Range => '0') then
-						msk <= (others => '1');
-					else
-						state <= STATE_ARBITRATE;
+					if pnd /= (pnd'Range => '0') then
+						hand := true;
 					end if;
 
-				when STATE_ARBITRATE =>
-					grnt <= msb;
-					msk <= msk and (not msb);
-
-					state <= STATE_CMD;
-
 				when STATE_CMD =>
-					if MEMIF_Hwt2Mem_Out_RE = '1' and hwt2mem_empty = '0' then
+					if hwt2mem_empty = '0' and inv_cmd = '1' then
+						state <= STATE_INV;
+					elsif hwt2mem_empty = '0' and sg_cmd = '1' then
+						sg_num <= shift_right(unsigned(hwt2mem_data(C_MEMIF_LENGTH_RANGE)), 4);
+
+						if hwt2mem_data(C_MEMIF_OP_RANGE) = MEMIF_CMD_WRITE_SG then
+							mem_wr <= '1';
+						else
+							mem_wr <= '0';
+						end if;
+
+						state <= STATE_SG_LIST;
+					elsif MEMIF_Hwt2Mem_Out_RE = '1' and hwt2mem_empty = '0' then
 						mem_count <= unsigned(hwt2mem_data(C_MEMIF_LENGTH_RANGE));
 
+						if hwt2mem_data(C_MEMIF_OP_RANGE) = MEMIF_CMD_WRITE then
+							mem_wr <= '1';
+						else
+							mem_wr <= '0';
+						end if;
+
 						state <= STATE_ADDR;
+					elsif hwt2mem_empty = '1' then
+						-- the granted hwt has no further request or must
+						-- wait for the outstanding reads
+						hand := true;
 					end if;
 
 				when STATE_ADDR =>
 					if MEMIF_Hwt2Mem_Out_RE = '1' and hwt2mem_empty = '0' then
-						state <= STATE_PROCESS;
+						if mem_wr = '1' then
+							state <= STATE_PROCESS;
+						else
+							hand := true;
+						end if;
 					end if;
 
 				when STATE_PROCESS =>
+					if MEMIF_Hwt2Mem_Out_RE = '1' and hwt2mem_empty = '0' then
+						mem_count <= mem_count - C_MEMIF_DATA_WIDTH / 8;
+
+						if mem_count - C_MEMIF_DATA_WIDTH / 8 = 0 then
+							hand := true;
+						end if;
+					end if;
+
+				when STATE_INV =>
+					if hwt2mem_empty = '0' then
+						hand := true;
+					end if;
+
+				when STATE_SG_LIST =>
+					if hwt2mem_empty = '0' then
+						sg_list <= unsigned(hwt2mem_data(31 downto 0));
+						sg_desc(3) <= (others => '0');
+
+						state <= STATE_SG_LEN;
+					end if;
+
+				-- the total length is only needed by components between
+				-- the hwt and the arbiter to follow the stream
+				when STATE_SG_LEN =>
+					if hwt2mem_empty = '0' then
+						state <= STATE_SG_ROW;
+					end if;
+
+				when STATE_SG_DESC_CMD =>
+					if MEMIF_Hwt2Mem_Out_RE = '1' then
+						state <= STATE_SG_DESC_ADDR;
+					end if;
+
+				when STATE_SG_DESC_ADDR =>
+					if MEMIF_Hwt2Mem_Out_RE = '1' then
+						sg_word <= 0;
+
+						state <= STATE_SG_DESC_DATA;
+					end if;
+
+				when STATE_SG_DESC_DATA =>
+					if MEMIF_Mem2Hwt_Out_WE = '1' then
+						for l in 0 to C_MEMIF_DATA_WIDTH / 32 - 1 loop
+							sg_desc(sg_word + l) <= unsigned(MEMIF_Mem2Hwt_Out_Data(32 * l + 31 downto 32 * l));
+						end loop;
+
+						if sg_word + C_MEMIF_DATA_WIDTH / 32 = 4 then
+							sg_list <= sg_list + C_MEMIF_SG_DESC_BYTES;
+							sg_num <= sg_num - 1;
+
+							state <= STATE_SG_ROW;
+						else
+							sg_word <= sg_word + C_MEMIF_DATA_WIDTH / 32;
+						end if;
+					end if;
+
+				when STATE_SG_ROW =>
+					if sg_desc(3) /= 0 then
+						sg_addr <= sg_desc(0);
+						sg_rem <= sg_desc(1)(C_MEMIF_LENGTH_RANGE);
+						sg_desc(0) <= sg_desc(0) + sg_desc(2);
+						sg_desc(3) <= sg_desc(3) - 1;
+
+						state <= STATE_SG_CHUNK;
+					elsif sg_num /= 0 then
+						state <= STATE_SG_DESC_CMD;
+					else
+						hand := true;
+					end if;
+
+				when STATE_SG_CHUNK =>
+					to_border := to_unsigned(C_MEMIF_CHUNK_BYTES, C_MEMIF_LENGTH_WIDTH) - sg_addr(C_MEMIF_CHUNK_RANGE);
+
+					if sg_rem = 0 then
+						state <= STATE_SG_ROW;
+					elsif sg_rem < to_border then
+						sg_len <= sg_rem;
+						mem_count <= sg_rem;
+
+						state <= STATE_SG_CMD;
+					else
+						sg_len <= to_border;
+						mem_count <= to_border;
+
+						state <= STATE_SG_CMD;
+					end if;
+
+				when STATE_SG_CMD =>
+					if MEMIF_Hwt2Mem_Out_RE = '1' then
+						state <= STATE_SG_ADDR;
+					end if;
+
+				when STATE_SG_ADDR =>
+					if MEMIF_Hwt2Mem_Out_RE = '1' then
+						state <= STATE_SG_PROCESS;
+					end if;
+
+				when STATE_SG_PROCESS =>
 					if    (MEMIF_Hwt2Mem_Out_RE = '1' and hwt2mem_empty = '0')
 					   or (MEMIF_Mem2Hwt_Out_WE = '1' and mem2hwt_full = '0') then
-						mem_count <= mem_count - 4;
+						mem_count <= mem_count - C_MEMIF_DATA_WIDTH / 8;
 
-						if mem_count - 4 = 0 then
-							state <= STATE_WAIT;
+						if mem_count - C_MEMIF_DATA_WIDTH / 8 = 0 then
+							sg_addr <= sg_addr + sg_len;
+							sg_rem <= sg_rem - sg_len;
 
-							grnt <= (others => '0');
+							state <= STATE_SG_CHUNK;
 						end if;
 					end if;
 
 				when others =>
 			end case;
+
+			-- grant the next hwt, which keeps its mask bit until it
+			-- used up its weight in the current round
+			if hand then
+				grnt <= nxt;
+
+				if nxt = (nxt'Range => '0') then
+					state <= STATE_WAIT;
+				else
+					state <= STATE_CMD;
+				end if;
+
+				for l in 0 to C_NUM_HWTS - 1 loop
+					if req = (req'Range => '0') then
+						u := (others => '0');
+						m := '1';
+					else
+						u := used(l);
+						m := msk(l);
+					end if;
+
+					if nxt(l) = '1' then
+						if u + 1 >= wgt(l) then
+							u := (others => '0');
+							m := '0';
+						else
+							u := u + 1;
+						end if;
+					end if;
+
+					used(l) <= u;
+					msk(l) <= m;
+				end loop;
+			end if;
 		end if;
 	end process arb;
 
+	--
+	-- Return the data of outstanding reads
+	--
+	--   Queues the issued reads and counts the returned data of the
+	--   oldest one to release it after its last word.
+	--
+	rsp : process(SYS_Clk,SYS_Rst) is
+	begin
+		if SYS_Rst = '1' then
+			q_wr <= 0;
+			q_rd <= 0;
+			q_cnt <= 0;
+			rsp_count <= (others => '0');
+		elsif rising_edge(SYS_Clk) then
+			if q_push = '1' then
+				q_hwt(q_wr) <= grnt;
+				q_len(q_wr) <= mem_count;
+
+				if q_wr = C_MAX_OUTSTANDING - 1 then
+					q_wr <= 0;
+				else
+					q_wr <= q_wr + 1;
+				end if;
+			end if;
+
+			if xfer_rd = '1' and q_cnt /= 0 then
+				if q_pop = '1' then
+					rsp_count <= (others => '0');
+
+					if q_rd = C_MAX_OUTSTANDING - 1 then
+						q_rd <= 0;
+					else
+						q_rd <= q_rd + 1;
+					end if;
+				else
+					rsp_count <= rsp_count + C_MEMIF_DATA_WIDTH / 8;
+				end if;
+			end if;
+
+			if q_push = '1' and q_pop = '0' then
+				q_cnt <= q_cnt + 1;
+			elsif q_push = '0' and q_pop = '1' then
+				q_cnt <= q_cnt - 1;
+			end if;
+		end if;
+	end process rsp;
+
+	q_push <= '1' when state = STATE_ADDR and mem_wr = '0'
+	                   and MEMIF_Hwt2Mem_Out_RE = '1' and hwt2mem_empty = '0' else '0';
+	q_pop  <= '1' when xfer_rd = '1' and q_cnt /= 0
+	                   and rsp_count + C_MEMIF_DATA_WIDTH / 8 = q_len(q_rd) else '0';
+
 
 	-- == Multiplexing signals ============================================
 
-	orr <= '1' when state = STATE_WAIT else
-	       '1' when state = STATE_ARBITRATE else
-	       '0';
+	orr <= '1' when state = STATE_WAIT else '0';
+
+	qgnt <= q_hwt(q_rd) when q_cnt /= 0 else (others => '0');
+	rgnt <= qgnt when q_cnt /= 0 else grnt;
+	rorr <= '1' when rgnt = (rgnt'Range => '0') else '0';
 
 	hwt2mem_data <=
 	  <<generate for SLOTS>>
@@ -236,21 +637,89 @@ begin
 	  <<generate for SLOTS>>
 	  (MEMIF_Hwt2Mem_<<Id>>_In_Empty and grnt(<<_i>>)) or
 	  <<end generate>>
-	  orr;
+	  orr or cmd_blk;
 
 	mem2hwt_full <=
 	  <<generate for SLOTS>>
-	  (MEMIF_Mem2Hwt_<<Id>>_In_Full and grnt(<<_i>>)) or
+	  (MEMIF_Mem2Hwt_<<Id>>_In_Full and rgnt(<<_i>>)) or
 	  <<end generate>>
-	  orr;
-
-	MEMIF_Hwt2Mem_Out_Data  <= hwt2mem_data;
-	MEMIF_Hwt2Mem_Out_Empty <= hwt2mem_empty;
-	MEMIF_Mem2Hwt_Out_Full  <=  mem2hwt_full;
+	  rorr;
+
+	-- the arbiter consumes scatter-gather and invalidate commands itself
+	-- and issues the requests to the memory in place of the hwt
+	sg_own <= '1' when state = STATE_CMD and sg_cmd = '1' else
+	          '1' when state = STATE_CMD and inv_cmd = '1' else
+	          '1' when state = STATE_INV else
+	          '1' when state = STATE_SG_LIST else
+	          '1' when state = STATE_SG_LEN else
+	          '1' when state = STATE_SG_DESC_CMD else
+	          '1' when state = STATE_SG_DESC_ADDR else
+	          '1' when state = STATE_SG_DESC_DATA else
+	          '1' when state = STATE_SG_ROW else
+	          '1' when state = STATE_SG_CHUNK else
+	          '1' when state = STATE_SG_CMD else
+	          '1' when state = STATE_SG_ADDR else
+	          '0';
+
+	sg_rcv <= '1' when state = STATE_SG_DESC_DATA else '0';
+
+	sg_hdr <= MEMIF_CMD_READ & std_logic_vector(to_unsigned(C_MEMIF_SG_DESC_BYTES, C_MEMIF_LENGTH_WIDTH))
+	                                   when state = STATE_SG_DESC_CMD else
+	          std_logic_vector(sg_list) when state = STATE_SG_DESC_ADDR else
+	          MEMIF_CMD_WRITE & std_logic_vector(sg_len)
+	                                   when state = STATE_SG_CMD and mem_wr = '1' else
+	          MEMIF_CMD_READ & std_logic_vector(sg_len)
+	                                   when state = STATE_SG_CMD else
+	          std_logic_vector(sg_addr);
+
+	MEMIF_Hwt2Mem_Out_Data  <= std_logic_vector(resize(unsigned(sg_hdr), C_MEMIF_DATA_WIDTH)) when sg_own = '1' else
+	                           std_logic_vector(resize(unsigned(rd_cmd), C_MEMIF_DATA_WIDTH)) when state = STATE_CMD else
+	                           hwt2mem_data;
+	MEMIF_Hwt2Mem_Out_Empty <= '0' when state = STATE_SG_DESC_CMD else
+	                           '0' when state = STATE_SG_DESC_ADDR else
+	                           '0' when state = STATE_SG_CMD else
+	                           '0' when state = STATE_SG_ADDR else
+	                           '1' when sg_own = '1' else
+	                           hwt2mem_empty;
+	MEMIF_Mem2Hwt_Out_Full  <= '0' when sg_rcv = '1' else
+	                           mem2hwt_full;
 	<<generate for SLOTS>>
-	MEMIF_Hwt2Mem_<<Id>>_In_RE   <= MEMIF_Hwt2Mem_Out_RE and grnt(<<_i>>);
+	MEMIF_Hwt2Mem_<<Id>>_In_RE   <= (MEMIF_Hwt2Mem_Out_RE and grnt(<<_i>>)) when sg_own = '0' else
+	                                (grnt(<<_i>>) and not hwt2mem_empty) when state = STATE_CMD or state = STATE_INV else
+	                                (grnt(<<_i>>) and not hwt2mem_empty) when state = STATE_SG_LIST or state = STATE_SG_LEN else
+	                                '0';
 	MEMIF_Mem2Hwt_<<Id>>_In_Data <= MEMIF_Mem2Hwt_Out_Data;
-	MEMIF_Mem2Hwt_<<Id>>_In_WE   <= MEMIF_Mem2Hwt_Out_WE and grnt(<<_i>>);
+	MEMIF_Mem2Hwt_<<Id>>_In_WE   <= MEMIF_Mem2Hwt_Out_WE and rgnt(<<_i>>) and not sg_rcv;
+	<<end generate>>
+
+
+	-- == Performance signals =============================================
+
+	xfer_rd <= '1' when (q_cnt /= 0 or (state = STATE_SG_PROCESS and mem_wr = '0'))
+	                    and MEMIF_Mem2Hwt_Out_WE = '1' and mem2hwt_full = '0' else '0';
+	xfer_wr <= '1' when (state = STATE_PROCESS or (state = STATE_SG_PROCESS and mem_wr = '1'))
+	                    and MEMIF_Hwt2Mem_Out_RE = '1' and hwt2mem_empty = '0' else '0';
+
+	-- the hwt side is ready but no data is transferred, this includes
+	-- waiting for the command to be accepted, address translation and
+	-- fetching scatter-gather descriptors
+	mem_stall <= '1' when state = STATE_CMD or state = STATE_ADDR else
+	             '1' when sg_own = '1' else
+	             '1' when (state = STATE_PROCESS or (state = STATE_SG_PROCESS and mem_wr = '1'))
+	                      and hwt2mem_empty = '0' and xfer_wr = '0' else
+	             '1' when state = STATE_SG_PROCESS and mem_wr = '0'
+	                      and mem2hwt_full = '0' and xfer_rd = '0' else
+	             '0';
+
+	rd_stall <= '1' when q_cnt /= 0 and mem2hwt_full = '0' and xfer_rd = '0' else '0';
+
+	PERF_Grant <= rgnt;
+	PERF_Rd    <= xfer_rd;
+	PERF_Wr    <= xfer_wr;
+	<<generate for SLOTS>>
+	PERF_Stall(<<_i>>) <= rd_stall when qgnt(<<_i>>) = '1' else
+	                      mem_stall when grnt(<<_i>>) = '1' else
+	                      not MEMIF_Hwt2Mem_<<Id>>_In_Empty;
 	<<end generate>>
 
 end architecture imp;
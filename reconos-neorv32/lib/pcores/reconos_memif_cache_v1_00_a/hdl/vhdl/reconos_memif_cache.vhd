@@ -0,0 +1,448 @@
+--                                                        ____  _____
+--                            ________  _________  ____  / __ \/ ___/
+--                           / ___/ _ \/ ___/ __ \/ __ \/ / / /\__ \
+--                          / /  /  __/ /__/ /_/ / / / / /_/ /___/ /
+--                         /_/   \___/\___/\____/_/ /_/\____//____/
+--
+-- ======================================================================
+--
+--   title:        IP-Core - MEMIF Cache
+--
+--   project:      ReconOS
+--   author:       Computer Engineering Group, University of Paderborn
+--   description:  A small set-associative read cache placed between
+--                 the memif fifos of a HWT and the arbiter. It serves
+--                 cached reads of single memif words and fetches
+--                 missing lines from the memory. All other requests
+--                 are passed through, whereby writes invalidate the
+--                 affected lines. The cache is invalidated by an
+--                 invalidate command and on reset of the HWT.
+--
+-- ======================================================================
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+use ieee.math_real.all;
+
+library reconos_v3_01_a;
+use reconos_v3_01_a.reconos_pkg.all;
+
+
+entity reconos_memif_cache is
+	--
+	-- Generic definitions
+	--
+	--   C_CACHE_SETS       - number of sets (power of two)
+	--   C_CACHE_WAYS       - number of lines per set
+	--   C_CACHE_LINE_BYTES - size of a line in bytes (power of two,
+	--                        multiple of the width of the memif and at
+	--                        most C_MEMIF_CHUNK_BYTES)
+	--
+	--   C_MEMIF_DATA_WIDTH - width of the memif
+	--
+	generic (
+		C_CACHE_SETS       : integer := 32;
+		C_CACHE_WAYS       : integer := 2;
+		C_CACHE_LINE_BYTES : integer := 32;
+
+		C_MEMIF_DATA_WIDTH : integer := 32
+	);
+
+	--
+	-- Port definitions
+	--
+	--   MEMIF_Hwt2Mem_In_/MEMIF_Mem2Hwt_In_ - fifo signal inputs
+	--   MEMIF_Hwt2Mem_Out_/MEMIF_Mem2Hwt_Out_ - fifo signal outputs
+	--
+	--   SYS_Clk - system clock
+	--   SYS_Rst - system reset, should be the reset of the hwt
+	--
+	port (
+		MEMIF_Hwt2Mem_In_Data  : in  std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
+		MEMIF_Hwt2Mem_In_Empty : in  std_logic;
+		MEMIF_Hwt2Mem_In_RE    : out std_logic;
+
+		MEMIF_Mem2Hwt_In_Data  : out std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
+		MEMIF_Mem2Hwt_In_Full  : in  std_logic;
+		MEMIF_Mem2Hwt_In_WE    : out std_logic;
+
+		MEMIF_Hwt2Mem_Out_Data  : out std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
+		MEMIF_Hwt2Mem_Out_Empty : out std_logic;
+		MEMIF_Hwt2Mem_Out_RE    : in  std_logic;
+
+		MEMIF_Mem2Hwt_Out_Data  : in  std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
+		MEMIF_Mem2Hwt_Out_Full  : out std_logic;
+		MEMIF_Mem2Hwt_Out_WE    : in  std_logic;
+
+		SYS_Clk : in std_logic;
+		SYS_Rst : in std_logic
+	);
+end entity reconos_memif_cache;
+
+architecture imp of reconos_memif_cache is
+
+	-- Declare port attributes for the Vivado IP Packager
+	ATTRIBUTE X_INTERFACE_INFO : STRING;
+	ATTRIBUTE X_INTERFACE_PARAMETER : STRING;
+
+	ATTRIBUTE X_INTERFACE_INFO of SYS_Clk: SIGNAL is "xilinx.com:signal:clock:1.0 SYS_Clk CLK";
+	ATTRIBUTE X_INTERFACE_PARAMETER of SYS_Clk: SIGNAL is "ASSOCIATED_RESET SYS_Rst, ASSOCIATED_BUSIF MEMIF_Hwt2Mem_In:MEMIF_Mem2Hwt_In:MEMIF_Mem2Hwt_Out:MEMIF_Hwt2Mem_Out";
+
+	ATTRIBUTE X_INTERFACE_INFO of SYS_Rst: SIGNAL is "xilinx.com:signal:reset:1.0 SYS_Rst RST";
+	ATTRIBUTE X_INTERFACE_PARAMETER of SYS_Rst: SIGNAL is "POLARITY ACTIVE_HIGH";
+
+	ATTRIBUTE X_INTERFACE_INFO of MEMIF_Hwt2Mem_In_Data:   SIGNAL is "cs.upb.de:reconos:FIFO_S:1.0 MEMIF_Hwt2Mem_In FIFO_S_Data";
+	ATTRIBUTE X_INTERFACE_INFO of MEMIF_Hwt2Mem_In_Empty:  SIGNAL is "cs.upb.de:reconos:FIFO_S:1.0 MEMIF_Hwt2Mem_In FIFO_S_Empty";
+	ATTRIBUTE X_INTERFACE_INFO of MEMIF_Hwt2Mem_In_RE:     SIGNAL is "cs.upb.de:reconos:FIFO_S:1.0 MEMIF_Hwt2Mem_In FIFO_S_RE";
+
+	ATTRIBUTE X_INTERFACE_INFO of MEMIF_Mem2Hwt_In_Data:   SIGNAL is "cs.upb.de:reconos:FIFO_M:1.0 MEMIF_Mem2Hwt_In FIFO_M_Data";
+	ATTRIBUTE X_INTERFACE_INFO of MEMIF_Mem2Hwt_In_Full:   SIGNAL is "cs.upb.de:reconos:FIFO_M:1.0 MEMIF_Mem2Hwt_In FIFO_M_Full";
+	ATTRIBUTE X_INTERFACE_INFO of MEMIF_Mem2Hwt_In_WE:     SIGNAL is "cs.upb.de:reconos:FIFO_M:1.0 MEMIF_Mem2Hwt_In FIFO_M_WE";
+
+	ATTRIBUTE X_INTERFACE_INFO of MEMIF_Mem2Hwt_Out_Data:  SIGNAL is "cs.upb.de:reconos:FIFO_M:1.0 MEMIF_Mem2Hwt_Out FIFO_M_Data";
+	ATTRIBUTE X_INTERFACE_INFO of MEMIF_Mem2Hwt_Out_Full:  SIGNAL is "cs.upb.de:reconos:FIFO_M:1.0 MEMIF_Mem2Hwt_Out FIFO_M_Full";
+	ATTRIBUTE X_INTERFACE_INFO of MEMIF_Mem2Hwt_Out_WE:    SIGNAL is "cs.upb.de:reconos:FIFO_M:1.0 MEMIF_Mem2Hwt_Out FIFO_M_WE";
+
+	ATTRIBUTE X_INTERFACE_INFO of MEMIF_Hwt2Mem_Out_Data:  SIGNAL is "cs.upb.de:reconos:FIFO_S:1.0 MEMIF_Hwt2Mem_Out FIFO_S_Data";
+	ATTRIBUTE X_INTERFACE_INFO of MEMIF_Hwt2Mem_Out_Empty: SIGNAL is "cs.upb.de:reconos:FIFO_S:1.0 MEMIF_Hwt2Mem_Out FIFO_S_Empty";
+	ATTRIBUTE X_INTERFACE_INFO of MEMIF_Hwt2Mem_Out_RE:    SIGNAL is "cs.upb.de:reconos:FIFO_S:1.0 MEMIF_Hwt2Mem_Out FIFO_S_RE";
+
+	--
+	-- Internal constants
+	--
+	--   C_DATA_BYTES   - width of the memif in bytes
+	--   C_LINE_WORDS   - number of memif words per line
+	--   C_OFFSET_WIDTH - width of the offset of an address in a line
+	--   C_LINES        - total number of lines
+	--
+	constant C_DATA_BYTES   : integer := C_MEMIF_DATA_WIDTH / 8;
+	constant C_LINE_WORDS   : integer := C_CACHE_LINE_BYTES / C_DATA_BYTES;
+	constant C_OFFSET_WIDTH : integer := integer(ceil(log2(real(C_CACHE_LINE_BYTES))));
+	constant C_LINES        : integer := C_CACHE_SETS * C_CACHE_WAYS;
+
+	--
+	-- Internal state machine
+	--
+	--   state_type - vhdl type of the states
+	--   state      - instantiation of the state
+	--
+	type state_type is (STATE_CMD,STATE_ADDR,STATE_INV,STATE_LOOKUP,
+	                    STATE_FILL_CMD,STATE_FILL_ADDR,STATE_FILL_DATA,
+	                    STATE_HIT_RAM,STATE_HIT,
+	                    STATE_PASS_ADDR,STATE_PASS_LEN,STATE_PASS_DATA);
+	signal state : state_type := STATE_CMD;
+
+	--
+	-- Cache memories
+	--
+	--   tags   - line number (address without offset) of each line,
+	--            where the lines of set s are s * C_CACHE_WAYS + way
+	--   valid  - valid bit of each line
+	--   victim - way of each set to replace next
+	--   ram    - data of the lines
+	--
+	type tag_array_t is array (0 to C_LINES - 1) of unsigned(31 - C_OFFSET_WIDTH downto 0);
+	type victim_array_t is array (0 to C_CACHE_SETS - 1) of integer range 0 to C_CACHE_WAYS - 1;
+	type ram_t is array (0 to C_LINES * C_LINE_WORDS - 1) of std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
+
+	signal tags   : tag_array_t := (others => (others => '0'));
+	signal valid  : std_logic_vector(0 to C_LINES - 1) := (others => '0');
+	signal victim : victim_array_t := (others => 0);
+	signal ram    : ram_t;
+
+	--
+	-- Signals of the ram
+	--
+	--   ram_we, ram_waddr, ram_wdata - write port used to fill lines
+	--   ram_raddr, ram_rdata         - read port used to serve hits
+	--
+	signal ram_we    : std_logic;
+	signal ram_waddr : integer range 0 to C_LINES * C_LINE_WORDS - 1;
+	signal ram_wdata : std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
+	signal ram_raddr : integer range 0 to C_LINES * C_LINE_WORDS - 1;
+	signal ram_rdata : std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
+
+	--
+	-- Internal signals
+	--
+	--   own       - command at the head of the hwt2mem fifo is served by
+	--               the cache
+	--   req_addr  - address of the cached read
+	--   req_line  - line number of the cached read
+	--   req_set   - set of the cached read
+	--   req_word  - index of the requested memif word in the line
+	--   entry     - line serving the cached read
+	--   fill_word - index of the next memif word of a line fill
+	--
+	--   pass_op   - operation of the passed request
+	--   pass_addr - address of the next word of a passed write
+	--   pass_rem  - remaining bytes of a passed write
+	--   rd_rem    - bytes of passed reads not yet returned to the hwt
+	--
+	signal own       : std_logic;
+	signal req_addr  : unsigned(31 downto 0) := (others => '0');
+	signal req_line  : unsigned(31 - C_OFFSET_WIDTH downto 0);
+	signal req_set   : integer range 0 to C_CACHE_SETS - 1;
+	signal req_word  : integer range 0 to C_LINE_WORDS - 1;
+	signal entry     : integer range 0 to C_LINES - 1 := 0;
+	signal fill_word : integer range 0 to C_LINE_WORDS - 1 := 0;
+
+	signal pass_op   : std_logic_vector(C_MEMIF_OP_WIDTH - 1 downto 0) := (others => '0');
+	signal pass_addr : unsigned(31 downto 0) := (others => '0');
+	signal pass_rem  : unsigned(31 downto 0) := (others => '0');
+	signal rd_rem    : unsigned(31 downto 0) := (others => '0');
+
+	--
+	-- Signals for transfers on the memif
+	--
+	--   pass_rd  - word of a passed read is returned to the hwt
+	--   cmd_xfer - hwt2mem word is passed to the arbiter
+	--
+	signal pass_rd  : std_logic;
+	signal cmd_xfer : std_logic;
+begin
+
+	-- == Assignment of internal signals ==================================
+
+	own <= '1' when MEMIF_Hwt2Mem_In_Data(C_MEMIF_OP_RANGE) = MEMIF_CMD_READ_CACHED else
+	       '1' when MEMIF_Hwt2Mem_In_Data(C_MEMIF_OP_RANGE) = MEMIF_CMD_CACHE_INV else
+	       '0';
+
+	req_line <= req_addr(31 downto C_OFFSET_WIDTH);
+	req_set  <= to_integer(req_line mod C_CACHE_SETS);
+	req_word <= to_integer(req_addr(C_OFFSET_WIDTH - 1 downto 0)) / C_DATA_BYTES;
+
+	ram_raddr <= entry * C_LINE_WORDS + req_word;
+	ram_waddr <= entry * C_LINE_WORDS + fill_word;
+	ram_wdata <= MEMIF_Mem2Hwt_Out_Data;
+	ram_we    <= MEMIF_Mem2Hwt_Out_WE when state = STATE_FILL_DATA else '0';
+
+	pass_rd  <= '1' when rd_rem /= 0 and MEMIF_Mem2Hwt_Out_WE = '1' and MEMIF_Mem2Hwt_In_Full = '0' else '0';
+	cmd_xfer <= MEMIF_Hwt2Mem_Out_RE and not MEMIF_Hwt2Mem_In_Empty;
+
+
+	-- == Process definitions =============================================
+
+	--
+	-- Ram holding the data of the lines
+	--
+	mem : process(SYS_Clk) is
+	begin
+		if rising_edge(SYS_Clk) then
+			if ram_we = '1' then
+				ram(ram_waddr) <= ram_wdata;
+			end if;
+
+			ram_rdata <= ram(ram_raddr);
+		end if;
+	end process mem;
+
+	--
+	-- Serves cached reads and passes all other requests
+	--
+	--   Cached reads wait until the data of all passed reads is returned
+	--   to keep the order of the memif. Passed reads and writes are
+	--   followed to find the next command.
+	--
+	cache : process(SYS_Clk,SYS_Rst) is
+		variable hit : boolean;
+		variable rem_v : unsigned(31 downto 0);
+		variable set_v : integer range 0 to C_CACHE_SETS - 1;
+		variable e : integer range 0 to C_LINES - 1;
+	begin
+		if SYS_Rst = '1' then
+			valid <= (others => '0');
+			rd_rem <= (others => '0');
+
+			state <= STATE_CMD;
+		elsif rising_edge(SYS_Clk) then
+			rem_v := rd_rem;
+			if pass_rd = '1' then
+				rem_v := rem_v - C_DATA_BYTES;
+			end if;
+
+			case state is
+				when STATE_CMD =>
+					if MEMIF_Hwt2Mem_In_Empty = '0' and own = '1' then
+						if MEMIF_Hwt2Mem_In_Data(C_MEMIF_OP_RANGE) = MEMIF_CMD_CACHE_INV then
+							state <= STATE_INV;
+						else
+							state <= STATE_ADDR;
+						end if;
+					elsif cmd_xfer = '1' then
+						pass_op <= MEMIF_Hwt2Mem_In_Data(C_MEMIF_OP_RANGE);
+						pass_rem <= resize(unsigned(MEMIF_Hwt2Mem_In_Data(C_MEMIF_LENGTH_RANGE)), 32);
+
+						if     MEMIF_Hwt2Mem_In_Data(C_MEMIF_OP_RANGE) /= MEMIF_CMD_WRITE
+						   and MEMIF_Hwt2Mem_In_Data(C_MEMIF_OP_RANGE) /= MEMIF_CMD_READ_SG
+						   and MEMIF_Hwt2Mem_In_Data(C_MEMIF_OP_RANGE) /= MEMIF_CMD_WRITE_SG then
+							rem_v := rem_v + unsigned(MEMIF_Hwt2Mem_In_Data(C_MEMIF_LENGTH_RANGE));
+						end if;
+
+						state <= STATE_PASS_ADDR;
+					end if;
+
+				when STATE_INV =>
+					if MEMIF_Hwt2Mem_In_Empty = '0' then
+						valid <= (others => '0');
+
+						state <= STATE_CMD;
+					end if;
+
+				when STATE_ADDR =>
+					if MEMIF_Hwt2Mem_In_Empty = '0' then
+						req_addr <= unsigned(MEMIF_Hwt2Mem_In_Data(31 downto 0));
+
+						state <= STATE_LOOKUP;
+					end if;
+
+				when STATE_LOOKUP =>
+					if rd_rem = 0 then
+						hit := false;
+						for w in 0 to C_CACHE_WAYS - 1 loop
+							if valid(req_set * C_CACHE_WAYS + w) = '1' and tags(req_set * C_CACHE_WAYS + w) = req_line then
+								hit := true;
+								entry <= req_set * C_CACHE_WAYS + w;
+							end if;
+						end loop;
+
+						if hit then
+							state <= STATE_HIT_RAM;
+						else
+							e := req_set * C_CACHE_WAYS + victim(req_set);
+							entry <= e;
+							valid(e) <= '0';
+							tags(e) <= req_line;
+
+							state <= STATE_FILL_CMD;
+						end if;
+					end if;
+
+				when STATE_FILL_CMD =>
+					if MEMIF_Hwt2Mem_Out_RE = '1' then
+						state <= STATE_FILL_ADDR;
+					end if;
+
+				when STATE_FILL_ADDR =>
+					if MEMIF_Hwt2Mem_Out_RE = '1' then
+						fill_word <= 0;
+
+						state <= STATE_FILL_DATA;
+					end if;
+
+				when STATE_FILL_DATA =>
+					if MEMIF_Mem2Hwt_Out_WE = '1' then
+						if fill_word = C_LINE_WORDS - 1 then
+							valid(entry) <= '1';
+							victim(req_set) <= (victim(req_set) + 1) mod C_CACHE_WAYS;
+
+							state <= STATE_HIT_RAM;
+						else
+							fill_word <= fill_word + 1;
+						end if;
+					end if;
+
+				when STATE_HIT_RAM =>
+					state <= STATE_HIT;
+
+				when STATE_HIT =>
+					if MEMIF_Mem2Hwt_In_Full = '0' then
+						state <= STATE_CMD;
+					end if;
+
+				when STATE_PASS_ADDR =>
+					if cmd_xfer = '1' then
+						pass_addr <= unsigned(MEMIF_Hwt2Mem_In_Data(31 downto 0));
+
+						if pass_op = MEMIF_CMD_READ_SG or pass_op = MEMIF_CMD_WRITE_SG then
+							state <= STATE_PASS_LEN;
+						elsif pass_op = MEMIF_CMD_WRITE and pass_rem /= 0 then
+							state <= STATE_PASS_DATA;
+						else
+							state <= STATE_CMD;
+						end if;
+					end if;
+
+				-- the addresses of scatter-gather writes are not known,
+				-- so that the whole cache is invalidated
+				when STATE_PASS_LEN =>
+					if cmd_xfer = '1' then
+						pass_rem <= unsigned(MEMIF_Hwt2Mem_In_Data(31 downto 0));
+
+						if pass_op = MEMIF_CMD_READ_SG then
+							rem_v := rem_v + unsigned(MEMIF_Hwt2Mem_In_Data(31 downto 0));
+
+							state <= STATE_CMD;
+						else
+							valid <= (others => '0');
+
+							if unsigned(MEMIF_Hwt2Mem_In_Data(31 downto 0)) /= 0 then
+								state <= STATE_PASS_DATA;
+							else
+								state <= STATE_CMD;
+							end if;
+						end if;
+					end if;
+
+				when STATE_PASS_DATA =>
+					if cmd_xfer = '1' then
+						if pass_op = MEMIF_CMD_WRITE then
+							set_v := to_integer(pass_addr(31 downto C_OFFSET_WIDTH) mod C_CACHE_SETS);
+							for w in 0 to C_CACHE_WAYS - 1 loop
+								if tags(set_v * C_CACHE_WAYS + w) = pass_addr(31 downto C_OFFSET_WIDTH) then
+									valid(set_v * C_CACHE_WAYS + w) <= '0';
+								end if;
+							end loop;
+						end if;
+
+						pass_addr <= pass_addr + C_DATA_BYTES;
+						pass_rem <= pass_rem - C_DATA_BYTES;
+
+						if pass_rem - C_DATA_BYTES = 0 then
+							state <= STATE_CMD;
+						end if;
+					end if;
+
+				when others =>
+			end case;
+
+			rd_rem <= rem_v;
+		end if;
+	end process cache;
+
+
+	-- == Multiplexing signals ============================================
+
+	MEMIF_Hwt2Mem_In_RE <= (MEMIF_Hwt2Mem_Out_RE and not own) or (not MEMIF_Hwt2Mem_In_Empty and own)
+	                                                   when state = STATE_CMD else
+	                       MEMIF_Hwt2Mem_Out_RE when state = STATE_PASS_ADDR else
+	                       MEMIF_Hwt2Mem_Out_RE when state = STATE_PASS_LEN else
+	                       MEMIF_Hwt2Mem_Out_RE when state = STATE_PASS_DATA else
+	                       not MEMIF_Hwt2Mem_In_Empty when state = STATE_ADDR else
+	                       not MEMIF_Hwt2Mem_In_Empty when state = STATE_INV else
+	                       '0';
+
+	MEMIF_Hwt2Mem_Out_Data  <= memif_word(MEMIF_CMD_READ & std_logic_vector(to_unsigned(C_CACHE_LINE_BYTES, C_MEMIF_LENGTH_WIDTH)))
+	                                                    when state = STATE_FILL_CMD else
+	                           memif_word(std_logic_vector(req_line & to_unsigned(0, C_OFFSET_WIDTH)))
+	                                                    when state = STATE_FILL_ADDR else
+	                           MEMIF_Hwt2Mem_In_Data;
+	MEMIF_Hwt2Mem_Out_Empty <= MEMIF_Hwt2Mem_In_Empty or own when state = STATE_CMD else
+	                           MEMIF_Hwt2Mem_In_Empty    when state = STATE_PASS_ADDR else
+	                           MEMIF_Hwt2Mem_In_Empty    when state = STATE_PASS_LEN else
+	                           MEMIF_Hwt2Mem_In_Empty    when state = STATE_PASS_DATA else
+	                           '0'                       when state = STATE_FILL_CMD else
+	                           '0'                       when state = STATE_FILL_ADDR else
+	                           '1';
+
+	MEMIF_Mem2Hwt_In_Data  <= ram_rdata when state = STATE_HIT else
+	                          MEMIF_Mem2Hwt_Out_Data;
+	MEMIF_Mem2Hwt_In_WE    <= '1' when state = STATE_HIT else
+	                          MEMIF_Mem2Hwt_Out_WE when rd_rem /= 0 else
+	                          '0';
+	MEMIF_Mem2Hwt_Out_Full <= MEMIF_Mem2Hwt_In_Full when rd_rem /= 0 else
+	                          '0' when state = STATE_FILL_DATA else
+	                          '1';
+
+end architecture imp;
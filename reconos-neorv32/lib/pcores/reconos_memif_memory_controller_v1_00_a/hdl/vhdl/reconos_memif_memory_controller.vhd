@@ -34,7 +34,14 @@ entity reconos_memif_memory_controller is
 	--
 	--   C_MAX_BURST_LEN - maximal allowed burst length
 	--
-	--   C_MEMIF_DATA_WIDTH - width of the memif
+	--   C_MEMIF_DATA_WIDTH - width of the memif, also used as native
+	--                        data width of the ipif (C_M_AXI_DATA_WIDTH
+	--                        must not be smaller)
+	--
+	--   C_PREFETCH - receive the next request during a read, which must
+	--                be disabled if the requests are passed through a
+	--                component forwarding the read enable during the
+	--                data of a request, like the mmu
 	--
 	generic (
 		C_M_AXI_ADDR_WIDTH : integer := 32;
@@ -42,7 +49,9 @@ entity reconos_memif_memory_controller is
 
 		C_MAX_BURST_LEN : integer := 64;
 
-		C_MEMIF_DATA_WIDTH : integer := 32
+		C_MEMIF_DATA_WIDTH : integer := 32;
+
+		C_PREFETCH : integer := 1
 	);
 
 	--
@@ -126,7 +135,7 @@ architecture imp of reconos_memif_memory_controller is
 	signal bus2ip_clk             : std_logic;
 	signal bus2ip_resetn          : std_logic;
 	signal ip2bus_mst_addr        : std_logic_vector(31 downto 0);
-	signal ip2bus_mst_be          : std_logic_vector(3 downto 0);
+	signal ip2bus_mst_be          : std_logic_vector(C_MEMIF_DATA_WIDTH / 8 - 1 downto 0);
 	signal ip2bus_mst_length      : std_logic_vector(11 downto 0);
 	signal ip2bus_mst_type        : std_logic;
 	signal ip2bus_mst_lock        : std_logic;
@@ -135,8 +144,8 @@ architecture imp of reconos_memif_memory_controller is
 	signal bus2ip_mst_cmplt       : std_logic;
 	signal bus2ip_mst_error       : std_logic;
 	signal ip2bus_mstrd_req       : std_logic;
-	signal bus2ip_mstrd_d         : std_logic_vector(31 downto 0);
-	signal bus2ip_mstrd_rem       : std_logic_vector(3 downto 0);
+	signal bus2ip_mstrd_d         : std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
+	signal bus2ip_mstrd_rem       : std_logic_vector(C_MEMIF_DATA_WIDTH / 8 - 1 downto 0);
 	signal bus2ip_mstrd_sof_n     : std_logic;
 	signal bus2ip_mstrd_eof_n     : std_logic;
 	signal bus2ip_mstrd_src_rdy_n : std_logic;
@@ -144,8 +153,8 @@ architecture imp of reconos_memif_memory_controller is
 	signal ip2bus_mstrd_dst_rdy_n : std_logic;
 	signal ip2bus_mstrd_dst_dsc_n : std_logic;
 	signal ip2bus_mstwr_req       : std_logic;
-	signal ip2bus_mstwr_d         : std_logic_vector(31 downto 0);
-	signal ip2bus_mstwr_rem       : std_logic_vector(3 downto 0);
+	signal ip2bus_mstwr_d         : std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
+	signal ip2bus_mstwr_rem       : std_logic_vector(C_MEMIF_DATA_WIDTH / 8 - 1 downto 0);
 	signal ip2bus_mstwr_sof_n     : std_logic;
 	signal ip2bus_mstwr_eof_n     : std_logic;
 	signal ip2bus_mstwr_src_rdy_n : std_logic;
@@ -153,11 +162,11 @@ architecture imp of reconos_memif_memory_controller is
 	signal bus2ip_mstwr_dst_rdy_n : std_logic;
 	signal bus2ip_mstwr_dst_dsc_n : std_logic;
 
-	signal MEMIF_Hwt2Mem_In_Data_d  : std_logic_vector(31 downto 0);
+	signal MEMIF_Hwt2Mem_In_Data_d  : std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
 	signal MEMIF_Hwt2Mem_In_Empty_d : std_logic;
 	signal MEMIF_Hwt2Mem_In_RE_d    : std_logic;
 
-	signal MEMIF_Mem2Hwt_In_Data_d  : std_logic_vector(31 downto 0);
+	signal MEMIF_Mem2Hwt_In_Data_d  : std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
 	signal MEMIF_Mem2Hwt_In_Full_d  : std_logic;
 	signal MEMIF_Mem2Hwt_In_WE_d    : std_logic;
 begin
@@ -179,10 +188,10 @@ begin
 	MEMIF_Mem2Hwt_In_Full_d  <= MEMIF_Mem2Hwt_In_Full;
 	MEMIF_Mem2Hwt_In_WE      <= MEMIF_Mem2Hwt_In_WE_d;
 
-	DEBUG(67 downto 36) <= MEMIF_Hwt2Mem_In_Data_d;
+	DEBUG(67 downto 36) <= MEMIF_Hwt2Mem_In_Data_d(31 downto 0);
 	DEBUG(35) <= MEMIF_Hwt2Mem_In_Empty_d;
 	DEBUG(34) <= MEMIF_Hwt2Mem_In_RE_d;
-	DEBUG(33 downto 2) <= MEMIF_Mem2Hwt_In_Data_d;
+	DEBUG(33 downto 2) <= MEMIF_Mem2Hwt_In_Data_d(31 downto 0);
 	DEBUG(1) <= MEMIF_Mem2Hwt_In_Full_d;
 	DEBUG(0) <= MEMIF_Mem2Hwt_In_WE_d;
 
@@ -201,7 +210,9 @@ begin
 			C_M_AXI_ADDR_WIDTH => C_M_AXI_ADDR_WIDTH,
 			C_M_AXI_DATA_WIDTH => C_M_AXI_DATA_WIDTH,
 
-			C_MAX_BURST_LEN => C_MAX_BURST_LEN
+			C_MAX_BURST_LEN => C_MAX_BURST_LEN,
+
+			C_NATIVE_DATA_WIDTH => C_MEMIF_DATA_WIDTH
 		)
 
 		port map (
@@ -271,6 +282,10 @@ begin
 	--   controller.
 	--
 	ul : entity work.reconos_memif_memory_controller_user_logic
+		generic map (
+			C_PREFETCH => C_PREFETCH
+		)
+
 		port map (
 			MEMIF_Hwt2Mem_In_Data  => MEMIF_Hwt2Mem_In_Data_d,
 			MEMIF_Hwt2Mem_In_Empty => MEMIF_Hwt2Mem_In_Empty_d,
@@ -11,7 +11,12 @@
 --   project:      ReconOS
 --   author:       Christoph Rüthing, University of Paderborn
 --   description:  A memory controller connecting the memory fifos with
---                 the axi bus of the system.
+--                 the axi bus of the system. Requests longer than a
+--                 single ipif command are split into several bursts.
+--                 The command and address of the next request are
+--                 already received while the data of a read is
+--                 transferred, to start its first burst right after
+--                 the current one, unless disabled by C_PREFETCH.
 --
 -- ======================================================================
 
@@ -25,6 +30,15 @@ library reconos_v3_01_a;
 use reconos_v3_01_a.reconos_pkg.all;
 
 entity reconos_memif_memory_controller_user_logic is
+	--
+	-- Generic definitions
+	--
+	--   C_PREFETCH - receive the next request during a read
+	--
+	generic (
+		C_PREFETCH : integer := 1
+	);
+
 	--
 	-- Port definitions
 	--
@@ -44,7 +58,7 @@ entity reconos_memif_memory_controller_user_logic is
 		BUS2IP_Clk             : in  std_logic;
 		BUS2IP_Resetn          : in  std_logic;
 		IP2BUS_Mst_Addr        : out std_logic_vector(31 downto 0);
-		IP2BUS_Mst_BE          : out std_logic_vector(3 downto 0);
+		IP2BUS_Mst_BE          : out std_logic_vector(C_MEMIF_DATA_WIDTH / 8 - 1 downto 0);
 		IP2BUS_Mst_Length      : out std_logic_vector(11 downto 0);
 		IP2BUS_Mst_Type        : out std_logic;
 		IP2BUS_Mst_Lock        : out std_logic;
@@ -53,8 +67,8 @@ entity reconos_memif_memory_controller_user_logic is
 		BUS2IP_Mst_Cmplt       : in  std_logic;
 		BUS2IP_Mst_Error       : in  std_logic;
 		IP2BUS_MstRd_Req       : out std_logic;
-		BUS2IP_MstRd_D         : in  std_logic_vector(31 downto 0);
-		BUS2IP_MstRd_Rem       : in  std_logic_vector(3 downto 0);
+		BUS2IP_MstRd_D         : in  std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
+		BUS2IP_MstRd_Rem       : in  std_logic_vector(C_MEMIF_DATA_WIDTH / 8 - 1 downto 0);
 		BUS2IP_MstRd_Sof_N     : in  std_logic;
 		BUS2IP_MstRd_Eof_N     : in  std_logic;
 		BUS2IP_MstRd_Src_Rdy_N : in  std_logic;
@@ -62,8 +76,8 @@ entity reconos_memif_memory_controller_user_logic is
 		IP2BUS_MstRd_Dst_Rdy_N : out std_logic;
 		IP2BUS_MstRd_Dst_Dsc_N : out std_logic;
 		IP2BUS_MstWr_Req       : out std_logic;
-		IP2BUS_MstWr_D         : out std_logic_vector(31 downto 0);
-		IP2BUS_MstWr_Rem       : out std_logic_vector(3 downto 0);
+		IP2BUS_MstWr_D         : out std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
+		IP2BUS_MstWr_Rem       : out std_logic_vector(C_MEMIF_DATA_WIDTH / 8 - 1 downto 0);
 		IP2BUS_MstWr_Sof_N     : out std_logic;
 		IP2BUS_MstWr_Eof_N     : out std_logic;
 		IP2BUS_MstWr_Src_Rdy_N : out std_logic;
@@ -81,7 +95,7 @@ architecture imp of reconos_memif_memory_controller_user_logic is
 	--   state_type - vhdl type of the states
 	--   state      - instantiation of the state
 	--
-	type state_type is (STATE_READ_CMD,STATE_READ_ADDR,
+	type state_type is (STATE_READ_CMD,STATE_READ_ADDR,STATE_BURST,
 	                    STATE_PROCESS_WRITE_0,STATE_PROCESS_WRITE_1,
 	                    STATE_PROCESS_READ_0,STATE_PROCESS_READ_1,
 	                    STATE_CMPLT);
@@ -90,17 +104,37 @@ architecture imp of reconos_memif_memory_controller_user_logic is
 	--
 	-- Internal signals
 	--
-	--   mem_addr - received address from hwt
+	--   mem_addr - received address from hwt (lower bits of the memif word)
 	--
 	--   mem_op     - operation to perform
-	--   mem_length - number of bytes to transfer
-	--   mem_count  - counter of transferred bytes
+	--   mem_length - number of bytes to transfer in current burst
+	--   mem_count  - counter of transferred bytes in current burst, which
+	--                is decremented by one memif word per beat
+	--   mem_remm   - number of bytes remaining after current burst
+	--
+	--   C_BURST_BYTES - maximum length of a single ipif command, bursts
+	--                   never cross a border aligned to this size
 	--
-	signal mem_addr : std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0) := (others => '0');
+	--   nxt_cmd  - received command of the next request
+	--   nxt_addr - received address of the next request
+	--   nxt_word - number of received words of the next request
+	--   nxt_re   - the fifo holds the next request, since the data of
+	--              the current request is completely transferred or
+	--              flows in the opposite direction
+	--
+	signal mem_addr : std_logic_vector(C_MEMIF_CMD_WIDTH - 1 downto 0) := (others => '0');
 
 	signal mem_op     : std_logic_vector(C_MEMIF_OP_WIDTH - 1 downto 0) := (others => '0');
 	signal mem_length : unsigned(C_MEMIF_LENGTH_WIDTH - 1 downto 0) := (others => '0');
 	signal mem_count  : unsigned(C_MEMIF_LENGTH_WIDTH - 1 downto 0) := (others => '0');
+	signal mem_remm   : unsigned(C_MEMIF_LENGTH_WIDTH - 1 downto 0) := (others => '0');
+
+	constant C_BURST_BYTES : integer := 2048;
+
+	signal nxt_cmd  : std_logic_vector(C_MEMIF_CMD_WIDTH - 1 downto 0) := (others => '0');
+	signal nxt_addr : std_logic_vector(C_MEMIF_CMD_WIDTH - 1 downto 0) := (others => '0');
+	signal nxt_word : integer range 0 to 2 := 0;
+	signal nxt_re   : std_logic;
 
 	signal rd_req, wr_req : std_logic;
 
@@ -127,36 +161,77 @@ begin
 	--   writes data form the memif fifo the the memory.
 	--
 	rdwr : process(BUS2IP_Clk,BUS2IP_Resetn) is
+		variable to_border : unsigned(C_MEMIF_LENGTH_WIDTH - 1 downto 0);
 	begin
 		if BUS2IP_Resetn = '0' then
+			nxt_word <= 0;
+
 			state <= STATE_READ_CMD;
 		elsif rising_edge(BUS2IP_Clk) then
+			if nxt_re = '1' and MEMIF_Hwt2Mem_In_Empty = '0' then
+				if nxt_word = 0 then
+					nxt_cmd <= MEMIF_Hwt2Mem_In_Data(C_MEMIF_CMD_WIDTH - 1 downto 0);
+				else
+					nxt_addr <= MEMIF_Hwt2Mem_In_Data(C_MEMIF_CMD_WIDTH - 1 downto 0);
+				end if;
+
+				nxt_word <= nxt_word + 1;
+			end if;
+
 			case state is
 				when STATE_READ_CMD =>
-					if MEMIF_Hwt2Mem_In_Empty = '0' then
-						mem_op <= MEMIF_Hwt2Mem_In_Data(C_MEMIF_OP_RANGE);
-						mem_length <= unsigned(MEMIF_Hwt2Mem_In_Data(C_MEMIF_LENGTH_RANGE));
+					if nxt_word = 2 then
+						mem_op <= nxt_cmd(C_MEMIF_OP_RANGE);
+						mem_remm <= unsigned(nxt_cmd(C_MEMIF_LENGTH_RANGE));
+						mem_addr <= nxt_addr;
+						nxt_word <= 0;
+
+						state <= STATE_BURST;
+					elsif nxt_word = 1 then
+						mem_op <= nxt_cmd(C_MEMIF_OP_RANGE);
+						mem_remm <= unsigned(nxt_cmd(C_MEMIF_LENGTH_RANGE));
+						nxt_word <= 0;
 
-						mem_count <= unsigned(MEMIF_Hwt2Mem_In_Data(C_MEMIF_LENGTH_RANGE));
+						state <= STATE_READ_ADDR;
+					elsif MEMIF_Hwt2Mem_In_Empty = '0' then
+						mem_op <= MEMIF_Hwt2Mem_In_Data(C_MEMIF_OP_RANGE);
+						mem_remm <= unsigned(MEMIF_Hwt2Mem_In_Data(C_MEMIF_LENGTH_RANGE));
 
 						state <= STATE_READ_ADDR;
 					end if;
 
 				when STATE_READ_ADDR =>
 					if MEMIF_Hwt2Mem_In_Empty = '0' then
-						mem_addr <= MEMIF_Hwt2Mem_In_Data;
-
-						case mem_op is
-							when MEMIF_CMD_READ =>
-								state <= STATE_PROCESS_READ_0;
+						mem_addr <= MEMIF_Hwt2Mem_In_Data(C_MEMIF_CMD_WIDTH - 1 downto 0);
 
-							when MEMIF_CMD_WRITE =>
-								state <= STATE_PROCESS_WRITE_0;
+						state <= STATE_BURST;
+					end if;
 
-							when others =>
-						end case;
+				when STATE_BURST =>
+					to_border := to_unsigned(C_BURST_BYTES, C_MEMIF_LENGTH_WIDTH)
+					             - unsigned(mem_addr(10 downto 0));
+
+					if mem_remm < to_border then
+						mem_length <= mem_remm;
+						mem_count <= mem_remm;
+						mem_remm <= (others => '0');
+					else
+						mem_length <= to_border;
+						mem_count <= to_border;
+						mem_remm <= mem_remm - to_border;
 					end if;
 
+					case mem_op is
+						when MEMIF_CMD_READ =>
+							state <= STATE_PROCESS_READ_0;
+
+						when MEMIF_CMD_WRITE =>
+							state <= STATE_PROCESS_WRITE_0;
+
+						when others =>
+							state <= STATE_READ_CMD;
+					end case;
+
 				when STATE_PROCESS_WRITE_0 =>
 					if BUS2IP_Mst_CmdAck = '1' then
 						state <= STATE_PROCESS_WRITE_1;
@@ -164,9 +239,9 @@ begin
 
 				when STATE_PROCESS_WRITE_1 =>
 					if BUS2IP_MstWr_Dst_Rdy_N = '0' and MEMIF_Hwt2Mem_In_Empty = '0' then
-						mem_count <= mem_count - 4;
+						mem_count <= mem_count - C_MEMIF_DATA_BYTES;
 
-						if mem_count - 4 = 0 then
+						if mem_count - C_MEMIF_DATA_BYTES = 0 then
 							state <= STATE_CMPLT;
 						end if;
 					end if;
@@ -178,16 +253,29 @@ begin
 
 				when STATE_PROCESS_READ_1 =>
 					if BUS2IP_MstRd_Src_Rdy_N = '0' and MEMIF_Mem2Hwt_In_Full = '0' then
-						mem_count <= mem_count - 4;
+						mem_count <= mem_count - C_MEMIF_DATA_BYTES;
 
-						if mem_count - 4 = 0 then
+						if mem_count - C_MEMIF_DATA_BYTES = 0 then
 							state <= STATE_CMPLT;
 						end if;
 					end if;
 
 				when STATE_CMPLT =>
 					if BUS2IP_Mst_Cmplt = '1' then
-						state <= STATE_READ_CMD;
+						if mem_remm = 0 and nxt_word = 2 then
+							mem_op <= nxt_cmd(C_MEMIF_OP_RANGE);
+							mem_remm <= unsigned(nxt_cmd(C_MEMIF_LENGTH_RANGE));
+							mem_addr <= nxt_addr;
+							nxt_word <= 0;
+
+							state <= STATE_BURST;
+						elsif mem_remm = 0 then
+							state <= STATE_READ_CMD;
+						else
+							mem_addr <= std_logic_vector(unsigned(mem_addr) + mem_length);
+
+							state <= STATE_BURST;
+						end if;
 					end if;
 
 				when others =>
@@ -198,6 +286,15 @@ begin
 
 	-- == Multiplexing signals ============================================
 
+	nxt_re <= '0' when C_PREFETCH = 0 else
+	          '0' when nxt_word = 2 else
+	          '1' when mem_op = MEMIF_CMD_READ and state = STATE_BURST else
+	          '1' when mem_op = MEMIF_CMD_READ and state = STATE_PROCESS_READ_0 else
+	          '1' when mem_op = MEMIF_CMD_READ and state = STATE_PROCESS_READ_1 else
+	          '1' when mem_op = MEMIF_CMD_READ and state = STATE_CMPLT else
+	          '1' when mem_remm = 0 and state = STATE_CMPLT else
+	          '0';
+
 	IP2Bus_Mst_Addr   <= mem_addr;
 	IP2BUS_Mst_Length <= std_logic_vector(mem_length(11 downto 0));
 
@@ -208,12 +305,12 @@ begin
 	IP2BUS_MstWr_Req       <= '1' when state = STATE_PROCESS_WRITE_0 else '0';
 	IP2BUS_MstWr_Src_Rdy_N <= MEMIF_Hwt2Mem_In_Empty when state = STATE_PROCESS_WRITE_1 else '1';
 	IP2BUS_MstWr_Sof_N     <= '0' when mem_count = mem_length else '1';
-	IP2BUS_MstWr_Eof_N     <= '0' when mem_count - 4 = 0 else '1';
+	IP2BUS_MstWr_Eof_N     <= '0' when mem_count - C_MEMIF_DATA_BYTES = 0 else '1';
 
 	MEMIF_Hwt2Mem_In_RE <= not BUS2IP_MstWr_Dst_Rdy_N when state = STATE_PROCESS_WRITE_1 else
-	                       '1'                        when state = STATE_READ_CMD else
+	                       '1'                        when state = STATE_READ_CMD and nxt_word = 0 else
 	                       '1'                        when state = STATE_READ_ADDR else
-	                       '0';
+	                       nxt_re;
 
 	MEMIF_Mem2Hwt_In_Data <= BUS2IP_MstRd_D;
 	MEMIF_Mem2Hwt_In_WE   <= not BUS2IP_MstRd_Src_Rdy_N when state = STATE_PROCESS_READ_1 else '0';
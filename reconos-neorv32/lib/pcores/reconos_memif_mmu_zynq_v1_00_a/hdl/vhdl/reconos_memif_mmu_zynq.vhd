@@ -13,7 +13,9 @@
 --   description:  The memory management unit enables virtual address
 --                 support. Therefore, it performs page table walks,
 --                 manages a TLB for faster translation and handles
---                 page fault via the proc control unit.
+--                 page fault via the proc control unit. Besides small
+--                 pages, 1 MB sections and 16 MB supersections are
+--                 resolved directly from the l1 descriptor.
 --
 -- ======================================================================
 
@@ -49,6 +51,8 @@ entity reconos_memif_mmu_zynq is
 	--   MMU_Fault_Addr - fault address of page fault
 	--   MMU_Retry      - retry signal after page fault processed
 	--   MMU_Pgd        - base address of l1 page table
+	--   MMU_Tlb_Hit    - pulse on every tlb hit
+	--   MMU_Tlb_Miss   - pulse on every tlb miss
 	--
 	--   SYS_Clk - system clock
 	--   SYS_Rst - system reset
@@ -74,6 +78,8 @@ entity reconos_memif_mmu_zynq is
 		MMU_Fault_Addr : out std_logic_vector(31 downto 0);
 		MMU_Retry      : in  std_logic;
 		MMU_Pgd        : in  std_logic_vector(31 downto 0);
+		MMU_Tlb_Hit    : out std_logic;
+		MMU_Tlb_Miss   : out std_logic;
 
 		SYS_Clk : in std_logic;
 		SYS_Rst : in std_logic
@@ -141,6 +147,9 @@ architecture imp of reconos_memif_mmu_zynq is
 	--   l2_descr_addr   - address of l2 page table entry
 	--   small_page_addr - address of physical page
 	--   physical_addr   - translated physical address
+	--   section         - translation originates from a (super)section
+	--   descr           - page table entry selected from the memif word
+	--   descr_len       - length of a page table read (one memif word)
 	--
 	--   For detailed information of how the different addresses are
 	--   calculated, take a look into the technical reference manual.
@@ -151,6 +160,9 @@ architecture imp of reconos_memif_mmu_zynq is
 	signal l2_descr_addr   : std_logic_vector(31 downto 0);
 	signal small_page_addr : std_logic_vector(31 downto 12);
 	signal physical_addr   : std_logic_vector(31 downto 0);
+	signal section         : std_logic;
+	signal descr           : std_logic_vector(31 downto 0);
+	signal descr_len       : std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
 
 	--
 	-- Signals for the tlb
@@ -158,10 +170,12 @@ architecture imp of reconos_memif_mmu_zynq is
 	--   tlb_addr - data output of the physical page address
 	--   tlb_we   - write enable for the tlb
 	--   tlb_hit  - result of query
+	--   tlb_sec  - hit entry maps a section
 	--
 	signal tlb_addr : std_logic_vector(19 downto 0);
 	signal tlb_we   : std_logic;
 	signal tlb_hit  : std_logic;
+	signal tlb_sec  : std_logic;
 
 begin
 
@@ -172,6 +186,12 @@ begin
 	l2_descr_addr <= l2_table_addr(31 downto 10) & mem_addr(19 downto 12) & "00";
 	physical_addr <= small_page_addr(31 downto 12) & mem_addr(11 downto 0);
 
+	-- page table entries are read as one aligned memif word, which holds
+	-- the entry in the lane addressed by the descriptor address
+	descr_len <= std_logic_vector(to_unsigned(C_MEMIF_DATA_WIDTH / 8, C_MEMIF_DATA_WIDTH));
+	descr     <= memif_lane(MEMIF_Mem2Hwt_Out_Data, l1_descr_addr) when state = STATE_READ_L1_2 else
+	             memif_lane(MEMIF_Mem2Hwt_Out_Data, l2_descr_addr);
+
 
 	-- == Process definitions =============================================
 
@@ -204,7 +224,11 @@ begin
 
 				when STATE_TLB_READ =>
 					if tlb_hit = '1' then
-						small_page_addr <= tlb_addr;
+						if tlb_sec = '1' then
+							small_page_addr <= tlb_addr(19 downto 8) & mem_addr(19 downto 12);
+						else
+							small_page_addr <= tlb_addr;
+						end if;
 
 						state <= STATE_WRITE_CMD;
 					else
@@ -223,11 +247,27 @@ begin
 
 				when STATE_READ_L1_2 =>
 					if MEMIF_Mem2Hwt_Out_WE = '1' then
-						l2_table_addr <= MEMIF_Mem2Hwt_Out_Data(31 downto 10);
+						l2_table_addr <= descr(31 downto 10);
 
-						if MEMIF_Mem2Hwt_Out_Data(1 downto 0) = "00" then
+						if descr(1 downto 0) = "00" then
 							state <= STATE_PAGE_FAULT;
+						elsif descr(1 downto 0) = "10" then
+							-- bit 18 distinguishes supersections (16 MB)
+							-- from sections (1 MB), both skip the l2 walk
+							-- and are cached as 1 MB entries in the tlb
+							if descr(18) = '1' then
+								small_page_addr <= descr(31 downto 24) & mem_addr(23 downto 12);
+							else
+								small_page_addr <= descr(31 downto 20) & mem_addr(19 downto 12);
+							end if;
+
+							section <= '1';
+							tlb_we <= '1';
+
+							state <= STATE_TLB_WRITE;
 						else
+							section <= '0';
+
 							state <= STATE_READ_L2_0;
 						end if;
 					end if;
@@ -244,9 +284,9 @@ begin
 
 				when STATE_READ_L2_2 =>
 					if MEMIF_Mem2Hwt_Out_WE = '1' then
-						small_page_addr <= MEMIF_Mem2Hwt_Out_Data(31 downto 12);
+						small_page_addr <= descr(31 downto 12);
 
-						if MEMIF_Mem2Hwt_Out_Data(1 downto 0) = "00" then
+						if descr(1 downto 0) = "00" then
 							state <= STATE_PAGE_FAULT;
 						else
 							tlb_we <= '1';
@@ -273,9 +313,9 @@ begin
 				when STATE_PROCESS =>
 					if    (MEMIF_Hwt2Mem_Out_RE = '1' and MEMIF_Hwt2Mem_In_Empty = '0')
 					   or (MEMIF_Mem2Hwt_Out_WE = '1' and MEMIF_Mem2Hwt_In_Full = '0') then
-						mem_count <= mem_count - 4;
+						mem_count <= mem_count - C_MEMIF_DATA_WIDTH / 8;
 
-						if mem_count - 4 = 0 then
+						if mem_count - C_MEMIF_DATA_WIDTH / 8 = 0 then
 							state <= STATE_READ_CMD;
 						end if;
 					end if;
@@ -294,13 +334,16 @@ begin
 	-- == Multiplexing signals ============================================
 
 	MEMIF_Hwt2Mem_Out_Data  <= MEMIF_Hwt2Mem_In_Data when state = STATE_PROCESS else
-	                           x"00000004"           when state = STATE_READ_L1_0 else
-	                           l1_descr_addr         when state = STATE_READ_L1_1 else
-	                           x"00000004"           when state = STATE_READ_L2_0 else
-	                           l2_descr_addr         when state = STATE_READ_L2_1 else
+	                           descr_len             when state = STATE_READ_L1_0 else
+	                           std_logic_vector(resize(unsigned(memif_align(l1_descr_addr)), C_MEMIF_DATA_WIDTH))
+	                                                 when state = STATE_READ_L1_1 else
+	                           descr_len             when state = STATE_READ_L2_0 else
+	                           std_logic_vector(resize(unsigned(memif_align(l2_descr_addr)), C_MEMIF_DATA_WIDTH))
+	                                                 when state = STATE_READ_L2_1 else
 	                           mem_cmd               when state = STATE_WRITE_CMD else
-	                           physical_addr         when state = STATE_WRITE_ADDR else
-	                           x"00000000";
+	                           std_logic_vector(resize(unsigned(physical_addr), C_MEMIF_DATA_WIDTH))
+	                                                 when state = STATE_WRITE_ADDR else
+	                           (others => '0');
 
 	MEMIF_Hwt2Mem_Out_Empty <= MEMIF_Hwt2Mem_In_Empty when state = STATE_PROCESS else
 	                           '0'                    when state = STATE_READ_L1_0 else
@@ -324,7 +367,9 @@ begin
 	-- == Assigning mmu ports =============================================
 
 	MMU_Pgf <= '1' when state = STATE_PAGE_FAULT else '0';
-	MMU_Fault_Addr <= mem_addr;
+	MMU_Fault_Addr <= mem_addr(31 downto 0);
+	MMU_Tlb_Hit  <= '1' when state = STATE_TLB_READ and tlb_hit = '1' else '0';
+	MMU_Tlb_Miss <= '1' when state = STATE_TLB_READ and tlb_hit = '0' else '0';
 
 
 	-- == TLB =============================================================
@@ -342,6 +387,8 @@ begin
 				TLB_DO  => tlb_addr,
 				TLB_WE  => tlb_we,
 				TLB_Hit => tlb_hit,
+				TLB_SI  => section,
+				TLB_SO  => tlb_sec,
 				TLB_Clk => SYS_Clk,
 				TLB_Rst => SYS_Rst
 			);
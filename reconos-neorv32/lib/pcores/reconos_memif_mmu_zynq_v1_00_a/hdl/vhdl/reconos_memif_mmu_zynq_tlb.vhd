@@ -11,7 +11,9 @@
 --   project:      ReconOS
 --   author:       Christoph R??thing, University of Paderborn
 --   description:  The TLB (translation lookaside buffer) caches the last
---                 address translations for faster access.
+--                 address translations for faster access. Entries either
+--                 map a small page (full tag) or a section (only the
+--                 upper C_SECTION_TAG_SIZE bits of the tag are compared).
 --
 -- ======================================================================
 
@@ -28,7 +30,9 @@ entity reconos_memif_mmu_zynq_tlb is
 	generic (
 		C_TLB_SIZE  : integer := 128;
 		C_TAG_SIZE  : integer := 20;
-		C_DATA_SIZE : integer := 32
+		C_DATA_SIZE : integer := 32;
+
+		C_SECTION_TAG_SIZE : integer := 12
 	);
 	port (
 		-- TLB ports
@@ -37,6 +41,10 @@ entity reconos_memif_mmu_zynq_tlb is
 		TLB_DO  : out std_logic_vector(C_DATA_SIZE - 1 downto 0);
 		TLB_WE  : in  std_logic;
 		TLB_Hit : out std_logic;
+
+		-- section flag of written entry and of hit entry
+		TLB_SI  : in  std_logic;
+		TLB_SO  : out std_logic;
 		
 		TLB_Clk : in std_logic;
 		TLB_Rst : in std_logic
@@ -47,11 +55,13 @@ architecture implementation of reconos_memif_mmu_zynq_tlb is
 	
 	signal do  : std_logic_vector(C_DATA_SIZE - 1 downto 0);
 	signal hit : std_logic;
+	signal so  : std_logic;
 
 	type TAG_MEM_T  is array (0 to C_TLB_SIZE - 1) of std_logic_vector(C_TAG_SIZE - 1 downto 0);
 	type DATA_MEM_T  is array (0 to C_TLB_SIZE - 1) of std_logic_vector(C_DATA_SIZE - 1 downto 0);
 
 	signal valid    : std_logic_vector(0 to C_TLB_SIZE - 1);
+	signal section  : std_logic_vector(0 to C_TLB_SIZE - 1);
 	signal tag_mem  : TAG_MEM_T;
 	signal data_mem : DATA_MEM_T;
 	
@@ -63,6 +73,7 @@ begin
 
 	TLB_DO  <= do;
 	TLB_Hit <= hit;
+	TLB_SO  <= so;
 
 
 	write_proc : process(TLB_Clk,TLB_Rst) is
@@ -74,6 +85,7 @@ begin
 			if TLB_WE = '1' then
 				tag_mem(CONV_INTEGER(wrptr)) <= TLB_Tag;
 				data_mem(CONV_INTEGER(wrptr)) <= TLB_DI;
+				section(CONV_INTEGER(wrptr)) <= TLB_SI;
 				
 				valid(CONV_INTEGER(wrptr)) <= '1';
 				
@@ -83,15 +95,22 @@ begin
 	end process write_proc;
 
 
-	read_proc : process(TLB_Tag,data_mem,valid,tag_mem) is
+	read_proc : process(TLB_Tag,data_mem,valid,section,tag_mem) is
 	begin
 		hit <= '0';
+		so  <= '0';
 		do  <= (others => '0');
 
-		-- loop over all tlb entries and take the first hit
+		-- loop over all tlb entries and take the first hit, section
+		-- entries only compare the upper part of the tag
 		for i in 0 to C_TLB_SIZE - 1 loop
-			if valid(i) = '1' and tag_mem(i) = TLB_Tag then
+			if valid(i) = '1' and
+			   (tag_mem(i) = TLB_Tag or
+			    (section(i) = '1' and
+			     tag_mem(i)(C_TAG_SIZE - 1 downto C_TAG_SIZE - C_SECTION_TAG_SIZE) =
+			     TLB_Tag(C_TAG_SIZE - 1 downto C_TAG_SIZE - C_SECTION_TAG_SIZE))) then
 				hit <= '1';
+				so  <= section(i);
 				do  <= data_mem(i);
 				exit;
 			end if;
@@ -40,6 +40,10 @@ entity reconos_osif is
 	--
 	--   C_NUM_HWTS - number of hardware threads
 	--
+	--   C_OSIF_STRIDE - address distance between the registers of two
+	--                   osifs in bytes, a multiple of the page size
+	--                   allows to map each osif into user space separately
+	--
 	--   C_OSIF_DATA_WIDTH   - width of the osif
 	--   C_OSIF_LENGTH_WIDTH - width of the length in command word
 	--   C_OSIF_OP_WIDTH     - width of the operation in command word
@@ -53,6 +57,8 @@ entity reconos_osif is
 
 		C_NUM_HWTS : integer := 1;
 
+		C_OSIF_STRIDE : integer := 16;
+
 		C_OSIF_DATA_WIDTH   : integer := 32;
 		C_OSIF_LENGTH_WIDTH : integer := 24;
 		C_OSIF_OP_WIDTH     : integer := 8
@@ -146,8 +152,8 @@ architecture imp of reconos_osif is
 
 	constant C_ARD_ADDR_RANGE_ARRAY : SLV64_ARRAY_TYPE := (
 		<<generate for SLOTS>>
-		2 * <<_i>> + 0 => C_ADDR_PAD & std_logic_vector(unsigned(C_BASEADDR) + <<_i>> * 16),
-		2 * <<_i>> + 1 => C_ADDR_PAD & std_logic_vector(unsigned(C_BASEADDR) + <<_i>> * 16 + 15)<<c,>>
+		2 * <<_i>> + 0 => C_ADDR_PAD & std_logic_vector(unsigned(C_BASEADDR) + <<_i>> * C_OSIF_STRIDE),
+		2 * <<_i>> + 1 => C_ADDR_PAD & std_logic_vector(unsigned(C_BASEADDR) + <<_i>> * C_OSIF_STRIDE + 15)<<c,>>
 		<<end generate>>
 	);
 
@@ -29,6 +29,16 @@
 --                         | x , x-1, ... | x-32 , x-33, ... 0 |
 --                   Reg7: HWT signal - Write only
 --                         | x , x-1, ... | x-32 , x-33, ... 0 |
+--                   # performance counters (6 per HWT, after the HWT
+--                   # signal registers), write to clear
+--                   Reg8 + 6 * i + 0: bytes read by HWT i
+--                   Reg8 + 6 * i + 1: bytes written by HWT i
+--                   Reg8 + 6 * i + 2: memif stall cycles of HWT i
+--                   Reg8 + 6 * i + 3: TLB hits of HWT i
+--                   Reg8 + 6 * i + 4: TLB misses of HWT i
+--                   Reg8 + 6 * i + 5: page faults of HWT i
+--                   (Reg8 refers to the register after the last HWT
+--                    signal register)
 --
 --                   Page fault handling works the following:
 --                     1.) MMU raises MMU_Pgf
@@ -57,11 +67,12 @@ entity reconos_proc_control is
 	generic (
 		-- Proc Control paramters
 		C_NUM_HWTS   : integer   := 1;
+		C_MEMIF_DATA_WIDTH : integer := 32;
 	
 		-- Bus protocol parameters, do not add to or delete
 		C_S_AXI_DATA_WIDTH   : integer            := 32;
 		C_S_AXI_ADDR_WIDTH   : integer            := 32;
-		C_S_AXI_MIN_SIZE     : std_logic_vector   := X"000001FF";
+		C_S_AXI_MIN_SIZE     : std_logic_vector   := X"00000FFF";
 		C_USE_WSTRB          : integer            := 0;
 		C_DPHASE_TIMEOUT     : integer            := 8;
 		C_BASEADDR           : std_logic_vector   := X"FFFFFFFF";
@@ -90,6 +101,16 @@ entity reconos_proc_control is
 		MMU_Tlb_Hits         : in  std_logic_vector(31 downto 0) := X"00000000";
 		MMU_Tlb_Misses       : in  std_logic_vector(31 downto 0) := X"00000000";
 
+		-- These input ports are optional and only used in conjunction with the zynq mmu
+		MMU_Tlb_Hit          : in  std_logic := '0';
+		MMU_Tlb_Miss         : in  std_logic := '0';
+
+		-- Performance counter ports driven by the memif arbiter (optional)
+		PERF_Grant           : in  std_logic_vector(C_NUM_HWTS - 1 downto 0) := (others => '0');
+		PERF_Rd              : in  std_logic := '0';
+		PERF_Wr              : in  std_logic := '0';
+		PERF_Stall           : in  std_logic_vector(C_NUM_HWTS - 1 downto 0) := (others => '0');
+
 		-- Bus protocol ports, do not add to or delete
 		S_AXI_ACLK           : in  std_logic;
 		S_AXI_ARESETN        : in  std_logic;
@@ -148,7 +169,8 @@ architecture implementation of reconos_proc_control is
 		);
 
 	constant NUM_HWT_REGS : integer := ((C_NUM_HWTS - 1) / C_SLV_DWIDTH) + 1;
-	constant USER_SLV_NUM_REG   : integer   := NUM_HWT_REGS * 2 + 6;
+	constant NUM_PERF_REGS      : integer   := C_NUM_HWTS * 6;
+	constant USER_SLV_NUM_REG   : integer   := NUM_HWT_REGS * 2 + 6 + NUM_PERF_REGS;
 	constant USER_NUM_REG       : integer   := USER_SLV_NUM_REG;
 	constant TOTAL_IPIF_CE      : integer   := USER_NUM_REG;
 
@@ -241,6 +263,7 @@ begin
 		generic map (
 			-- Proc Control parameters
 			C_NUM_HWTS   => C_NUM_HWTS,
+			C_MEMIF_DATA_WIDTH => C_MEMIF_DATA_WIDTH,
 		
 			-- Bus protocol parameters
 			C_NUM_REG      => USER_NUM_REG,
@@ -260,6 +283,14 @@ begin
 			MMU_Pgd          => MMU_Pgd,
 			MMU_Tlb_Hits     => MMU_Tlb_Hits,
 			MMU_Tlb_Misses   => MMU_Tlb_Misses,
+			MMU_Tlb_Hit      => MMU_Tlb_Hit,
+			MMU_Tlb_Miss     => MMU_Tlb_Miss,
+
+			-- Performance counter ports
+			PERF_Grant       => PERF_Grant,
+			PERF_Rd          => PERF_Rd,
+			PERF_Wr          => PERF_Wr,
+			PERF_Stall       => PERF_Stall,
 
 		
 			-- Bus protocol ports
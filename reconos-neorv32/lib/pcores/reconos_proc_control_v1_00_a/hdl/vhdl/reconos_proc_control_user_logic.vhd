@@ -29,6 +29,16 @@
 --                         | x , x-1, ... | x-32 , x-33, ... 0 |
 --                   Reg7: HWT signal - Write only
 --                         | x , x-1, ... | x-32 , x-33, ... 0 |
+--                   # performance counters (6 per HWT, after the HWT
+--                   # signal registers), write to clear
+--                   Reg8 + 6 * i + 0: bytes read by HWT i
+--                   Reg8 + 6 * i + 1: bytes written by HWT i
+--                   Reg8 + 6 * i + 2: memif stall cycles of HWT i
+--                   Reg8 + 6 * i + 3: TLB hits of HWT i
+--                   Reg8 + 6 * i + 4: TLB misses of HWT i
+--                   Reg8 + 6 * i + 5: page faults of HWT i
+--                   (Reg8 refers to the register after the last HWT
+--                    signal register)
 --
 --                   Page fault handling works the following:
 --                     1.) MMU raises MMU_Pgf
@@ -53,6 +63,7 @@ entity reconos_proc_control_user_logic is
 	generic (
 		-- Proc Control parameters
 		C_NUM_HWTS     : integer := 1;
+		C_MEMIF_DATA_WIDTH : integer := 32;
 	
 		-- Bus protocol parameters
 		C_NUM_REG      : integer   := 1;
@@ -72,6 +83,14 @@ entity reconos_proc_control_user_logic is
 		MMU_Pgd          : out std_logic_vector(31 downto 0);
 		MMU_Tlb_Hits     : in  std_logic_vector(31 downto 0);
 		MMU_Tlb_Misses   : in  std_logic_vector(31 downto 0);
+		MMU_Tlb_Hit      : in  std_logic;
+		MMU_Tlb_Miss     : in  std_logic;
+
+		-- Performance counter ports
+		PERF_Grant       : in  std_logic_vector(C_NUM_HWTS - 1 downto 0);
+		PERF_Rd          : in  std_logic;
+		PERF_Wr          : in  std_logic;
+		PERF_Stall       : in  std_logic_vector(C_NUM_HWTS - 1 downto 0);
 
 		-- Bus protocol ports
 		Bus2IP_Clk       : in  std_logic;
@@ -90,7 +109,9 @@ end entity reconos_proc_control_user_logic;
 
 architecture imp of reconos_proc_control_user_logic is
 
-	constant NUM_HWT_REGS : integer := ((C_NUM_HWTS - 1) / C_SLV_DWIDTH) + 1;
+	constant NUM_HWT_REGS  : integer := ((C_NUM_HWTS - 1) / C_SLV_DWIDTH) + 1;
+	constant NUM_PERF      : integer := 6;
+	constant NUM_PERF_REGS : integer := C_NUM_HWTS * NUM_PERF;
 
 	type PGF_INT_STATE_TYPE is (WAIT_PGF, WAIT_CLEAR, WAIT_READY);
 	signal pgf_int_state : PGF_INT_STATE_TYPE;
@@ -103,6 +124,8 @@ architecture imp of reconos_proc_control_user_logic is
 	signal fault_addr          : std_logic_vector(31 downto 0);
 	signal tlb_hits            : std_logic_vector(31 downto 0);
 	signal tlb_misses          : std_logic_vector(31 downto 0);
+	signal tlb_hits_cnt        : std_logic_vector(31 downto 0);
+	signal tlb_misses_cnt      : std_logic_vector(31 downto 0);
 	signal sys_reset           : std_logic;
 	signal hwt_reset           : std_logic_vector(C_NUM_HWTS - 1 downto 0);
 	signal hwt_signal          : std_logic_vector(C_NUM_HWTS - 1 downto 0);
@@ -110,6 +133,11 @@ architecture imp of reconos_proc_control_user_logic is
 	signal hwt_reset_reg       : std_logic_vector(NUM_HWT_REGS * C_SLV_DWIDTH - 1 downto 0);
 	signal hwt_signal_reg      : std_logic_vector(NUM_HWT_REGS * C_SLV_DWIDTH - 1 downto 0);
 
+	type PERF_MEM_T is array (0 to NUM_PERF_REGS - 1) of std_logic_vector(31 downto 0);
+	signal perf                : PERF_MEM_T;
+	signal pgf_d               : std_logic;
+	signal perf_read           : std_logic_vector(31 downto 0);
+
 	-- Signals for user logic slave model s/w accessible register
 	signal slv_reg_write_sel   : std_logic_vector(C_NUM_REG - 1 downto 0);
 	signal slv_reg_read_sel    : std_logic_vector(C_NUM_REG - 1 downto 0);
@@ -140,8 +168,10 @@ begin
 
 	-- proc realted signals
 	fault_addr   <= MMU_Fault_Addr;
-	tlb_hits     <= MMU_Tlb_Hits;
-	tlb_misses   <= MMU_Tlb_Misses;
+	-- either the mmu counts itself (microblaze) or reports single
+	-- events (zynq), the unused inputs are tied to zero
+	tlb_hits     <= MMU_Tlb_Hits + tlb_hits_cnt;
+	tlb_misses   <= MMU_Tlb_Misses + tlb_misses_cnt;
 
 	PROC_Hwt_Rst <= hwt_reset;
 	PROC_Hwt_Signal <= hwt_signal;
@@ -195,7 +225,7 @@ begin
 			-- writing to hwt_reset
 			-- ignoring byte enable
 			for i in 0 to NUM_HWT_REGS - 1 loop
-				if slv_reg_write_sel(NUM_HWT_REGS * 2 - i - 1) = '1' then
+				if slv_reg_write_sel(NUM_PERF_REGS + NUM_HWT_REGS * 2 - i - 1) = '1' then
 					hwt_reset_reg(32 * i + 31 downto 32 * i) <= Bus2IP_Data;
 				end if;
 			end loop;
@@ -211,7 +241,7 @@ begin
 			-- writing to hwt_signal
 			-- ignoring byte enable
 			for i in 0 to NUM_HWT_REGS - 1 loop
-				if slv_reg_write_sel(NUM_HWT_REGS - i - 1) = '1' then
+				if slv_reg_write_sel(NUM_PERF_REGS + NUM_HWT_REGS - i - 1) = '1' then
 					hwt_signal_reg(32 * i + 31 downto 32 * i) <= Bus2IP_Data;
 				end if;
 			end loop;
@@ -262,7 +292,80 @@ begin
 	end process pgd_proc;
 
 
-	bus_reg_read_proc : process(slv_reg_read_sel) is
+	-- performance counters (for details see description above), the
+	-- memif events are assigned to the hwt currently granted by the
+	-- arbiter, since the mmu only serves one request at a time
+	perf_proc : process(clk,rst) is
+		variable base : integer;
+	begin
+		if rst = '1' or sys_reset = '1' then
+			perf <= (others => (others => '0'));
+			tlb_hits_cnt <= (others => '0');
+			tlb_misses_cnt <= (others => '0');
+			pgf_d <= '0';
+		elsif rising_edge(clk) then
+			pgf_d <= MMU_Pgf;
+
+			if MMU_Tlb_Hit = '1' then
+				tlb_hits_cnt <= tlb_hits_cnt + 1;
+			end if;
+
+			if MMU_Tlb_Miss = '1' then
+				tlb_misses_cnt <= tlb_misses_cnt + 1;
+			end if;
+
+			for i in 0 to C_NUM_HWTS - 1 loop
+				base := i * NUM_PERF;
+
+				if PERF_Grant(i) = '1' and PERF_Rd = '1' then
+					perf(base + 0) <= perf(base + 0) + C_MEMIF_DATA_WIDTH / 8;
+				end if;
+
+				if PERF_Grant(i) = '1' and PERF_Wr = '1' then
+					perf(base + 1) <= perf(base + 1) + C_MEMIF_DATA_WIDTH / 8;
+				end if;
+
+				if PERF_Stall(i) = '1' then
+					perf(base + 2) <= perf(base + 2) + 1;
+				end if;
+
+				if PERF_Grant(i) = '1' and MMU_Tlb_Hit = '1' then
+					perf(base + 3) <= perf(base + 3) + 1;
+				end if;
+
+				if PERF_Grant(i) = '1' and MMU_Tlb_Miss = '1' then
+					perf(base + 4) <= perf(base + 4) + 1;
+				end if;
+
+				if PERF_Grant(i) = '1' and MMU_Pgf = '1' and pgf_d = '0' then
+					perf(base + 5) <= perf(base + 5) + 1;
+				end if;
+
+				-- writing to a counter clears it
+				-- ignoring byte enable
+				for j in 0 to NUM_PERF - 1 loop
+					if slv_reg_write_sel(NUM_PERF_REGS - (base + j) - 1) = '1' then
+						perf(base + j) <= (others => '0');
+					end if;
+				end loop;
+			end loop;
+		end if;
+	end process perf_proc;
+
+
+	perf_read_proc : process(slv_reg_read_sel,perf) is
+	begin
+		perf_read <= (others => '0');
+
+		for i in 0 to NUM_PERF_REGS - 1 loop
+			if slv_reg_read_sel(NUM_PERF_REGS - i - 1) = '1' then
+				perf_read <= perf(i);
+			end if;
+		end loop;
+	end process perf_read_proc;
+
+
+	bus_reg_read_proc : process(slv_reg_read_sel,pgd,fault_addr,tlb_hits,tlb_misses,perf_read) is
 	begin
 		case slv_reg_read_sel(C_NUM_REG - 1 downto C_NUM_REG - 6) is
 			when "100000" => slv_ip2bus_data <= CONV_STD_LOGIC_VECTOR(C_NUM_HWTS, C_SLV_DWIDTH);
@@ -270,7 +373,7 @@ begin
 			when "001000" => slv_ip2bus_data <= fault_addr;
 			when "000100" => slv_ip2bus_data <= tlb_hits;
 			when "000010" => slv_ip2bus_data <= tlb_misses;
-			when others => slv_ip2bus_data <= (others => '0');
+			when others => slv_ip2bus_data <= perf_read;
 		end case;
 	end process bus_reg_read_proc;
 
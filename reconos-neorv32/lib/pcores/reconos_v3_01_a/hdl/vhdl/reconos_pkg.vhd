@@ -17,6 +17,8 @@
 --
 -- ======================================================================
 
+<<reconos_preproc>>
+
 library ieee;
 use ieee.std_logic_1164.all;
 use ieee.numeric_std.all;
@@ -29,9 +31,14 @@ package reconos_pkg is
 	-- General constants
 	--
 	--   C_OSIF_DATA_WIDTH  - width of the osif
-	--   C_MEMIF_DATA_WIDTH - width of the memif
-	--
-	--   C_MEMIF_CHUNK_WORDS  - size of one memory request in words
+	--   C_MEMIF_DATA_WIDTH - width of the memif (32, 64 or 128 bit as
+	--                        configured by MemifWidth in build.cfg)
+	--   C_MEMIF_DATA_BYTES - width of the memif in bytes, all requests
+	--                        must be aligned to this size
+	--   C_MEMIF_CMD_WIDTH  - width of the command and address words, which
+	--                        occupy the lower bits of a memif word
+	--
+	--   C_MEMIF_CHUNK_WORDS  - size of one memory request in 32 bit words
 	--                          (a request might be split up to meet this)
 	--   C_MEMIF_CHUNK_BYTES  - chunk size in bytes
 	--   C_MEMIF_CHUNK_WIDTH  - width of chunk (log2 C_MEMIF_CHUNK_BYTES)
@@ -39,7 +46,9 @@ package reconos_pkg is
 	--   C_MEMIF_OP_WIDTH     - width of the operation in command word
 	--
 	constant C_OSIF_DATA_WIDTH  : integer := 32;
-	constant C_MEMIF_DATA_WIDTH : integer := 32;
+	constant C_MEMIF_DATA_WIDTH : integer := <<MEMIF_DATA_WIDTH>>;
+	constant C_MEMIF_DATA_BYTES : integer := C_MEMIF_DATA_WIDTH / 8;
+	constant C_MEMIF_CMD_WIDTH  : integer := 32;
 
 	constant C_MEMIF_CHUNK_WORDS  : integer := 64;
 	constant C_MEMIF_CHUNK_BYTES  : integer := C_MEMIF_CHUNK_WORDS * 4;
@@ -55,7 +64,7 @@ package reconos_pkg is
 	--   C_MEMIF_CHUNK_RANGE  - range of chunk offset
 	--
 	subtype C_MEMIF_LENGTH_RANGE is natural range C_MEMIF_LENGTH_WIDTH - 1 downto 0;
-	subtype C_MEMIF_OP_RANGE is natural range C_MEMIF_DATA_WIDTH - 1 downto C_MEMIF_DATA_WIDTH - C_MEMIF_OP_WIDTH;
+	subtype C_MEMIF_OP_RANGE is natural range C_MEMIF_CMD_WIDTH - 1 downto C_MEMIF_CMD_WIDTH - C_MEMIF_OP_WIDTH;
 	subtype C_MEMIF_CHUNK_RANGE is natural range C_MEMIF_CHUNK_WIDTH - 1 downto 0;
 
 	--
@@ -91,10 +100,34 @@ package reconos_pkg is
 	--
 	-- Definition of memif commands
 	--
-	--   self-describing
+	--   MEMIF_CMD_READ_SG/MEMIF_CMD_WRITE_SG - scatter-gather transfers,
+	--     the length holds the size of a descriptor list in main memory
+	--     and the address word its address, followed by a word holding
+	--     the total length of the transfer. The arbiter fetches the
+	--     descriptors and transfers the described blocks as one stream.
+	--
+	--   MEMIF_CMD_READ_CACHED - read of a single memif word served by the
+	--     cache of the slot (see reconos_memif_cache). Without a cache the
+	--     arbiter handles it as a plain read.
+	--
+	--   MEMIF_CMD_CACHE_INV - invalidates the cache of the slot, followed
+	--     by an address word which is ignored. Without a cache the arbiter
+	--     drops it.
 	--
-	constant MEMIF_CMD_READ  : std_logic_vector(C_MEMIF_OP_WIDTH - 1 downto 0) := x"00";
-	constant MEMIF_CMD_WRITE : std_logic_vector(C_MEMIF_OP_WIDTH - 1 downto 0) := x"F0";
+	--   C_MEMIF_SG_DESC_BYTES - size of a descriptor, consisting of the
+	--     words address, length (bytes per row), stride (bytes between
+	--     rows) and count (number of rows). Descriptors must be aligned
+	--     to their size, address and length to the width of the memif.
+	--
+	constant MEMIF_CMD_READ     : std_logic_vector(C_MEMIF_OP_WIDTH - 1 downto 0) := x"00";
+	constant MEMIF_CMD_WRITE    : std_logic_vector(C_MEMIF_OP_WIDTH - 1 downto 0) := x"F0";
+	constant MEMIF_CMD_READ_SG  : std_logic_vector(C_MEMIF_OP_WIDTH - 1 downto 0) := x"01";
+	constant MEMIF_CMD_WRITE_SG : std_logic_vector(C_MEMIF_OP_WIDTH - 1 downto 0) := x"F1";
+
+	constant MEMIF_CMD_READ_CACHED : std_logic_vector(C_MEMIF_OP_WIDTH - 1 downto 0) := x"02";
+	constant MEMIF_CMD_CACHE_INV   : std_logic_vector(C_MEMIF_OP_WIDTH - 1 downto 0) := x"03";
+
+	constant C_MEMIF_SG_DESC_BYTES : integer := 16;
 
 
 	-- == Type definitions ================================================
@@ -151,14 +184,14 @@ package reconos_pkg is
 	--
 	-- Type definitions of i_ram_t and o_ram_t
 	--
-	--   ram_  - ram signals
+	--   ram_  - ram signals, every word of the ram holds one memif word
 	--
 	--   count    - byte counter of written bytes
 	--   mem_addr - remote address of main memory
 	--
 	type i_ram_t is record
 		ram_addr : unsigned(31 downto 0);
-		ram_data : std_logic_vector(31 downto 0);
+		ram_data : std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
 
 		remm     : unsigned(31 downto 0);
 		mem_addr : unsigned(31 downto 0);
@@ -166,7 +199,7 @@ package reconos_pkg is
 	
 	type o_ram_t is record
 		ram_addr : unsigned(31 downto 0);
-		ram_data : std_logic_vector(31 downto 0);
+		ram_data : std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
 		ram_we   : std_logic;
 
 		remm     : unsigned(31 downto 0);
@@ -176,6 +209,46 @@ package reconos_pkg is
 
 	-- == Reconos functions ===============================================
 
+	--
+	-- Extends a command or address word to the width of the memif.
+	--
+	--   word - command or address word
+	--
+	function memif_word (
+		word : std_logic_vector(C_MEMIF_CMD_WIDTH - 1 downto 0)
+	) return std_logic_vector;
+
+	--
+	-- Aligns an address to the width of the memif.
+	--
+	--   addr - address to align
+	--
+	function memif_align (
+		addr : std_logic_vector(31 downto 0)
+	) return std_logic_vector;
+
+	--
+	-- Selects the 32 bit word addressed by addr from a memif word.
+	--
+	--   data - memif word
+	--   addr - address of the 32 bit word
+	--
+	function memif_lane (
+		data : std_logic_vector;
+		addr : std_logic_vector(31 downto 0)
+	) return std_logic_vector;
+
+	--
+	-- Builds the command word of a scatter-gather transfer.
+	--
+	--   op       - MEMIF_CMD_READ_SG or MEMIF_CMD_WRITE_SG
+	--   desc_num - number of descriptors in the list
+	--
+	function memif_sg_cmd (
+		op       : std_logic_vector(C_MEMIF_OP_WIDTH - 1 downto 0);
+		desc_num : std_logic_vector(31 downto 0)
+	) return std_logic_vector;
+
 	--
 	-- Assigns signals to the osif record. This function must be called
 	-- asynchronously in the main entity including the os-fsm.
@@ -258,7 +331,7 @@ package reconos_pkg is
 	procedure ram_setup (
 		signal i_ram      : out i_ram_t;
 		signal o_ram      : in  o_ram_t;
-		signal ram_addr   : out std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
+		signal ram_addr   : out std_logic_vector(31 downto 0);
 		signal ram_i_data : out std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
 		signal ram_o_data : in  std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
 		signal ram_we     : out std_logic
@@ -646,7 +719,7 @@ package reconos_pkg is
 	);
 
 	--
-	-- Writes a single word into the main memory.
+	-- Writes a single memif word into the main memory.
 	--
 	--   i_memif - i_memif_t record
 	--   o_memif - o_memif_t record
@@ -663,7 +736,7 @@ package reconos_pkg is
 	);
 
 	--
-	-- Reads a single word from the main memory.
+	-- Reads a single memif word from the main memory.
 	--
 	--   i_memif - i_memif_t record
 	--   o_memif - o_memif_t record
@@ -679,6 +752,40 @@ package reconos_pkg is
 		variable done  : out boolean
 	);
 
+	--
+	-- Reads a single memif word through the cache of the slot, which
+	-- serves repeated accesses to the same lines without accessing the
+	-- main memory. Without a cache it behaves like memif_read_word.
+	--
+	--   i_memif - i_memif_t record
+	--   o_memif - o_memif_t record
+	--   addr    - address of the main memory to read from
+	--   data    - word read from the main memory
+	--   done    - indicates that the call finished
+	--
+	procedure memif_cached_read (
+		signal i_memif : in  i_memif_t;
+		signal o_memif : out o_memif_t;
+		addr           : in  std_logic_vector(31 downto 0);
+		signal data    : out std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
+		variable done  : out boolean
+	);
+
+	--
+	-- Invalidates the cache of the slot. Must be called when the data
+	-- read by memif_cached_read may have been changed by others, e.g.
+	-- at the start of a new job.
+	--
+	--   i_memif - i_memif_t record
+	--   o_memif - o_memif_t record
+	--   done    - indicates that the call finished
+	--
+	procedure memif_cache_invalidate (
+		signal i_memif : in  i_memif_t;
+		signal o_memif : out o_memif_t;
+		variable done  : out boolean
+	);
+
 	--
  	-- Writes several words from the local ram into main memory. Therefore,
  	-- divides a large request into smaller ones of length at most
@@ -691,7 +798,7 @@ package reconos_pkg is
 	--   o_memif  - o_memif_t record
 	--   src_addr - start address to read from the local ram
 	--   dst_addr - start address to write into the main memory
-	--   len      - number of bytes to transmit (bytes)
+	--   len      - number of bytes to transmit (multiple of C_MEMIF_DATA_BYTES)
 	--   done     - indicates that the call finished
 	--
 	procedure memif_write (
@@ -717,7 +824,7 @@ package reconos_pkg is
 	--   o_memif  - o_memif_t record
 	--   src_addr - start address to read from the main memory
 	--   dst_addr - start address to write into the local ram
-	--   len      - number of bytes to transmit (bytes)
+	--   len      - number of bytes to transmit (multiple of C_MEMIF_DATA_BYTES)
 	--   done     - indicates that the call finished
 	--
 	procedure memif_read (
@@ -730,11 +837,106 @@ package reconos_pkg is
 		len            : in  std_logic_vector(31 downto 0);
 		variable done  : out boolean
 	);
+
+	--
+	-- Writes several words from the local ram into the blocks described
+	-- by a scatter-gather descriptor list in main memory. The words are
+	-- distributed to the blocks in the order of the descriptors and rows.
+	--
+	--   i_ram     - i_ram_t record
+	--   o_ram     - o_ram_t record
+	--   i_memif   - i_memif_t record
+	--   o_memif   - o_memif_t record
+	--   src_addr  - start address to read from the local ram
+	--   desc_addr - address of the descriptor list in main memory
+	--   desc_num  - number of descriptors in the list
+	--   len       - total number of bytes described by the list
+	--   done      - indicates that the call finished
+	--
+	procedure memif_write_sg (
+		signal i_ram   : in  i_ram_t;
+		signal o_ram   : out o_ram_t;
+		signal i_memif : in  i_memif_t;
+		signal o_memif : out o_memif_t;
+		src_addr       : in  std_logic_vector(31 downto 0);
+		desc_addr      : in  std_logic_vector(31 downto 0);
+		desc_num       : in  std_logic_vector(31 downto 0);
+		len            : in  std_logic_vector(31 downto 0);
+		variable done  : out boolean
+	);
+
+	--
+	-- Reads the blocks described by a scatter-gather descriptor list in
+	-- main memory into the local ram, where they are stored contiguously
+	-- in the order of the descriptors and rows.
+	--
+	--   i_ram     - i_ram_t record
+	--   o_ram     - o_ram_t record
+	--   i_memif   - i_memif_t record
+	--   o_memif   - o_memif_t record
+	--   desc_addr - address of the descriptor list in main memory
+	--   desc_num  - number of descriptors in the list
+	--   dst_addr  - start address to write into the local ram
+	--   len       - total number of bytes described by the list
+	--   done      - indicates that the call finished
+	--
+	procedure memif_read_sg (
+		signal i_ram   : in  i_ram_t;
+		signal o_ram   : out o_ram_t;
+		signal i_memif : in  i_memif_t;
+		signal o_memif : out o_memif_t;
+		desc_addr      : in  std_logic_vector(31 downto 0);
+		desc_num       : in  std_logic_vector(31 downto 0);
+		dst_addr       : in  std_logic_vector(31 downto 0);
+		len            : in  std_logic_vector(31 downto 0);
+		variable done  : out boolean
+	);
 	
 end package reconos_pkg;
 
 package body reconos_pkg is
 
+	--
+	-- @see header
+	--
+	function memif_word (
+		word : std_logic_vector(C_MEMIF_CMD_WIDTH - 1 downto 0)
+	) return std_logic_vector is begin
+		return std_logic_vector(resize(unsigned(word), C_MEMIF_DATA_WIDTH));
+	end function memif_word;
+
+	--
+	-- @see header
+	--
+	function memif_align (
+		addr : std_logic_vector(31 downto 0)
+	) return std_logic_vector is begin
+		return std_logic_vector(unsigned(addr) - (unsigned(addr) mod C_MEMIF_DATA_BYTES));
+	end function memif_align;
+
+	--
+	-- @see header
+	--
+	function memif_lane (
+		data : std_logic_vector;
+		addr : std_logic_vector(31 downto 0)
+	) return std_logic_vector is
+		variable lane : integer;
+	begin
+		lane := to_integer(unsigned(addr(7 downto 2))) mod (data'length / 32);
+		return data(data'low + 32 * lane + 31 downto data'low + 32 * lane);
+	end function memif_lane;
+
+	--
+	-- @see header
+	--
+	function memif_sg_cmd (
+		op       : std_logic_vector(C_MEMIF_OP_WIDTH - 1 downto 0);
+		desc_num : std_logic_vector(31 downto 0)
+	) return std_logic_vector is begin
+		return memif_word(op & std_logic_vector(resize(unsigned(desc_num) * C_MEMIF_SG_DESC_BYTES, C_MEMIF_LENGTH_WIDTH)));
+	end function memif_sg_cmd;
+
 	--
 	-- @see header
 	--
@@ -817,7 +1019,7 @@ package body reconos_pkg is
 	procedure ram_setup (
 		signal i_ram      : out i_ram_t;
 		signal o_ram      : in  o_ram_t;
-		signal ram_addr   : out std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
+		signal ram_addr   : out std_logic_vector(31 downto 0);
 		signal ram_i_data : out std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
 		signal ram_o_data : in  std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
 		signal ram_we     : out std_logic
@@ -1356,13 +1558,13 @@ package body reconos_pkg is
 		case i_memif.step is
 			when 0 =>
 				o_memif.hwt2mem_we <= '1';
-				o_memif.hwt2mem_data <= MEMIF_CMD_WRITE & X"000004";
+				o_memif.hwt2mem_data <= memif_word(MEMIF_CMD_WRITE & std_logic_vector(to_unsigned(C_MEMIF_DATA_BYTES, C_MEMIF_LENGTH_WIDTH)));
 
 				o_memif.step <= 1;
 
 			when 1 =>
 				if i_memif.hwt2mem_full = '0' then
-					o_memif.hwt2mem_data <= addr(31 downto 2) & "00";
+					o_memif.hwt2mem_data <= memif_word(memif_align(addr));
 
 					o_memif.step <= 2;
 				end if;
@@ -1400,13 +1602,13 @@ package body reconos_pkg is
 		case i_memif.step is
 			when 0 =>
 				o_memif.hwt2mem_we <= '1';
-				o_memif.hwt2mem_data <= MEMIF_CMD_READ & X"000004";
+				o_memif.hwt2mem_data <= memif_word(MEMIF_CMD_READ & std_logic_vector(to_unsigned(C_MEMIF_DATA_BYTES, C_MEMIF_LENGTH_WIDTH)));
 
 				o_memif.step <= 1;
 
 			when 1 =>
 				if i_memif.hwt2mem_full = '0' then
-					o_memif.hwt2mem_data <= addr(31 downto 2) & "00";
+					o_memif.hwt2mem_data <= memif_word(memif_align(addr));
 
 					o_memif.step <= 2;
 				end if;
@@ -1434,6 +1636,87 @@ package body reconos_pkg is
 		end case;
 	end procedure memif_read_word;
 
+	procedure memif_cached_read (
+		signal i_memif  : in  i_memif_t;
+		signal o_memif  : out o_memif_t;
+		addr            : in  std_logic_vector(31 downto 0);
+		signal data     : out std_logic_vector(C_MEMIF_DATA_WIDTH - 1 downto 0);
+		variable done   : out boolean
+	) is begin
+		done := False;
+
+		case i_memif.step is
+			when 0 =>
+				o_memif.hwt2mem_we <= '1';
+				o_memif.hwt2mem_data <= memif_word(MEMIF_CMD_READ_CACHED & std_logic_vector(to_unsigned(C_MEMIF_DATA_BYTES, C_MEMIF_LENGTH_WIDTH)));
+
+				o_memif.step <= 1;
+
+			when 1 =>
+				if i_memif.hwt2mem_full = '0' then
+					o_memif.hwt2mem_data <= memif_word(memif_align(addr));
+
+					o_memif.step <= 2;
+				end if;
+
+			when 2 =>
+				if i_memif.hwt2mem_full = '0' then
+					o_memif.hwt2mem_we <= '0';
+					o_memif.mem2hwt_re <= '1';
+
+					o_memif.step <= 3;
+				end if;
+
+			when 3 =>
+				if i_memif.mem2hwt_empty = '0' then
+					data <= i_memif.mem2hwt_data;
+					o_memif.mem2hwt_re <= '0';
+
+					o_memif.step <= 4;
+				end if;
+
+			when others =>
+					done := True;
+					o_memif.step <= 0;
+
+		end case;
+	end procedure memif_cached_read;
+
+	procedure memif_cache_invalidate (
+		signal i_memif  : in  i_memif_t;
+		signal o_memif  : out o_memif_t;
+		variable done   : out boolean
+	) is begin
+		done := False;
+
+		case i_memif.step is
+			when 0 =>
+				o_memif.hwt2mem_we <= '1';
+				o_memif.hwt2mem_data <= memif_word(MEMIF_CMD_CACHE_INV & std_logic_vector(to_unsigned(0, C_MEMIF_LENGTH_WIDTH)));
+
+				o_memif.step <= 1;
+
+			when 1 =>
+				if i_memif.hwt2mem_full = '0' then
+					o_memif.hwt2mem_data <= (others => '0');
+
+					o_memif.step <= 2;
+				end if;
+
+			when 2 =>
+				if i_memif.hwt2mem_full = '0' then
+					o_memif.hwt2mem_we <= '0';
+
+					o_memif.step <= 3;
+				end if;
+
+			when others =>
+					done := True;
+					o_memif.step <= 0;
+
+		end case;
+	end procedure memif_cache_invalidate;
+
 	procedure memif_write (
 		signal i_ram    : in  i_ram_t;
 		signal o_ram    : out o_ram_t;
@@ -1452,7 +1735,7 @@ package body reconos_pkg is
 			when 0 =>
 				o_memif.hwt2mem_we <= '0';
 				
-				o_ram.mem_addr <= unsigned(dst_addr(31 downto 2) & "00");
+				o_ram.mem_addr <= unsigned(memif_align(dst_addr));
 				o_ram.remm <= unsigned(len);
 
 				o_ram.ram_addr <= unsigned(src_addr);
@@ -1465,16 +1748,16 @@ package body reconos_pkg is
 				to_border := to_unsigned(C_MEMIF_CHUNK_BYTES, C_MEMIF_LENGTH_WIDTH) - i_ram.mem_addr(C_MEMIF_CHUNK_RANGE);
 				to_remm := i_ram.remm(C_MEMIF_LENGTH_RANGE);
 				if to_remm < to_border then
-					o_memif.hwt2mem_data <= MEMIF_CMD_WRITE & std_logic_vector(to_remm);
+					o_memif.hwt2mem_data <= memif_word(MEMIF_CMD_WRITE & std_logic_vector(to_remm));
 				else
-					o_memif.hwt2mem_data <= MEMIF_CMD_WRITE & std_logic_vector(to_border);
+					o_memif.hwt2mem_data <= memif_word(MEMIF_CMD_WRITE & std_logic_vector(to_border));
 				end if;
 
 				o_memif.step <= 2;
 
 			when 2 =>
 				if i_memif.hwt2mem_full = '0' then
-					o_memif.hwt2mem_data <= std_logic_vector(i_ram.mem_addr);
+					o_memif.hwt2mem_data <= memif_word(std_logic_vector(i_ram.mem_addr));
 
 					o_memif.step <= 3;
 				end if;
@@ -1505,10 +1788,10 @@ package body reconos_pkg is
 					
 					o_ram.ram_addr <= i_ram.ram_addr + 1;
 				
-					o_ram.mem_addr <= i_ram.mem_addr + 4;
-					o_ram.remm <= i_ram.remm - 4;
+					o_ram.mem_addr <= i_ram.mem_addr + C_MEMIF_DATA_BYTES;
+					o_ram.remm <= i_ram.remm - C_MEMIF_DATA_BYTES;
 					
-					if (i_ram.mem_addr + 4) mod C_MEMIF_CHUNK_BYTES = 0 then
+					if (i_ram.mem_addr + C_MEMIF_DATA_BYTES) mod C_MEMIF_CHUNK_BYTES = 0 then
 						o_memif.hwt2mem_we <= '0';
 						
 						o_ram.ram_addr <= i_ram.ram_addr - 1;
@@ -1516,7 +1799,7 @@ package body reconos_pkg is
 						o_memif.step <= 1;
 					end if;
 								
-					if i_ram.remm - 4 = 0 then
+					if i_ram.remm - C_MEMIF_DATA_BYTES = 0 then
 						o_memif.hwt2mem_we <= '0';
 						
 						o_memif.step <= 8;
@@ -1559,7 +1842,7 @@ package body reconos_pkg is
 
 		case i_memif.step is
 			when 0 =>
-				o_ram.mem_addr <= unsigned(src_addr(31 downto 2) & "00");
+				o_ram.mem_addr <= unsigned(memif_align(src_addr));
 				o_ram.remm <= unsigned(len);
 
 				o_ram.ram_addr <= unsigned(dst_addr) - 1;
@@ -1573,17 +1856,17 @@ package body reconos_pkg is
 				to_remm := i_ram.remm(C_MEMIF_LENGTH_RANGE);
 				if to_remm < to_border then
 					o_memif.hwt2mem_we <= '1';
-					o_memif.hwt2mem_data <= MEMIF_CMD_READ & std_logic_vector(to_remm);
+					o_memif.hwt2mem_data <= memif_word(MEMIF_CMD_READ & std_logic_vector(to_remm));
 				else
 					o_memif.hwt2mem_we <= '1';
-					o_memif.hwt2mem_data <= MEMIF_CMD_READ & std_logic_vector(to_border);
+					o_memif.hwt2mem_data <= memif_word(MEMIF_CMD_READ & std_logic_vector(to_border));
 				end if;
 
 				o_memif.step <= 2;
 
 			when 2 =>
 				if i_memif.hwt2mem_full = '0' then
-					o_memif.hwt2mem_data <= std_logic_vector(i_ram.mem_addr);
+					o_memif.hwt2mem_data <= memif_word(std_logic_vector(i_ram.mem_addr));
 
 					o_memif.step <= 3;
 				end if;
@@ -1602,16 +1885,16 @@ package body reconos_pkg is
 					o_ram.ram_data <= i_memif.mem2hwt_data;
 					
 					o_ram.ram_addr <= i_ram.ram_addr + 1;
-					o_ram.mem_addr <= i_ram.mem_addr + 4;
-					o_ram.remm <= i_ram.remm - 4;
+					o_ram.mem_addr <= i_ram.mem_addr + C_MEMIF_DATA_BYTES;
+					o_ram.remm <= i_ram.remm - C_MEMIF_DATA_BYTES;
 					
-					if (i_ram.mem_addr + 4) mod C_MEMIF_CHUNK_BYTES = 0 then
+					if (i_ram.mem_addr + C_MEMIF_DATA_BYTES) mod C_MEMIF_CHUNK_BYTES = 0 then
 						o_memif.mem2hwt_re <= '0';
 					
 						o_memif.step <= 1;
 					end if;
 					
-					if i_ram.remm - 4 = 0 then
+					if i_ram.remm - C_MEMIF_DATA_BYTES = 0 then
 						o_memif.mem2hwt_re <= '0';
 						
 						o_memif.step <= 5;
@@ -1626,5 +1909,178 @@ package body reconos_pkg is
 
 		end case;
 	end procedure memif_read;
+
+	procedure memif_write_sg (
+		signal i_ram    : in  i_ram_t;
+		signal o_ram    : out o_ram_t;
+		signal i_memif  : in  i_memif_t;
+		signal o_memif  : out o_memif_t;
+		src_addr        : in  std_logic_vector(31 downto 0);
+		desc_addr       : in  std_logic_vector(31 downto 0);
+		desc_num        : in  std_logic_vector(31 downto 0);
+		len             : in  std_logic_vector(31 downto 0);
+		variable done   : out boolean
+	) is begin
+		done := False;
+
+		case i_memif.step is
+			when 0 =>
+				o_memif.hwt2mem_we <= '0';
+
+				o_ram.remm <= unsigned(len);
+
+				o_ram.ram_addr <= unsigned(src_addr);
+
+				o_memif.step <= 1;
+
+			when 1 =>
+				o_memif.hwt2mem_we <= '1';
+				o_memif.hwt2mem_data <= memif_sg_cmd(MEMIF_CMD_WRITE_SG, desc_num);
+
+				o_memif.step <= 2;
+
+			when 2 =>
+				if i_memif.hwt2mem_full = '0' then
+					o_memif.hwt2mem_data <= memif_word(desc_addr);
+
+					o_memif.step <= 3;
+				end if;
+
+			when 3 =>
+				if i_memif.hwt2mem_full = '0' then
+					o_memif.hwt2mem_data <= memif_word(len);
+
+					o_memif.step <= 4;
+				end if;
+
+			when 4 =>
+				if i_memif.hwt2mem_full = '0' then
+					o_memif.hwt2mem_we <= '0';
+
+					o_memif.step <= 5;
+				end if;
+
+			when 5 =>
+				o_ram.ram_addr <= i_ram.ram_addr + 1;
+
+				o_memif.step <= 6;
+
+			when 6 =>
+				o_memif.hwt2mem_we <= '1';
+				o_memif.hwt2mem_data <= i_ram.ram_data;
+
+				o_ram.ram_addr <= i_ram.ram_addr + 1;
+
+				o_memif.step <= 7;
+
+			when 7 =>
+				if i_memif.hwt2mem_full = '0' then
+					o_memif.hwt2mem_data <= i_ram.ram_data;
+
+					o_ram.ram_addr <= i_ram.ram_addr + 1;
+
+					o_ram.remm <= i_ram.remm - C_MEMIF_DATA_BYTES;
+
+					if i_ram.remm - C_MEMIF_DATA_BYTES = 0 then
+						o_memif.hwt2mem_we <= '0';
+
+						o_memif.step <= 9;
+					end if;
+				else
+					o_memif.hwt2mem_we <= '0';
+
+					o_ram.ram_addr <= i_ram.ram_addr - 2;
+
+					o_memif.step <= 8;
+				end if;
+
+			when 8 =>
+				if i_memif.hwt2mem_full = '0' then
+					o_memif.step <= 5;
+				end if;
+
+			when others =>
+				o_memif.hwt2mem_we <= '0';
+
+				o_memif.step <= 0;
+				done := True;
+
+		end case;
+	end procedure memif_write_sg;
+
+	procedure memif_read_sg (
+		signal i_ram    : in  i_ram_t;
+		signal o_ram    : out o_ram_t;
+		signal i_memif  : in  i_memif_t;
+		signal o_memif  : out o_memif_t;
+		desc_addr       : in  std_logic_vector(31 downto 0);
+		desc_num        : in  std_logic_vector(31 downto 0);
+		dst_addr        : in  std_logic_vector(31 downto 0);
+		len             : in  std_logic_vector(31 downto 0);
+		variable done   : out boolean
+	) is begin
+		done := False;
+
+		case i_memif.step is
+			when 0 =>
+				o_ram.remm <= unsigned(len);
+
+				o_ram.ram_addr <= unsigned(dst_addr) - 1;
+
+				o_memif.step <= 1;
+
+			when 1 =>
+				o_ram.ram_we <= '0';
+
+				o_memif.hwt2mem_we <= '1';
+				o_memif.hwt2mem_data <= memif_sg_cmd(MEMIF_CMD_READ_SG, desc_num);
+
+				o_memif.step <= 2;
+
+			when 2 =>
+				if i_memif.hwt2mem_full = '0' then
+					o_memif.hwt2mem_data <= memif_word(desc_addr);
+
+					o_memif.step <= 3;
+				end if;
+
+			when 3 =>
+				if i_memif.hwt2mem_full = '0' then
+					o_memif.hwt2mem_data <= memif_word(len);
+
+					o_memif.step <= 4;
+				end if;
+
+			when 4 =>
+				if i_memif.hwt2mem_full = '0' then
+					o_memif.hwt2mem_we <= '0';
+					o_memif.mem2hwt_re <= '1';
+
+					o_memif.step <= 5;
+				end if;
+
+			when 5 =>
+				if i_memif.mem2hwt_empty = '0' then
+					o_ram.ram_we <= '1';
+					o_ram.ram_data <= i_memif.mem2hwt_data;
+
+					o_ram.ram_addr <= i_ram.ram_addr + 1;
+					o_ram.remm <= i_ram.remm - C_MEMIF_DATA_BYTES;
+
+					if i_ram.remm - C_MEMIF_DATA_BYTES = 0 then
+						o_memif.mem2hwt_re <= '0';
+
+						o_memif.step <= 6;
+					end if;
+				end if;
+
+			when others =>
+				o_ram.ram_we <= '0';
+
+				o_memif.step <= 0;
+				done := true;
+
+		end case;
+	end procedure memif_read_sg;
 	
 end package body reconos_pkg;
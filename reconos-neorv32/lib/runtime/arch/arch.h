@@ -32,6 +32,45 @@ extern uint32_t reconos_osif_read(int fd);
 extern void reconos_osif_write(int fd, uint32_t data);
 extern void reconos_osif_break(int fd);
 extern void reconos_osif_close(int fd);
+extern int reconos_osif_tryread(int fd, uint32_t *data);
+
+/*
+ * Event loop support (Linux only): the descriptor becomes readable with
+ * poll/epoll if an osif enabled by reconos_osif_poll has data, which
+ * must be drained by reconos_osif_tryread before enabling it again.
+ */
+extern int reconos_osif_poll_open();
+extern int reconos_osif_poll(int pfd, uint32_t *mask);
+extern void reconos_osif_poll_close(int pfd);
+
+/*
+ * Kernel mbox support (Linux only): binding a resource handle of the
+ * osif to a kernel mbox lets the driver complete the mbox commands on
+ * it, while reconos_osif_read_cmd returns only the remaining commands.
+ * Without any binding reconos_osif_read_cmd equals reconos_osif_read.
+ */
+extern uint32_t reconos_osif_read_cmd(int fd);
+extern int reconos_osif_kbind(int fd, int handle, int kmbox_fd);
+extern void reconos_osif_kunbind(int fd);
+
+
+/* == Broker related functions ========================================== */
+
+/*
+ * Slot broker support (Linux only): if the environment variable
+ * RECONOS_BROKER is set, the hardware is shared with other applications
+ * through the broker. Slots must be acquired before being used and
+ * memory accessed by hardware threads must be allocated from the arena
+ * by reconos_broker_alloc. Acquiring returns 1 if the slot is already
+ * leased by this application. Without the broker, acquiring always
+ * succeeds and allocating returns NULL.
+ */
+extern int reconos_broker_connected();
+extern int reconos_broker_acquire(int num);
+extern void reconos_broker_release(int num);
+extern int reconos_broker_reconfig(int num, const char *path);
+extern void *reconos_broker_alloc(size_t size);
+extern int reconos_broker_free(void *ptr);
 
 
 /* == Proc control related functions ==================================== */
@@ -47,6 +86,12 @@ extern void reconos_proc_control_sys_reset(int fd);
 extern void reconos_proc_control_hwt_reset(int fd, int num, int reset);
 extern void reconos_proc_control_hwt_signal(int fd, int num, int signal);
 extern void reconos_proc_control_cache_flush(int fd);
+extern void reconos_proc_control_cache_clean(int fd, void *addr, unsigned int len);
+extern void reconos_proc_control_cache_invalidate(int fd, void *addr, unsigned int len);
+extern int reconos_proc_control_pin(int fd, void *addr, unsigned int len);
+extern void reconos_proc_control_unpin(int fd, void *addr);
+extern int reconos_proc_control_get_stats(int fd, int num, uint64_t *count);
+extern void reconos_proc_control_reset_stats(int fd, int num);
 extern void reconos_proc_control_close(int fd);
 
 
@@ -60,6 +105,11 @@ extern void reconos_clock_close(int fd);
 /* == Reconfiguration related functions ================================= */
 
 extern int load_partial_bitstream(uint32_t *bitstream, unsigned int bitstream_length);
+extern int reconos_devcfg_firmware();
+extern int reconos_devcfg_open(int partial);
+extern int reconos_devcfg_write(int fd, char *data, unsigned int length);
+extern int reconos_devcfg_close(int fd);
+extern int reconos_devcfg_program(const char *path, char *data, unsigned int length, int partial);
 
 
 /* == Initialization function =========================================== */
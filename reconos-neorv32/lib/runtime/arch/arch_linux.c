@@ -23,25 +23,34 @@
 #include "../utils.h"
 
 #include "arch_linux_kernel.h"
+#include "arch_linux_broker.h"
 
 #include <stdio.h>
+#include <string.h>
+#include <errno.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 #include "pthread.h"
 
 #define PROC_CONTROL_DEV "/dev/reconos-proc-control"
 #define OSIF_INTC_DEV "/dev/reconos-osif-intc"
+#define OSIF_DEV "/dev/reconos-osif"
 
 unsigned int NUM_HWTS = 0;
 
+int broker_fd = -1;
+
 
 /* == OSIF related functions ============================================ */
 
 #define OSIF_FIFO_BASE_ADDR       0x75A00000
 #define OSIF_FIFO_BASE_SIZE       0x10000
 #define OSIF_FIFO_MEM_SIZE        0x10
+#define OSIF_FIFO_STRIDE_ATTR     "/sys/class/misc/reconos-osif/stride"
 #define OSIF_FIFO_RECV_REG        0
 #define OSIF_FIFO_SEND_REG        1
 #define OSIF_FIFO_RECV_STATUS_REG 2
@@ -53,26 +62,172 @@ unsigned int NUM_HWTS = 0;
 #define OSIF_FIFO_RECV_STATUS_FILL_MASK 0xFFFF
 #define OSIF_FIFO_SEND_STATUS_REM_MASK  0xFFFF
 
+/*
+ * The registers of an osif are mapped from the osif device after
+ * claiming it, which requires the osifs to be placed on separate
+ * pages. Otherwise, the entire window is mapped from /dev/mem and the
+ * osifs are addressed by the stride reported by the osif device.
+ *
+ *   index     - index of the hardware thread
+ *   ptr       - pointer to the mapped registers
+ *   mapped    - indicates if ptr is a mapping of the osif device
+ *   fifo_fill - words known to be available in the receive fifo
+ *   fifo_rem  - words known to be free in the send fifo
+ *   fd        - descriptor of the osif device claiming the osif
+ *   kernel    - indicates if the kernel path is enabled
+ */
 struct osif_fifo_dev {
 	unsigned int index;
 
 	volatile uint32_t *ptr;
+	int mapped;
 
 	unsigned int fifo_fill;
 	unsigned int fifo_rem;
+
+	int fd;
+	int kernel;
 };
 
 int osif_intc_fd;
 struct osif_fifo_dev *osif_fifo_dev;
+char *osif_fifo_mem;
+unsigned int osif_fifo_stride;
+
+/*
+ * Reads the distance of the registers of two osifs from the osif
+ * device. Drivers not reporting it only support osifs without gaps.
+ *
+ *   @returns the stride in bytes or 0 on failure
+ */
+static unsigned int osif_fifo_read_stride() {
+	char buf[16];
+	int fd, len;
+
+	fd = open(OSIF_FIFO_STRIDE_ATTR, O_RDONLY);
+	if (fd < 0) {
+		return OSIF_FIFO_MEM_SIZE;
+	}
+	len = read(fd, buf, sizeof(buf) - 1);
+	close(fd);
+	if (len <= 0) {
+		return 0;
+	}
+	buf[len] = '\0';
+
+	return strtoul(buf, NULL, 0);
+}
+
+static char *osif_fifo_mem_map() {
+	unsigned int size;
+	int fd;
+	char *mem;
+
+	if (osif_fifo_mem) {
+		return osif_fifo_mem;
+	}
+
+	osif_fifo_stride = osif_fifo_read_stride();
+	if (osif_fifo_stride < OSIF_FIFO_MEM_SIZE) {
+		whine("[reconos-osif] "
+		      "unable to read the stride of the osifs\n");
+		return NULL;
+	}
+
+	size = NUM_HWTS * osif_fifo_stride;
+	if (size < OSIF_FIFO_BASE_SIZE) {
+		size = OSIF_FIFO_BASE_SIZE;
+	}
+
+	fd = open("/dev/mem", O_RDWR | O_SYNC);
+	if (fd < 0) {
+		whine("[reconos-osif] "
+		      "failed to open /dev/mem\n");
+		return NULL;
+	}
+
+	mem = (char *)mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, OSIF_FIFO_BASE_ADDR);
+	close(fd);
+	if (mem == MAP_FAILED) {
+		whine("[reconos-osif] "
+		      "failed to mmap osif memory\n");
+		return NULL;
+	}
+
+	osif_fifo_mem = mem;
+
+	return mem;
+}
+
+static int osif_fifo_map(struct osif_fifo_dev *dev) {
+	void *ptr;
+	char *mem;
+
+	dev->fifo_fill = 0;
+	dev->fifo_rem = 0;
+	dev->kernel = 0;
+
+	if (dev->fd >= 0) {
+		ptr = mmap(0, getpagesize(), PROT_READ | PROT_WRITE, MAP_SHARED, dev->fd, 0);
+		if (ptr != MAP_FAILED) {
+			dev->ptr = (uint32_t *)ptr;
+			dev->mapped = 1;
+			return 0;
+		}
+	}
+
+	debug("[reconos-osif-%d] "
+	      "falling back to /dev/mem\n", dev->index);
+
+	mem = osif_fifo_mem_map();
+	if (!mem) {
+		return -1;
+	}
+
+	dev->ptr = (uint32_t *)(mem + dev->index * osif_fifo_stride);
+	dev->mapped = 0;
+
+	return 0;
+}
 
 int reconos_osif_open(int num) {
+	struct osif_fifo_dev *dev;
+
 	debug("[reconos-osif-%d] "
 	      "opening ...\n", num);
 
 	if (num < 0 || num >= NUM_HWTS)
 		return -1;
-	else
+
+	dev = &osif_fifo_dev[num];
+	dev->index = num;
+
+	// with the broker the osif is mapped when leasing the slot
+	if (broker_fd >= 0) {
 		return num;
+	}
+
+	dev->fd = open(OSIF_DEV, O_RDWR);
+	if (dev->fd < 0) {
+		whine("[reconos-osif-%d] "
+		      "unable to open osif device\n", num);
+	} else if (ioctl(dev->fd, RECONOS_OSIF_CLAIM, &dev->index) < 0) {
+		whine("[reconos-osif-%d] "
+		      "unable to claim osif\n", num);
+		close(dev->fd);
+		dev->fd = -1;
+		return -1;
+	}
+
+	if (osif_fifo_map(dev) < 0) {
+		if (dev->fd >= 0) {
+			close(dev->fd);
+			dev->fd = -1;
+		}
+		return -1;
+	}
+
+	return num;
 }
 
 static inline unsigned int osif_fifo_hw2sw_fill(struct osif_fifo_dev *dev) {
@@ -100,6 +255,14 @@ uint32_t reconos_osif_read(int fd) {
 	struct osif_fifo_dev *dev = &osif_fifo_dev[fd];
 	uint32_t data;
 
+	if (dev->kernel) {
+		if (read(dev->fd, &data, sizeof(uint32_t)) != sizeof(uint32_t)) {
+			return 0xFFFFFFFF;
+		}
+
+		return data;
+	}
+
 	if (dev->fifo_fill == 0) {
 		debug("[reconos-osif-%d] "
 		      "reading, waiting for data ...\n", fd);
@@ -132,6 +295,15 @@ void reconos_osif_write(int fd, uint32_t data) {
 	debug("[reconos-osif-%d] "
 	      "writing 0x%x ...\n", fd, data);
 
+	if (dev->kernel) {
+		if (write(dev->fd, &data, sizeof(uint32_t)) != sizeof(uint32_t)) {
+			whine("[reconos-osif-%d] "
+			      "writing to kernel osif failed\n", fd);
+		}
+
+		return;
+	}
+
 	// do busy waiting here
 	do {
 		dev->fifo_rem = osif_fifo_sw2hw_rem(dev);
@@ -146,12 +318,369 @@ void reconos_osif_write(int fd, uint32_t data) {
 void reconos_osif_break(int fd) {
 	struct osif_fifo_dev *dev = &osif_fifo_dev[fd];
 
-	ioctl(osif_intc_fd, RECONOS_OSIF_INTC_BREAK, &dev->index);
+	if (dev->kernel) {
+		ioctl(dev->fd, RECONOS_OSIF_BREAK);
+	} else {
+		ioctl(osif_intc_fd, RECONOS_OSIF_INTC_BREAK, &dev->index);
+	}
 }
 
 void reconos_osif_close(int fd) {
+	struct osif_fifo_dev *dev = &osif_fifo_dev[fd];
+
 	debug("[reconos-osif-%d] "
 	      "closing ...\n", fd);
+
+	if (dev->mapped) {
+		munmap((void *)dev->ptr, getpagesize());
+		dev->mapped = 0;
+	}
+	dev->ptr = NULL;
+
+	if (dev->fd >= 0) {
+		close(dev->fd);
+		dev->fd = -1;
+	}
+	dev->kernel = 0;
+}
+
+int reconos_osif_tryread(int fd, uint32_t *data) {
+	struct osif_fifo_dev *dev = &osif_fifo_dev[fd];
+
+	if (dev->fifo_fill == 0) {
+		dev->fifo_fill = osif_fifo_hw2sw_fill(dev);
+
+		if (dev->fifo_fill == 0) {
+			return 0;
+		}
+	}
+
+	*data = dev->ptr[OSIF_FIFO_RECV_REG];
+	dev->fifo_fill--;
+
+	return 1;
+}
+
+int reconos_osif_poll_open() {
+	return open(OSIF_INTC_DEV, O_RDWR | O_NONBLOCK);
+}
+
+int reconos_osif_poll(int pfd, uint32_t *mask) {
+	struct reconos_osif_mask arg;
+	size_t size = ((NUM_HWTS - 1) / 32 + 1) * sizeof(uint32_t);
+
+	memset(&arg, 0, sizeof(arg));
+	memcpy(arg.mask, mask, size);
+
+	if (ioctl(pfd, RECONOS_OSIF_INTC_WAIT_ANY, &arg) < 0) {
+		if (errno != EAGAIN) {
+			return -1;
+		}
+
+		memset(arg.mask, 0, size);
+	}
+
+	memcpy(mask, arg.mask, size);
+
+	return 0;
+}
+
+void reconos_osif_poll_close(int pfd) {
+	close(pfd);
+}
+
+uint32_t reconos_osif_read_cmd(int fd) {
+	struct osif_fifo_dev *dev = &osif_fifo_dev[fd];
+	uint32_t cmd;
+
+	if (!dev->kernel) {
+		return reconos_osif_read(fd);
+	}
+
+	if (ioctl(dev->fd, RECONOS_OSIF_NEXT_CMD, &cmd) < 0) {
+		return 0xFFFFFFFF;
+	}
+
+	return cmd;
+}
+
+int reconos_osif_kbind(int fd, int handle, int kmbox_fd) {
+	struct osif_fifo_dev *dev = &osif_fifo_dev[fd];
+	struct reconos_osif_mbox bind;
+
+	if (dev->fd < 0) {
+		whine("[reconos-osif-%d] "
+		      "kernel osif not available\n", fd);
+		return -1;
+	}
+
+	bind.handle = handle;
+	bind.fd = kmbox_fd;
+	if (ioctl(dev->fd, RECONOS_OSIF_BIND_MBOX, &bind) < 0) {
+		whine("[reconos-osif-%d] "
+		      "unable to bind handle %d to kernel mbox\n", fd, handle);
+		return -1;
+	}
+
+	// words not yet read from the fifo are read via the kernel
+	dev->fifo_fill = 0;
+	dev->kernel = 1;
+
+	return 0;
+}
+
+void reconos_osif_kunbind(int fd) {
+	struct osif_fifo_dev *dev = &osif_fifo_dev[fd];
+
+	if (!dev->kernel) {
+		return;
+	}
+
+	// unbinding breaks a delegate still waiting for a command
+	dev->kernel = 0;
+	dev->fifo_fill = 0;
+	ioctl(dev->fd, RECONOS_OSIF_UNBIND);
+}
+
+
+/* == Broker related functions ========================================== */
+
+/*
+ * With the broker, the slots are leased when used and the memory
+ * accessed by hardware threads is allocated from the arena shared with
+ * the broker. The pages of the arena are managed in a table storing
+ * the number of pages of an allocation for each of its pages.
+ */
+pthread_mutex_t broker_lock = PTHREAD_MUTEX_INITIALIZER;
+char *broker_arena;
+size_t broker_arena_size;
+uint32_t *broker_pages;
+
+/*
+ * Sends a request to the broker and waits for the response.
+ *
+ *   cmd  - request
+ *   slot - slot the request refers to
+ *   arg  - argument of the request
+ *   path - path of the bitstream or NULL
+ *   res  - pointer to store the result value in or NULL
+ *   fd   - pointer to store the received file descriptor in or NULL
+ *
+ *   @returns 0 on success, otherwise the negative error number
+ */
+static int broker_request(int cmd, int slot, uint32_t arg, const char *path,
+                          uint32_t *res, int *fd) {
+	struct reconos_broker_req req;
+	struct reconos_broker_resp resp;
+	struct msghdr msg;
+	struct iovec iov;
+	struct cmsghdr *cmsg;
+	char buf[CMSG_SPACE(sizeof(int))];
+	int rfd = -1;
+
+	memset(&req, 0, sizeof(req));
+	req.cmd = cmd;
+	req.slot = slot;
+	req.arg = arg;
+	if (path) {
+		strncpy(req.path, path, RECONOS_BROKER_PATH_LEN - 1);
+	}
+
+	memset(&msg, 0, sizeof(msg));
+	iov.iov_base = &resp;
+	iov.iov_len = sizeof(resp);
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = buf;
+	msg.msg_controllen = sizeof(buf);
+
+	pthread_mutex_lock(&broker_lock);
+	if (send(broker_fd, &req, sizeof(req), MSG_NOSIGNAL) != sizeof(req) ||
+	    recvmsg(broker_fd, &msg, 0) != sizeof(resp)) {
+		pthread_mutex_unlock(&broker_lock);
+		panic("[reconos-broker] "
+		      "lost connection to broker\n");
+	}
+	pthread_mutex_unlock(&broker_lock);
+
+	cmsg = CMSG_FIRSTHDR(&msg);
+	if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+		memcpy(&rfd, CMSG_DATA(cmsg), sizeof(int));
+	}
+
+	if (fd) {
+		*fd = rfd;
+	} else if (rfd >= 0) {
+		close(rfd);
+	}
+
+	if (res) {
+		*res = resp.arg;
+	}
+
+	return resp.result;
+}
+
+/*
+ * Connects to the broker and maps the arena at the address it is
+ * mapped in the broker.
+ *
+ *   path - path of the socket
+ */
+static void broker_connect(const char *path) {
+	struct sockaddr_un addr;
+	uint32_t base;
+	char *env;
+	size_t size;
+	void *ptr;
+	int fd;
+
+	broker_fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+	if (broker_fd < 0)
+		panic("[reconos-broker] "
+		      "unable to create socket\n");
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+	if (connect(broker_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+		panic("[reconos-broker] "
+		      "unable to connect to %s\n", path);
+
+	env = getenv(RECONOS_BROKER_ARENA_ENV);
+	size = (env ? atoi(env) : RECONOS_BROKER_ARENA_SIZE) << 20;
+
+	if (broker_request(RECONOS_BROKER_ARENA, 0, size, NULL, &base, &fd) < 0 || fd < 0)
+		panic("[reconos-broker] "
+		      "unable to create arena\n");
+
+	ptr = mmap((void *)(uintptr_t)base, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (ptr != (void *)(uintptr_t)base)
+		panic("[reconos-broker] "
+		      "unable to map arena at 0x%08x\n", base);
+
+	broker_arena = (char *)ptr;
+	broker_arena_size = size;
+
+	broker_pages = (uint32_t *)calloc(size / getpagesize(), sizeof(uint32_t));
+	if (!broker_pages)
+		panic("[reconos-broker] "
+		      "failed to allocate memory\n");
+}
+
+int reconos_broker_connected() {
+	return broker_fd >= 0;
+}
+
+int reconos_broker_acquire(int num) {
+	struct osif_fifo_dev *dev = &osif_fifo_dev[num];
+	int fd;
+
+	if (broker_fd < 0) {
+		return 0;
+	}
+
+	if (dev->fd >= 0) {
+		return 1;
+	}
+
+	if (broker_request(RECONOS_BROKER_LEASE, num, 0, NULL, NULL, &fd) < 0 || fd < 0) {
+		debug("[reconos-broker] "
+		      "slot %d not available\n", num);
+		return -1;
+	}
+
+	dev->fd = fd;
+	if (osif_fifo_map(dev) < 0) {
+		reconos_broker_release(num);
+		return -1;
+	}
+
+	return 0;
+}
+
+void reconos_broker_release(int num) {
+	struct osif_fifo_dev *dev = &osif_fifo_dev[num];
+
+	if (broker_fd < 0 || dev->fd < 0) {
+		return;
+	}
+
+	if (dev->mapped) {
+		munmap((void *)dev->ptr, getpagesize());
+		dev->mapped = 0;
+	}
+	dev->ptr = NULL;
+	dev->kernel = 0;
+
+	close(dev->fd);
+	dev->fd = -1;
+
+	broker_request(RECONOS_BROKER_RELEASE, num, 0, NULL, NULL, NULL);
+}
+
+int reconos_broker_reconfig(int num, const char *path) {
+	if (broker_fd < 0 || num < 0) {
+		return -1;
+	}
+
+	return broker_request(RECONOS_BROKER_RECONF, num, 0, path, NULL, NULL) < 0 ? -1 : 0;
+}
+
+void *reconos_broker_alloc(size_t size) {
+	size_t count, pages, run, i, j;
+	long page_size;
+
+	if (!broker_arena) {
+		return NULL;
+	}
+
+	page_size = getpagesize();
+	pages = (size + page_size - 1) / page_size;
+	count = broker_arena_size / page_size;
+	if (pages == 0) {
+		pages = 1;
+	}
+
+	pthread_mutex_lock(&broker_lock);
+	for (i = 0, run = 0; i < count; i++) {
+		run = broker_pages[i] ? 0 : run + 1;
+		if (run == pages) {
+			for (j = i + 1 - pages; j <= i; j++) {
+				broker_pages[j] = pages;
+			}
+			pthread_mutex_unlock(&broker_lock);
+
+			return broker_arena + (i + 1 - pages) * page_size;
+		}
+	}
+	pthread_mutex_unlock(&broker_lock);
+
+	return NULL;
+}
+
+int reconos_broker_free(void *ptr) {
+	size_t first, pages, i;
+	long page_size;
+
+	if (!broker_arena || (char *)ptr < broker_arena ||
+	    (char *)ptr >= broker_arena + broker_arena_size) {
+		return -1;
+	}
+
+	page_size = getpagesize();
+	first = ((char *)ptr - broker_arena) / page_size;
+
+	pthread_mutex_lock(&broker_lock);
+	pages = broker_pages[first];
+	for (i = first; i < first + pages; i++) {
+		broker_pages[i] = 0;
+	}
+	pthread_mutex_unlock(&broker_lock);
+
+	return 0;
 }
 
 
@@ -200,22 +729,34 @@ void reconos_proc_control_clear_page_fault(int fd) {
 }
 
 void reconos_proc_control_set_pgd(int fd) {
+	// the broker keeps its own address space
+	if (broker_fd >= 0)
+		return;
+
 	ioctl(fd, RECONOS_PROC_CONTROL_SET_PGD_ADDR, NULL);
 }
 
 void reconos_proc_control_sys_reset(int fd) {
+	// the broker resets slots when they are released
+	if (broker_fd >= 0)
+		return;
+
 	ioctl(fd, RECONOS_PROC_CONTROL_SYS_RESET, NULL);
 }
 
 void reconos_proc_control_hwt_reset(int fd, int num, int reset) {
-	if (reset)
+	if (broker_fd >= 0)
+		broker_request(RECONOS_BROKER_RESET, num, reset, NULL, NULL, NULL);
+	else if (reset)
 		ioctl(fd, RECONOS_PROC_CONTROL_SET_HWT_RESET, &num);
 	else
 		ioctl(fd, RECONOS_PROC_CONTROL_CLEAR_HWT_RESET, &num);
 }
 
 void reconos_proc_control_hwt_signal(int fd, int num, int sig) {
-	if (sig)
+	if (broker_fd >= 0)
+		broker_request(RECONOS_BROKER_SIGNAL, num, sig, NULL, NULL, NULL);
+	else if (sig)
 		ioctl(fd, RECONOS_PROC_CONTROL_SET_HWT_SIGNAL, &num);
 	else
 		ioctl(fd, RECONOS_PROC_CONTROL_CLEAR_HWT_SIGNAL, &num);
@@ -227,6 +768,64 @@ void reconos_proc_control_cache_flush(int fd) {
 #endif
 }
 
+static void proc_control_cache_range(int fd, void *addr, unsigned int len, int op) {
+	struct reconos_cache_range range;
+
+	range.addr = (unsigned long)addr;
+	range.len = len;
+	range.op = op;
+
+	if (ioctl(fd, RECONOS_PROC_CONTROL_CACHE_RANGE, &range) < 0) {
+		whine("[reconos-proc-control] cache maintenance failed\n");
+	}
+}
+
+void reconos_proc_control_cache_clean(int fd, void *addr, unsigned int len) {
+	proc_control_cache_range(fd, addr, len, RECONOS_CACHE_CLEAN);
+}
+
+void reconos_proc_control_cache_invalidate(int fd, void *addr, unsigned int len) {
+	proc_control_cache_range(fd, addr, len, RECONOS_CACHE_INVALIDATE);
+}
+
+int reconos_proc_control_pin(int fd, void *addr, unsigned int len) {
+	struct reconos_mem_range range;
+
+	range.addr = (unsigned long)addr;
+	range.len = len;
+
+	return ioctl(fd, RECONOS_PROC_CONTROL_PIN_RANGE, &range);
+}
+
+void reconos_proc_control_unpin(int fd, void *addr) {
+	struct reconos_mem_range range;
+
+	range.addr = (unsigned long)addr;
+	range.len = 0;
+
+	ioctl(fd, RECONOS_PROC_CONTROL_UNPIN_RANGE, &range);
+}
+
+int reconos_proc_control_get_stats(int fd, int num, uint64_t *count) {
+	struct reconos_hwt_stats stats;
+	int i;
+
+	stats.hwt = num;
+	if (ioctl(fd, RECONOS_PROC_CONTROL_GET_STATS, &stats) < 0) {
+		return -1;
+	}
+
+	for (i = 0; i < RECONOS_STATS_COUNT; i++) {
+		count[i] = stats.count[i];
+	}
+
+	return 0;
+}
+
+void reconos_proc_control_reset_stats(int fd, int num) {
+	ioctl(fd, RECONOS_PROC_CONTROL_RESET_STATS, &num);
+}
+
 void reconos_proc_control_close(int fd) {
 	close(fd);
 }
@@ -267,6 +866,12 @@ void reconos_clock_set_divider(int fd, int clk, int divd) {
 	debug("[reconos-clock] "
 	      "writing divider %d of clock %d ...\n", divd, clk);
 
+	if (!dev->ptr) {
+		whine("[reconos-clock-%d] "
+		      "clock not mapped, ignoring divider\n", fd);
+		return;
+	}
+
 	if (divd < 1 || divd > 126) {
 		whine("[reconos-clock-%d] "
 		      "divider out of range %d\n", fd, divd);
@@ -361,13 +966,147 @@ int load_partial_bitstream(uint32_t *bitstream, unsigned int bitstream_length) {
 
 #endif
 
+#define XDEVCFG_DEV           "/dev/xdevcfg"
+#define XDEVCFG_PARTIAL       "/sys/class/xdevcfg/xdevcfg/device/is_partial_bitstream"
+#define XDEVCFG_PROG_DONE     "/sys/class/xdevcfg/xdevcfg/device/prog_done"
+#define FPGA_MANAGER_FLAGS    "/sys/class/fpga_manager/fpga0/flags"
+#define FPGA_MANAGER_FIRMWARE "/sys/class/fpga_manager/fpga0/firmware"
+#define FPGA_MANAGER_STATE    "/sys/class/fpga_manager/fpga0/state"
+#define FPGA_MANAGER_PREFIX   "/lib/firmware/"
+
+#define DEVCFG_POLL_US 100
+
+/*
+ * Writes a string to a sysfs attribute.
+ */
+static int devcfg_write_attr(const char *attr, const char *value) {
+	int fd, res;
+
+	fd = open(attr, O_WRONLY);
+	if (fd < 0) {
+		whine("[reconos-devcfg] failed to open %s\n", attr);
+		return -1;
+	}
+	res = write(fd, value, strlen(value));
+	close(fd);
+
+	return res < 0 ? -1 : 0;
+}
+
+/*
+ * Waits until a sysfs attribute starts with the given value. The
+ * attribute is reread from its beginning and the thread sleeps in
+ * between to not occupy a cpu.
+ */
+static int devcfg_wait_attr(const char *attr, const char *value) {
+	char buf[32];
+	int fd, len;
+
+	fd = open(attr, O_RDONLY);
+	if (fd < 0) {
+		whine("[reconos-devcfg] failed to open %s\n", attr);
+		return -1;
+	}
+
+	while (1) {
+		len = pread(fd, buf, sizeof(buf) - 1, 0);
+		if (len < 0) {
+			close(fd);
+			return -1;
+		}
+		buf[len] = '\0';
+
+		if (!strncmp(buf, value, strlen(value))) {
+			break;
+		}
+
+		usleep(DEVCFG_POLL_US);
+	}
+	close(fd);
+
+	return 0;
+}
+
+int reconos_devcfg_firmware() {
+	return access(XDEVCFG_DEV, F_OK) != 0;
+}
+
+int reconos_devcfg_program(const char *path, char *data, unsigned int length, int partial) {
+	const char *name;
+	int fd, res;
+
+	if (reconos_devcfg_firmware()) {
+		// the fpga manager loads the bitstream itself from /lib/firmware
+		name = path;
+		if (!strncmp(name, FPGA_MANAGER_PREFIX, strlen(FPGA_MANAGER_PREFIX))) {
+			name += strlen(FPGA_MANAGER_PREFIX);
+		}
+
+		if (devcfg_write_attr(FPGA_MANAGER_FLAGS, partial ? "1" : "0") < 0) {
+			return -1;
+		}
+		if (devcfg_write_attr(FPGA_MANAGER_FIRMWARE, name) < 0) {
+			return -1;
+		}
+
+		return devcfg_wait_attr(FPGA_MANAGER_STATE, "operating");
+	} else {
+		fd = reconos_devcfg_open(partial);
+		if (fd < 0) {
+			return -1;
+		}
+		res = reconos_devcfg_write(fd, data, length);
+		if (reconos_devcfg_close(fd) < 0) {
+			return -1;
+		}
+
+		return res;
+	}
+}
+
+int reconos_devcfg_open(int partial) {
+	int fd;
+
+	if (devcfg_write_attr(XDEVCFG_PARTIAL, partial ? "1" : "0") < 0) {
+		return -1;
+	}
+
+	fd = open(XDEVCFG_DEV, O_WRONLY);
+	if (fd < 0) {
+		whine("[reconos-devcfg] failed to open %s\n", XDEVCFG_DEV);
+		return -1;
+	}
+
+	return fd;
+}
+
+int reconos_devcfg_write(int fd, char *data, unsigned int length) {
+	unsigned int pos;
+	int res;
+
+	for (pos = 0; pos < length; pos += res) {
+		res = write(fd, data + pos, length - pos);
+		if (res <= 0) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+int reconos_devcfg_close(int fd) {
+	close(fd);
+
+	return devcfg_wait_attr(XDEVCFG_PROG_DONE, "1");
+}
+
 
 /* == Initialization function =========================================== */
 
 void reconos_drv_init() {
 	int i;
 	int fd;
-	char *mem;
+	char *mem, *path;
 
 
 	// opening proc control device
@@ -388,6 +1127,12 @@ void reconos_drv_init() {
 		osif_intc_fd = fd;
 
 
+	// connect to the broker, which owns the hardware if running
+	path = getenv(RECONOS_BROKER_ENV);
+	if (path)
+		broker_connect(*path ? path : RECONOS_BROKER_SOCKET);
+
+
 	// reset entire system
 	reconos_proc_control_sys_reset(proc_control_fd);
 
@@ -396,54 +1141,47 @@ void reconos_drv_init() {
 	NUM_HWTS = reconos_proc_control_get_num_hwts(proc_control_fd);
 
 
-	// create mapping for osif
-	fd = open("/dev/mem", O_RDWR | O_SYNC);
-	if (fd < 0)
-		panic("[reconos-osif] "
-		      "failed to open /dev/mem\n");
-
-	mem = (char *)mmap(0, OSIF_FIFO_BASE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, OSIF_FIFO_BASE_ADDR);
-	if (mem == MAP_FAILED)
-		panic("[reconos-osif] "
-		      "failed to mmap osif memory\n");
-
-	close(fd);
-
-
-	// allocate and initialize osif devices
-	osif_fifo_dev = (struct osif_fifo_dev*)malloc(NUM_HWTS * sizeof(struct osif_fifo_dev));
+	// allocate osif devices, which are mapped when opened
+	osif_fifo_dev = (struct osif_fifo_dev*)calloc(NUM_HWTS, sizeof(struct osif_fifo_dev));
 	if (!osif_fifo_dev)
 		panic("[reconos-osif] "
 		      "failed to allocate memory\n");
 
 	for (i = 0; i < NUM_HWTS; i++) {
 		osif_fifo_dev[i].index = i;
-		osif_fifo_dev[i].ptr = (uint32_t *)(mem + i * OSIF_FIFO_MEM_SIZE);
-		osif_fifo_dev[i].fifo_fill = 0;
-		osif_fifo_dev[i].fifo_rem = 0;
+		osif_fifo_dev[i].fd = -1;
 	}
 
 
-	// create mapping for clock
-	fd = open("/dev/mem", O_RDWR | O_SYNC);
-	if (fd < 0)
-		panic("[reconos-clock] "
-		      "failed to open /dev/mem\n");
-
-	mem = (char *)mmap(0, CLOCK_BASE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, CLOCK_BASE_ADDR);
-	if (mem == MAP_FAILED)
-		panic("[reconos-clock] "
-		      "failed to mmap clock memory\n");
-
-	close(fd);
-
-
 	// allocate and initialize clock devices
 	clock_dev = (struct clock_dev*)malloc(sizeof(struct clock_dev));
 	if (!clock_dev)
 		panic("[reconos-clock] "
 		      "failed to allocate memory\n");
 
+	clock_dev->ptr = NULL;
+
+	// the clocks are shared by all applications of the broker
+	if (broker_fd >= 0)
+		return;
+
+
+	// create mapping for clock, which is not exported by the driver
+	fd = open("/dev/mem", O_RDWR | O_SYNC);
+	if (fd < 0) {
+		whine("[reconos-clock] "
+		      "failed to open /dev/mem, clock disabled\n");
+		return;
+	}
+
+	mem = (char *)mmap(0, CLOCK_BASE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, CLOCK_BASE_ADDR);
+	close(fd);
+	if (mem == MAP_FAILED) {
+		whine("[reconos-clock] "
+		      "failed to mmap clock memory, clock disabled\n");
+		return;
+	}
+
 	clock_dev->ptr = (uint32_t *)mem;
 }
 
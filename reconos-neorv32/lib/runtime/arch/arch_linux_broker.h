@@ -0,0 +1 @@
+../../../linux/tools/broker/broker.h
\ No newline at end of file
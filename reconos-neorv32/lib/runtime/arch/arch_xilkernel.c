@@ -159,6 +159,47 @@ void reconos_osif_close(int fd) {
 	// nothing to do here
 }
 
+uint32_t reconos_osif_read_cmd(int fd) {
+	return reconos_osif_read(fd);
+}
+
+int reconos_osif_kbind(int fd, int handle, int kmbox_fd) {
+	// kernel mboxes are not supported
+	return -1;
+}
+
+void reconos_osif_kunbind(int fd) {
+	// nothing to do here
+}
+
+
+/* == Broker related functions ========================================== */
+
+int reconos_broker_connected() {
+	return 0;
+}
+
+int reconos_broker_acquire(int num) {
+	// the slots are not shared
+	return 0;
+}
+
+void reconos_broker_release(int num) {
+	// nothing to do here
+}
+
+int reconos_broker_reconfig(int num, const char *path) {
+	return -1;
+}
+
+void *reconos_broker_alloc(size_t size) {
+	return NULL;
+}
+
+int reconos_broker_free(void *ptr) {
+	return -1;
+}
+
 
 /* == Proc control related functions ==================================== */
 
@@ -172,11 +213,17 @@ void reconos_osif_close(int fd) {
 #define PROC_CONTROL_TLB_MISSES_REG      4
 #define PROC_CONTROL_SYS_RESET_REG       5
 #define PROC_CONTROL_HWT_RESET_REG       6
+#define PROC_CONTROL_PERF_REG(hwt, cnt)  (PROC_CONTROL_HWT_RESET_REG + \
+                                          2 * ((NUM_HWTS - 1) / 32 + 1) + \
+                                          (hwt) * PROC_CONTROL_PERF_COUNT + (cnt))
+#define PROC_CONTROL_PERF_COUNT          6
 
 struct proc_control_dev {
 	volatile uint32_t *ptr;
 	uint32_t *hwt_reset;
 	size_t hwt_reset_count;
+	uint64_t *stats;
+	uint32_t *stats_last;
 };
 
 struct proc_control_dev proc_control_dev;
@@ -217,6 +264,12 @@ void reconos_proc_control_sys_reset(int fd) {
 	for (i = 0; i < NUM_HWTS; i++)
 		proc_control_dev.hwt_reset[i] = 0xFFFFFFFF;
 	proc_control_dev.ptr[PROC_CONTROL_SYS_RESET_REG] = 0;
+
+	// the reset clears the hardware counters as well
+	for (i = 0; i < NUM_HWTS * PROC_CONTROL_PERF_COUNT; i++) {
+		proc_control_dev.stats[i] = 0;
+		proc_control_dev.stats_last[i] = 0;
+	}
 }
 
 void reconos_proc_control_hwt_reset(int fd, int num, int reset) {
@@ -246,6 +299,53 @@ void reconos_proc_control_cache_flush(int fd) {
 		asm volatile ("wdc.flush %0, %1;" :: "d" (baseaddr), "d" (i));
 }
 
+void reconos_proc_control_cache_clean(int fd, void *addr, unsigned int len) {
+	reconos_proc_control_cache_flush(fd);
+}
+
+void reconos_proc_control_cache_invalidate(int fd, void *addr, unsigned int len) {
+	reconos_proc_control_cache_flush(fd);
+}
+
+int reconos_proc_control_pin(int fd, void *addr, unsigned int len) {
+	return 0;
+}
+
+void reconos_proc_control_unpin(int fd, void *addr) {
+}
+
+int reconos_proc_control_get_stats(int fd, int num, uint64_t *count) {
+	uint32_t data;
+	int i;
+
+	if (num < 0 || num >= NUM_HWTS)
+		return -1;
+
+	// accumulate the wrapping 32 bit hardware counters
+	for (i = 0; i < PROC_CONTROL_PERF_COUNT; i++) {
+		data = proc_control_dev.ptr[PROC_CONTROL_PERF_REG(num, i)];
+		proc_control_dev.stats[num * PROC_CONTROL_PERF_COUNT + i] +=
+		      (uint32_t)(data - proc_control_dev.stats_last[num * PROC_CONTROL_PERF_COUNT + i]);
+		proc_control_dev.stats_last[num * PROC_CONTROL_PERF_COUNT + i] = data;
+
+		count[i] = proc_control_dev.stats[num * PROC_CONTROL_PERF_COUNT + i];
+	}
+
+	return 0;
+}
+
+void reconos_proc_control_reset_stats(int fd, int num) {
+	int i;
+
+	if (num >= 0 && num < NUM_HWTS) {
+		for (i = 0; i < PROC_CONTROL_PERF_COUNT; i++) {
+			proc_control_dev.ptr[PROC_CONTROL_PERF_REG(num, i)] = 0;
+			proc_control_dev.stats[num * PROC_CONTROL_PERF_COUNT + i] = 0;
+			proc_control_dev.stats_last[num * PROC_CONTROL_PERF_COUNT + i] = 0;
+		}
+	}
+}
+
 void reconos_proc_control_close(int fd) {
 	// nothing to do here
 }
@@ -292,6 +392,32 @@ int load_partial_bitstream(uint32_t *bitstream, unsigned int bitstream_length) {
 		return -1;
 }
 
+int reconos_devcfg_firmware() {
+	return 0;
+}
+
+int reconos_devcfg_open(int partial) {
+	if (!partial) {
+		panic("NOT IMPLEMENTED YET\n");
+	}
+
+	return 0;
+}
+
+int reconos_devcfg_write(int fd, char *data, unsigned int length) {
+	return load_partial_bitstream((uint32_t *)data, length / 4);
+}
+
+int reconos_devcfg_close(int fd) {
+	return 0;
+}
+
+int reconos_devcfg_program(const char *path, char *data, unsigned int length, int partial) {
+	reconos_devcfg_open(partial);
+
+	return reconos_devcfg_write(0, data, length);
+}
+
 
 /* == Initialization function =========================================== */
 
@@ -308,6 +434,12 @@ void reconos_drv_init() {
 	if (!proc_control_dev.hwt_reset)
 		panic("[reconos-proc-control] failed to allocate memory\n");
 
+	// allocate memory for the accumulated performance counters
+	proc_control_dev.stats = (uint64_t*)calloc(NUM_HWTS * PROC_CONTROL_PERF_COUNT, sizeof(uint64_t));
+	proc_control_dev.stats_last = (uint32_t*)calloc(NUM_HWTS * PROC_CONTROL_PERF_COUNT, sizeof(uint32_t));
+	if (!proc_control_dev.stats || !proc_control_dev.stats_last)
+		panic("[reconos-proc-control] failed to allocate memory\n");
+
 
 	// reset entire system
 	for (i = 0; i < proc_control_dev.hwt_reset_count; i++)
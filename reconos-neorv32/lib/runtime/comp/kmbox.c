@@ -0,0 +1,81 @@
+/*
+ *                                                        ____  _____
+ *                            ________  _________  ____  / __ \/ ___/
+ *                           / ___/ _ \/ ___/ __ \/ __ \/ / / /\__ \
+ *                          / /  /  __/ /__/ /_/ / / / / /_/ /___/ /
+ *                         /_/   \___/\___/\____/_/ /_/\____//____/
+ *
+ * ======================================================================
+ *
+ *   title:        Kernel mbox
+ *
+ *   project:      ReconOS
+ *   author:       Christoph Rüthing, University of Paderborn
+ *   description:  Mailbox residing in the ReconOS driver (Linux only).
+ *
+ * ======================================================================
+ */
+
+#if defined(RECONOS_OS_linux)
+
+#include "kmbox.h"
+#include "../utils.h"
+#include "../arch/arch_linux_kernel.h"
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+
+#define KMBOX_DEV "/dev/reconos-mbox"
+
+int kmbox_init(struct kmbox *mb, size_t size) {
+	unsigned int words = size;
+
+	mb->fd = open(KMBOX_DEV, O_RDWR);
+	if (mb->fd < 0) {
+		whine("[reconos-kmbox] "
+		      "unable to open kernel mbox device\n");
+		return -1;
+	}
+
+	if (ioctl(mb->fd, RECONOS_MBOX_INIT, &words) < 0) {
+		whine("[reconos-kmbox] "
+		      "unable to initialize kernel mbox\n");
+		close(mb->fd);
+		mb->fd = -1;
+		return -1;
+	}
+
+	return 0;
+}
+
+void kmbox_destroy(struct kmbox *mb) {
+	close(mb->fd);
+	mb->fd = -1;
+}
+
+int kmbox_put(struct kmbox *mb, uint32_t msg) {
+	if (write(mb->fd, &msg, sizeof(uint32_t)) != sizeof(uint32_t)) {
+		return -1;
+	}
+
+	return 0;
+}
+
+int kmbox_get(struct kmbox *mb, uint32_t *msg) {
+	if (read(mb->fd, msg, sizeof(uint32_t)) != sizeof(uint32_t)) {
+		return -1;
+	}
+
+	return 0;
+}
+
+int kmbox_tryget(struct kmbox *mb, uint32_t *msg) {
+	return ioctl(mb->fd, RECONOS_MBOX_TRYGET, msg) == 0;
+}
+
+int kmbox_tryput(struct kmbox *mb, uint32_t msg) {
+	return ioctl(mb->fd, RECONOS_MBOX_TRYPUT, &msg) == 0;
+}
+
+#endif
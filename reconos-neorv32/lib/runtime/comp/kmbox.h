@@ -0,0 +1,98 @@
+/*
+ *                                                        ____  _____
+ *                            ________  _________  ____  / __ \/ ___/
+ *                           / ___/ _ \/ ___/ __ \/ __ \/ / / /\__ \
+ *                          / /  /  __/ /__/ /_/ / / / / /_/ /___/ /
+ *                         /_/   \___/\___/\____/_/ /_/\____//____/
+ *
+ * ======================================================================
+ *
+ *   title:        Kernel mbox
+ *
+ *   project:      ReconOS
+ *   author:       Christoph Rüthing, University of Paderborn
+ *   description:  Mailbox residing in the ReconOS driver (Linux only).
+ *                 Hardware threads access it without involving their
+ *                 delegate thread if passed as a resource of type
+ *                 RECONOS_RESOURCE_TYPE_KMBOX.
+ *
+ * ======================================================================
+ */
+
+#ifndef KMBOX_H
+#define KMBOX_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Structure representing a kernel mbox
+ *
+ *   fd - file descriptor of the mbox device
+ */
+struct kmbox {
+	int fd;
+};
+
+/*
+ * Initializes the mbox. You must call this method before you
+ * can use the mbox.
+ *
+ *   mb   - pointer to the mbox
+ *   size - size of the mbox in 32bit-words
+ *
+ *   returns 0 on success, -1 on failure
+ */
+extern int kmbox_init(struct kmbox *mb, size_t size);
+
+/*
+ * Frees the mbox. Hardware threads still using it keep it alive
+ * until they exit.
+ *
+ *   mb - pointer to the mbox
+ */
+extern void kmbox_destroy(struct kmbox *mb);
+
+/*
+ * Puts a single word into the mbox and blocks if it is full.
+ *
+ *   mb  - pointer to the mbox
+ *   msg - message to put into the mbox
+ *
+ *   returns 0 on success, -1 if interrupted
+ */
+extern int kmbox_put(struct kmbox *mb, uint32_t msg);
+
+/*
+ * Gets a single word out of the mbox and blocks if it is empty.
+ *
+ *   mb  - pointer to the mbox
+ *   msg - pointer to store the message in
+ *
+ *   returns 0 on success, -1 if interrupted
+ */
+extern int kmbox_get(struct kmbox *mb, uint32_t *msg);
+
+/*
+ * Tries to get a single word out of the mbox but does not block.
+ *
+ *   mb  - pointer to the mbox
+ *   msg - pointer to store the message in
+ *         (only valid if returns true)
+ *
+ *   returns if a word was read or not
+ */
+extern int kmbox_tryget(struct kmbox *mb, uint32_t *msg);
+
+/*
+ * Tries to put a single word into the mbox but does not block.
+ *
+ *   mb  - pointer to the mbox
+ *   msg - data to put into the mbox
+ *         (only stored in the mbox if returns true)
+ *
+ *   returns if the word could be stored in the mbox
+ */
+extern int kmbox_tryput(struct kmbox *mb, uint32_t msg);
+
+#endif /* KMBOX_H */
@@ -37,6 +37,98 @@
 void *proc_pgfhandler(void *arg);
 
 
+/* == ReconOS bitstream ================================================ */
+
+/*
+ * Object representing a bitstream loaded into memory. Bitstreams are
+ * cached process-wide by their path and shared between all threads.
+ *
+ *   path   - path of the bitstream in the filesystem
+ *   data   - contents of the bitstream
+ *   length - length of the bitstream in bytes
+ *   mapped - indicates if data is mapped from the file
+ *   next   - next bitstream in the cache
+ */
+struct bitstream {
+	char *path;
+	char *data;
+	int length;
+	int mapped;
+
+	struct bitstream *next;
+};
+
+/*
+ * Returns the bitstream of the given path. The bitstream is only
+ * loaded from the filesystem if it is not already in the cache.
+ *
+ *   path - path of the bitstream
+ *
+ *   @returns pointer to the cached bitstream
+ */
+struct bitstream *bitstream_get(const char *path);
+
+/*
+ * Definition of the compressed bitstream format (see rdk compress_hw).
+ * All fields are 32 bit words:
+ *
+ *   magic  - BITSTREAM_RLE_MAGIC
+ *   length - length of the uncompressed bitstream in bytes
+ *   blocks - sequence of blocks, each starting with a control word
+ *            run | n: the next word is repeated n times
+ *            n:       the next n words are copied
+ */
+#define BITSTREAM_RLE_MAGIC      0x454C5252
+#define BITSTREAM_RLE_RUN        0x80000000
+#define BITSTREAM_RLE_COUNT_MASK 0x7FFFFFFF
+
+/*
+ * Definition of the number of words written to the configuration port
+ * at once when decompressing a bitstream.
+ */
+#define BITSTREAM_CHUNK_WORDS    1024
+
+/*
+ * Programs the bitstream via the configuration port. Compressed
+ * bitstreams are decompressed in chunks of BITSTREAM_CHUNK_WORDS
+ * while writing them, so they are never held uncompressed in memory.
+ *
+ *   bs      - pointer to the bitstream
+ *   partial - one for a partial, zero for a full bitstream
+ *
+ *   @returns 0 on success, negative on failure
+ */
+int bitstream_program(struct bitstream *bs, int partial);
+
+
+/* == ReconOS reconfiguration ========================================== */
+
+/*
+ * Submits a bitstream to the reconfiguration manager like
+ * reconos_reconfig_submit, additionally naming the thread the bitstream
+ * contains to record it for the slot.
+ *
+ *   slot     - slot to reconfigure or RECONOS_RECONFIG_FULL
+ *   path     - path of the bitstream
+ *   kernel   - name of the thread the bitstream contains (can be null)
+ *   callback - callback executed on completion (can be null)
+ *   arg      - argument passed to the callback
+ *
+ *   @returns pointer to the request
+ */
+struct reconos_reconfig *reconfig_submit(int slot, char *path,
+                                         const char *kernel,
+                                         reconos_reconfig_callback callback,
+                                         void *arg);
+
+/*
+ * Processes the queued reconfiguration requests one after another and
+ * thereby serializes all accesses to the configuration port.
+ *
+ *   arg - null
+ */
+void *reconfig_manager(void *arg);
+
 /* == ReconOS hwslot =================================================== */
 
 /*
@@ -75,6 +167,13 @@ void *proc_pgfhandler(void *arg);
  *   dt_state  - state of the delegate thread
  *   dt_flags  - flags to the delegate thread
  *   dt_exit   - semaphore for synchronizing with the delegate on exit
+ *
+ *   kernel    - name of the thread the slot is configured for
+ *               (null if unknown)
+ *   used      - time stamp of the last use for the lru eviction
+ *   reserved  - picked for a thread while reconfiguring it
+ *   invalid   - indicates a failed reconfiguration, which must be
+ *               repeated before executing a thread in the slot
  */
 struct hwslot {
 	int id;
@@ -86,6 +185,11 @@ struct hwslot {
 	int dt_state;
 	int dt_flags;
 	sem_t dt_exit;
+
+	const char *kernel;
+	unsigned long used;
+	int reserved;
+	int invalid;
 };
 
 /*
@@ -118,6 +222,14 @@ void hwslot_setreset(struct hwslot *slot, int reset);
  */
 void hwslot_setsignal(struct hwslot *slot, int sig);
 
+/*
+ * Applies the scheduling attributes of the running thread to the
+ * delegate thread of the slot.
+ *
+ *   slot - pointer to the ReconOS slot
+ */
+void hwslot_setsched(struct hwslot *slot);
+
 /*
  * Creates a new delegate thread if not present.
  *
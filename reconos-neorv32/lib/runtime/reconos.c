@@ -21,25 +21,34 @@
  * ======================================================================
  */
 
+#define _GNU_SOURCE
+
 #include "reconos.h"
 #include "private.h"
 #include "arch/arch.h"
 #include "comp/mbox.h"
+#include "comp/kmbox.h"
 
 #include <unistd.h>
 #include <signal.h>
 #include <pthread.h>
 #include <sched.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 
 int RECONOS_NUM_HWTS = 0;
 
 static struct hwslot *_hwslots;
+static pthread_mutex_t _hwslots_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned long _hwslots_clock;
 static int _proc_control;
 static int _clock;
 static pthread_t _pgf_handler;
 static struct sigaction _dt_signal;
 static int _thread_id;
+static struct reconos_options _options;
 
 
 /* == ReconOS resource ================================================= */
@@ -110,6 +119,10 @@ void reconos_thread_init(struct reconos_thread *rt,
 
 	rt->bitstreams = NULL;
 	rt->bitstream_lengths = NULL;
+	rt->bitstream_path = NULL;
+
+	rt->priority = RECONOS_THREAD_PRIORITY_DEFAULT;
+	rt->deadline = RECONOS_THREAD_DEADLINE_NONE;
 }
 
 /*
@@ -119,6 +132,24 @@ void reconos_thread_setinitdata(struct reconos_thread *rt, void *init_data) {
 	rt->init_data = init_data;
 }
 
+/*
+ * Frees the bitstream arrays of the thread if they were allocated when
+ * loading the bitstreams from the filesystem. The bitstreams themselves
+ * stay cached.
+ *
+ *   rt - pointer to the ReconOS thread
+ */
+static void thread_freebitstream(struct reconos_thread *rt) {
+	if (!rt->bitstream_path) {
+		return;
+	}
+
+	free(rt->bitstreams);
+	free(rt->bitstream_lengths);
+	rt->bitstreams = NULL;
+	rt->bitstream_lengths = NULL;
+}
+
 /*
  * @see header
  */
@@ -139,6 +170,11 @@ void reconos_thread_setallowedslots(struct reconos_thread *rt,
 	for (i = 0; i < rt->allowed_hwslot_count; i++) {
 		rt->allowed_hwslots[i] = &_hwslots[slots[i]];
 	}
+
+	// loaded bitstreams only cover the previously allowed slots
+	if (rt->bitstream_path) {
+		reconos_thread_loadbitstream(rt, rt->bitstream_path);
+	}
 }
 
 /*
@@ -176,50 +212,79 @@ void reconos_thread_setresourcepointers(struct reconos_thread *rt,
 void reconos_thread_setbitstream(struct reconos_thread *rt,
                                  char **bitstreams,
                                  int *bitstream_lengths) {
+	thread_freebitstream(rt);
+	free(rt->bitstream_path);
+	rt->bitstream_path = NULL;
+
 	rt->bitstreams = bitstreams;
 	rt->bitstream_lengths = bitstream_lengths;
 }
 
+/*
+ * Replaces each %d in the bitstream path by the slot id.
+ *
+ *   buf  - buffer to write the path into
+ *   path - path of the bitstreams
+ *   slot - slot id
+ */
+static void bitstream_path(char *buf, const char *path, int slot) {
+	while (*path) {
+		if (path[0] == '%' && path[1] == 'd') {
+			buf += sprintf(buf, "%d", slot);
+			path += 2;
+		} else {
+			*buf++ = *path++;
+		}
+	}
+	*buf = '\0';
+}
+
 /*
  * @see header
  */
 void reconos_thread_loadbitstream(struct reconos_thread *rt,
                                   char *path) {
-	FILE *file;
-	unsigned int i, size;
+	struct bitstream *bs;
+	char *old_path, *slot_path;
+	int i;
 
 	debug("[reconos-core] loading bitstreams from %s\n", path);
 
-	rt->bitstream_lengths = (int *)malloc(RECONOS_NUM_HWTS * sizeof(int));
+	thread_freebitstream(rt);
+
+	// path may be the previous path of the thread
+	old_path = rt->bitstream_path;
+	rt->bitstream_path = strdup(path);
+	if (!rt->bitstream_path) {
+		panic("[reconos-core] ERROR: failed to allocate memory for bitstream");
+	}
+	free(old_path);
+
+	rt->bitstream_lengths = (int *)calloc(RECONOS_NUM_HWTS, sizeof(int));
 	if (!rt->bitstream_lengths) {
 		panic("[reconos-core] ERROR: failed to allocate memory for bitstream");
 	}
 
-	rt->bitstreams = (char **)malloc(RECONOS_NUM_HWTS * sizeof(char *));
+	rt->bitstreams = (char **)calloc(RECONOS_NUM_HWTS, sizeof(char *));
 	if (!rt->bitstreams) {
 		panic("[reconos-core] ERROR: failed to allocate memory for bitstream");
 	}
 
-	for (i = 0; i < RECONOS_NUM_HWTS; i++) {
-		file = fopen(path, "rb");
-		if (!file) {
-			panic("[reconos-core] ERROR: failed to open bitstream\n");
-		}
-
-		fseek(file, 0L, SEEK_END);
-		size = ftell(file);
-		rewind(file);
-
-		rt->bitstream_lengths[i] = size;
-		rt->bitstreams[i] = (char *)malloc(size * sizeof(char));
-		if (!rt->bitstreams[i]) {
-			panic("[reconos-core] ERROR: failed to allocate memory for bitstream\n");
-		}
+	// a slot id has at most 10 digits
+	slot_path = (char *)malloc(strlen(path) * 5 + 1);
+	if (!slot_path) {
+		panic("[reconos-core] ERROR: failed to allocate memory for bitstream");
+	}
 
-		fread(rt->bitstreams[i], sizeof(char), size, file);
+	for (i = 0; i < rt->allowed_hwslot_count; i++) {
+		bitstream_path(slot_path, path, rt->allowed_hwslots[i]->id);
+		bs = bitstream_get(slot_path);
 
-		fclose(file);
+		rt->bitstreams[rt->allowed_hwslots[i]->id] = bs->data;
+		rt->bitstream_lengths[rt->allowed_hwslots[i]->id] = bs->length;
 	}
+
+	free(slot_path);
 }
 
 /*
@@ -230,6 +295,24 @@ void reconos_thread_setswentry(struct reconos_thread *rt,
 	rt->swentry = swentry;
 }
 
+/*
+ * @see header
+ */
+void reconos_thread_setpriority(struct reconos_thread *rt, int priority) {
+	rt->priority = priority;
+
+	if (rt->state == RECONOS_THREAD_STATE_RUNNING_HW) {
+		hwslot_setsched(rt->hwslot);
+	}
+}
+
+/*
+ * @see header
+ */
+void reconos_thread_setdeadline(struct reconos_thread *rt, int deadline) {
+	rt->deadline = deadline;
+}
+
 /*
  * @see header
  */
@@ -253,29 +336,126 @@ void reconos_thread_create(struct reconos_thread *rt, int slot) {
 		panic("[reconos-core] ERROR: thread not allowed to run in slot\n");
 	}
 
+	if (reconos_broker_acquire(slot) < 0) {
+		panic("[reconos-core] ERROR: slot %d leased by another application\n", slot);
+	}
+
 	rt->hwslot = &_hwslots[slot];
 	hwslot_createthread(rt->hwslot, rt);
 	rt->state = RECONOS_THREAD_STATE_RUNNING_HW;
 }
 
+/*
+ * Reconfigures the slot with the bitstream of the thread and blocks
+ * until the reconfiguration finished.
+ *
+ *   rt   - pointer to the ReconOS thread
+ *   slot - pointer to the ReconOS slot
+ *
+ *   @returns 0 on success, negative on failure
+ */
+static int thread_reconfigure(struct reconos_thread *rt, struct hwslot *slot) {
+	struct reconos_reconfig *rr;
+	char *path;
+	int res;
+
+	path = (char *)malloc(strlen(rt->bitstream_path) * 5 + 1);
+	if (!path) {
+		panic("[reconos-core] ERROR: failed to allocate memory for bitstream");
+	}
+	bitstream_path(path, rt->bitstream_path, slot->id);
+
+	debug("[reconos-core] evicting %s from slot %d\n",
+	      slot->kernel ? slot->kernel : "unknown", slot->id);
+
+	rr = reconfig_submit(slot->id, path, rt->name, NULL, NULL);
+	res = reconos_reconfig_wait(rr);
+	reconos_reconfig_free(rr);
+	free(path);
+
+	return res;
+}
+
 /*
  * @see header
  */
 void reconos_thread_create_auto(struct reconos_thread *rt, int tt) {
-	int i;
+	struct hwslot *slot, *unknown, *lru;
+	char *leased;
+	int reconf, i;
 
 	if (tt & RECONOS_THREAD_HW) {
+		// slots leased by other applications are skipped on retry
+		leased = (char *)calloc(RECONOS_NUM_HWTS, sizeof(char));
+		if (!leased) {
+			panic("[reconos-core] ERROR: failed to allocate memory\n");
+		}
+
+		pthread_mutex_lock(&_hwslots_lock);
+
+retry:
+		slot = unknown = lru = NULL;
 		for (i = 0; i < rt->allowed_hwslot_count; i++) {
-			if (!rt->allowed_hwslots[i]->rt) {
-				break;
+			if (rt->allowed_hwslots[i]->rt || rt->allowed_hwslots[i]->reserved
+			    || leased[rt->allowed_hwslots[i]->id]) {
+				continue;
+			}
+
+			// invalid slots are only used by reconfiguring them first
+			if (!rt->allowed_hwslots[i]->invalid) {
+				if (!rt->name || !rt->allowed_hwslots[i]->kernel) {
+					if (!unknown) {
+						unknown = rt->allowed_hwslots[i];
+					}
+					continue;
+				}
+
+				if (!strcmp(rt->allowed_hwslots[i]->kernel, rt->name)) {
+					slot = rt->allowed_hwslots[i];
+					break;
+				}
+			}
+
+			if (!lru || rt->allowed_hwslots[i]->used < lru->used) {
+				lru = rt->allowed_hwslots[i];
 			}
 		}
-		if (i == rt->allowed_hwslot_count) {
-			whine("[reconos_core] WARNING: no free slot for thread found");
-			return;
+
+		reconf = 0;
+		if (!slot) {
+			slot = unknown;
+		}
+		if (!slot && lru && rt->bitstream_path) {
+			slot = lru;
+			reconf = 1;
+		}
+		if (!slot) {
+			pthread_mutex_unlock(&_hwslots_lock);
+			whine("[reconos-core] WARNING: no free slot for thread found\n");
+			goto out;
+		}
+		if (reconos_broker_acquire(slot->id) < 0) {
+			leased[slot->id] = 1;
+			goto retry;
+		}
+
+		// the reservation keeps the slot while reconfiguring unlocked
+		slot->reserved = 1;
+		pthread_mutex_unlock(&_hwslots_lock);
+
+		if (reconf && thread_reconfigure(rt, slot) < 0) {
+			whine("[reconos-core] WARNING: failed to reconfigure slot %d\n", slot->id);
+			reconos_broker_release(slot->id);
+		} else {
+			reconos_thread_create(rt, slot->id);
 		}
 
-		reconos_thread_create(rt, rt->allowed_hwslots[i]->id);
+		pthread_mutex_lock(&_hwslots_lock);
+		slot->reserved = 0;
+		pthread_mutex_unlock(&_hwslots_lock);
+
+out:
+		free(leased);
 	} else if (tt & RECONOS_THREAD_SW) {
 		pthread_create(&rt->swslot, 0, rt->swentry, (void*)rt);
 	}
@@ -327,6 +507,11 @@ void reconos_thread_resume(struct reconos_thread *rt, int slot) {
 		panic("[reconos-core] ERROR: thread not allowed to run in slot\n");
 	}
 
+	if (reconos_broker_acquire(slot) < 0) {
+		panic("[reconos-core] ERROR: slot %d leased by another application\n", slot);
+	}
+
+	rt->hwslot = &_hwslots[slot];
 	hwslot_resumethread(rt->hwslot, rt);
 	rt->state = RECONOS_THREAD_STATE_RUNNING_HW;
 }
@@ -348,6 +533,32 @@ void reconos_thread_signal(struct reconos_thread *rt) {
 
 /* == General functions ================================================ */
 
+/*
+ * Initializes the attributes for creating delegate threads by
+ * applying the cpu affinity of the options.
+ *
+ *   attr - pointer to the thread attributes
+ */
+static void dt_attr_init(pthread_attr_t *attr) {
+	cpu_set_t cpus;
+	int i;
+
+	pthread_attr_init(attr);
+
+	if (_options.dt_cpus) {
+		CPU_ZERO(&cpus);
+		for (i = 0; i < sizeof(_options.dt_cpus) * 8; i++) {
+			if ((_options.dt_cpus >> i) & 0x1) {
+				CPU_SET(i, &cpus);
+			}
+		}
+
+		if (pthread_attr_setaffinity_np(attr, sizeof(cpu_set_t), &cpus)) {
+			whine("[reconos-core] WARNING: unable to set delegate affinity\n");
+		}
+	}
+}
+
 /*
  * Signal handler for exiting the program
  *
@@ -370,11 +581,42 @@ void delegate_signal(int sig) {
 	debug("[reconos-core] delegate received signal\n");
 }
 
+/*
+ * @see header
+ */
+void reconos_options_init(struct reconos_options *opts) {
+	opts->dt_cpus = 0;
+	opts->dt_policy = SCHED_OTHER;
+	opts->dt_priority = 0;
+	opts->mlock = 0;
+	opts->bitstream_mmap = 0;
+}
+
 /*
  * @see header
  */
 void reconos_init() {
+	struct reconos_options opts;
+
+	reconos_options_init(&opts);
+	reconos_init_opts(&opts);
+}
+
+/*
+ * @see header
+ */
+void reconos_init_opts(struct reconos_options *opts) {
 	int i, osif;
+	struct sched_param param;
+	pthread_attr_t attr;
+
+	_options = *opts;
+
+	if (_options.mlock) {
+		if (mlockall(MCL_CURRENT | MCL_FUTURE)) {
+			whine("[reconos-core] WARNING: unable to lock memory\n");
+		}
+	}
 
 	signal(SIGINT, exit_signal);
 	signal(SIGTERM, exit_signal);
@@ -417,7 +659,17 @@ void reconos_init() {
 	reconos_proc_control_set_pgd(_proc_control);
 
 #ifdef RECONOS_OS_linux
-	pthread_create(&_pgf_handler, NULL, proc_pgfhandler, NULL);
+	// the broker handles the page faults in its address space
+	if (reconos_broker_connected()) {
+		return;
+	}
+
+	dt_attr_init(&attr);
+	pthread_create(&_pgf_handler, &attr, proc_pgfhandler, NULL);
+	pthread_attr_destroy(&attr);
+
+	param.sched_priority = _options.dt_priority;
+	pthread_setschedparam(_pgf_handler, _options.dt_policy, &param);
 #endif
 }
 
@@ -435,6 +687,105 @@ void reconos_cache_flush() {
 	reconos_proc_control_cache_flush(_proc_control);
 }
 
+/*
+ * @see header
+ */
+void reconos_cache_clean(void *ptr, size_t len) {
+	reconos_proc_control_cache_clean(_proc_control, ptr, len);
+}
+
+/*
+ * @see header
+ */
+void reconos_cache_invalidate(void *ptr, size_t len) {
+	reconos_proc_control_cache_invalidate(_proc_control, ptr, len);
+}
+
+/*
+ * @see header
+ */
+void *reconos_alloc_shared(size_t size, int flags) {
+	void *ptr;
+	long page_size;
+
+	page_size = sysconf(_SC_PAGESIZE);
+	size = (size + page_size - 1) & ~(page_size - 1);
+
+	// with the broker only its arena is visible to hardware threads
+	if (reconos_broker_connected()) {
+		ptr = reconos_broker_alloc(size);
+		if (!ptr) {
+			panic("[reconos-core] ERROR: arena of the broker exhausted\n");
+		}
+
+		memset(ptr, 0, size);
+		return ptr;
+	}
+
+	if (posix_memalign(&ptr, page_size, size)) {
+		panic("[reconos-core] ERROR: failed to allocate shared memory\n");
+	}
+
+	// writing faults in private pages for reading and writing
+	memset(ptr, 0, size);
+
+	if ((flags & RECONOS_ALLOC_PIN) && _hwslots) {
+		if (reconos_proc_control_pin(_proc_control, ptr, size) < 0) {
+			whine("[reconos-core] WARNING: unable to pin shared memory\n");
+		}
+	}
+
+	return ptr;
+}
+
+/*
+ * @see header
+ */
+void reconos_free_shared(void *ptr) {
+	if (reconos_broker_free(ptr) == 0) {
+		return;
+	}
+
+	if (_hwslots) {
+		reconos_proc_control_unpin(_proc_control, ptr);
+	}
+
+	free(ptr);
+}
+
+/*
+ * @see header
+ */
+int reconos_stats_get(int slot, struct reconos_stats *stats) {
+	uint64_t count[6];
+
+	if (slot < 0 || slot >= RECONOS_NUM_HWTS) {
+		return -1;
+	}
+
+	if (reconos_proc_control_get_stats(_proc_control, slot, count) < 0) {
+		return -1;
+	}
+
+	stats->bytes_read = count[0];
+	stats->bytes_written = count[1];
+	stats->stall_cycles = count[2];
+	stats->tlb_hits = count[3];
+	stats->tlb_misses = count[4];
+	stats->page_faults = count[5];
+
+	return 0;
+}
+
+/*
+ * @see header
+ */
+void reconos_stats_reset(int slot) {
+	if (slot >= 0 && slot < RECONOS_NUM_HWTS) {
+		reconos_proc_control_reset_stats(_proc_control, slot);
+	}
+}
+
 
 /* == ReconOS proc control============================================== */
 
@@ -456,6 +807,384 @@ void *proc_pgfhandler(void *arg) {
 	}
 }
 
+/* == ReconOS bitstream ================================================ */
+
+static struct bitstream *_bitstreams;
+static pthread_mutex_t _bitstreams_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * @see header
+ */
+struct bitstream *bitstream_get(const char *path) {
+	struct bitstream *bs;
+	struct stat st;
+	int fd, i, ret;
+
+	pthread_mutex_lock(&_bitstreams_lock);
+
+	for (bs = _bitstreams; bs; bs = bs->next) {
+		if (!strcmp(bs->path, path)) {
+			pthread_mutex_unlock(&_bitstreams_lock);
+			return bs;
+		}
+	}
+
+	debug("[reconos-core] loading bitstream %s\n", path);
+
+	bs = (struct bitstream *)malloc(sizeof(struct bitstream));
+	if (!bs) {
+		panic("[reconos-core] ERROR: failed to allocate memory for bitstream\n");
+	}
+
+	bs->path = strdup(path);
+	if (!bs->path) {
+		panic("[reconos-core] ERROR: failed to allocate memory for bitstream\n");
+	}
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0 || fstat(fd, &st) < 0) {
+		panic("[reconos-core] ERROR: failed to open bitstream %s\n", path);
+	}
+
+	bs->length = st.st_size;
+	bs->mapped = _options.bitstream_mmap;
+
+	if (bs->mapped) {
+		bs->data = (char *)mmap(NULL, bs->length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (bs->data == MAP_FAILED) {
+			panic("[reconos-core] ERROR: failed to map bitstream %s\n", path);
+		}
+	} else {
+		bs->data = (char *)malloc(bs->length);
+		if (!bs->data) {
+			panic("[reconos-core] ERROR: failed to allocate memory for bitstream\n");
+		}
+
+		for (i = 0; i < bs->length; i += ret) {
+			ret = read(fd, bs->data + i, bs->length - i);
+			if (ret <= 0) {
+				panic("[reconos-core] ERROR: failed to read bitstream %s\n", path);
+			}
+		}
+	}
+
+	close(fd);
+
+	bs->next = _bitstreams;
+	_bitstreams = bs;
+
+	pthread_mutex_unlock(&_bitstreams_lock);
+
+	return bs;
+}
+
+/*
+ * @see header
+ */
+int bitstream_program(struct bitstream *bs, int partial) {
+	uint32_t chunk[BITSTREAM_CHUNK_WORDS];
+	uint32_t *in, *end, ctrl, count, length;
+	int fd, fill, res;
+
+	in = (uint32_t *)bs->data;
+	end = (uint32_t *)(bs->data + bs->length);
+
+	if (bs->length < 8 || in[0] != BITSTREAM_RLE_MAGIC) {
+		return reconos_devcfg_program(bs->path, bs->data, bs->length, partial);
+	}
+
+	fd = reconos_devcfg_open(partial);
+	if (fd < 0) {
+		return -1;
+	}
+
+	length = in[1];
+	in += 2;
+	fill = 0;
+	res = 0;
+
+	while (in < end && res == 0) {
+		ctrl = *in++;
+		count = ctrl & BITSTREAM_RLE_COUNT_MASK;
+
+		if (in + ((ctrl & BITSTREAM_RLE_RUN) ? 1 : count) > end || count > length / 4) {
+			res = -1;
+			break;
+		}
+		length -= count * 4;
+
+		while (count > 0 && res == 0) {
+			chunk[fill++] = (ctrl & BITSTREAM_RLE_RUN) ? *in : *in++;
+			count--;
+
+			if (fill == BITSTREAM_CHUNK_WORDS) {
+				res = reconos_devcfg_write(fd, (char *)chunk, sizeof(chunk));
+				fill = 0;
+			}
+		}
+
+		if (ctrl & BITSTREAM_RLE_RUN) {
+			in++;
+		}
+	}
+
+	if (res == 0 && fill > 0) {
+		res = reconos_devcfg_write(fd, (char *)chunk, fill * 4);
+	}
+	if (res == 0 && length != 0) {
+		res = -1;
+	}
+
+	if (reconos_devcfg_close(fd) < 0) {
+		res = -1;
+	}
+
+	if (res < 0) {
+		whine("[reconos-core] WARNING: corrupted or failed bitstream %s\n", bs->path);
+	}
+
+	return res;
+}
+
+
+/* == ReconOS reconfiguration ========================================== */
+
+static struct reconos_reconfig *_reconfig_head, *_reconfig_tail;
+static pthread_mutex_t _reconfig_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t _reconfig_cond = PTHREAD_COND_INITIALIZER;
+static pthread_once_t _reconfig_once = PTHREAD_ONCE_INIT;
+static pthread_t _reconfig_manager;
+
+/*
+ * Starts the reconfiguration manager on the first submission.
+ */
+static void reconfig_start() {
+	if (pthread_create(&_reconfig_manager, NULL, reconfig_manager, NULL)) {
+		panic("[reconos-core] ERROR: unable to start reconfiguration manager\n");
+	}
+	pthread_detach(_reconfig_manager);
+}
+
+/*
+ * @see header
+ */
+struct reconos_reconfig *reconfig_submit(int slot, char *path,
+                                         const char *kernel,
+                                         reconos_reconfig_callback callback,
+                                         void *arg) {
+	struct reconos_reconfig *rr;
+
+	if (slot != RECONOS_RECONFIG_FULL && (slot < 0 || slot >= RECONOS_NUM_HWTS)) {
+		panic("[reconos-core] ERROR: slot id out of range\n");
+	}
+
+	rr = (struct reconos_reconfig *)malloc(sizeof(struct reconos_reconfig));
+	if (!rr) {
+		panic("[reconos-core] ERROR: failed to allocate memory for reconfiguration\n");
+	}
+
+	rr->slot = slot;
+	rr->path = strdup(path);
+	if (!rr->path) {
+		panic("[reconos-core] ERROR: failed to allocate memory for reconfiguration\n");
+	}
+	rr->kernel = kernel;
+	rr->result = 0;
+	rr->done = 0;
+	rr->callback = callback;
+	rr->arg = arg;
+	pthread_mutex_init(&rr->lock, NULL);
+	pthread_cond_init(&rr->cond, NULL);
+	rr->next = NULL;
+
+	pthread_once(&_reconfig_once, reconfig_start);
+
+	pthread_mutex_lock(&_reconfig_lock);
+	if (_reconfig_tail) {
+		_reconfig_tail->next = rr;
+	} else {
+		_reconfig_head = rr;
+	}
+	_reconfig_tail = rr;
+	pthread_cond_signal(&_reconfig_cond);
+	pthread_mutex_unlock(&_reconfig_lock);
+
+	return rr;
+}
+
+/*
+ * @see header
+ */
+struct reconos_reconfig *reconos_reconfig_submit(int slot, char *path,
+                                                 reconos_reconfig_callback callback,
+                                                 void *arg) {
+	return reconfig_submit(slot, path, NULL, callback, arg);
+}
+
+/*
+ * @see header
+ */
+int reconos_reconfig_done(struct reconos_reconfig *rr) {
+	int done;
+
+	pthread_mutex_lock(&rr->lock);
+	done = rr->done;
+	pthread_mutex_unlock(&rr->lock);
+
+	return done;
+}
+
+/*
+ * @see header
+ */
+int reconos_reconfig_wait(struct reconos_reconfig *rr) {
+	pthread_mutex_lock(&rr->lock);
+	while (!rr->done) {
+		pthread_cond_wait(&rr->cond, &rr->lock);
+	}
+	pthread_mutex_unlock(&rr->lock);
+
+	return rr->result;
+}
+
+/*
+ * @see header
+ */
+void reconos_reconfig_free(struct reconos_reconfig *rr) {
+	pthread_mutex_destroy(&rr->lock);
+	pthread_cond_destroy(&rr->cond);
+	free(rr->path);
+	free(rr);
+}
+
+/*
+ * @see header
+ */
+void reconos_reconfig_prefetch(char *path) {
+	if (!reconos_devcfg_firmware()) {
+		bitstream_get(path);
+	}
+}
+
+/*
+ * Records the kernel the reconfigured slots contain afterwards. Slots
+ * failed to reconfigure are marked invalid, so that they are only used
+ * again after reconfiguring them successfully.
+ *
+ *   rr - pointer to the finished request
+ */
+static void reconfig_update(struct reconos_reconfig *rr) {
+	struct hwslot *slot;
+	int i;
+
+	// full bitstreams may be loaded before initializing the slots
+	if (!_hwslots) {
+		return;
+	}
+
+	pthread_mutex_lock(&_hwslots_lock);
+	for (i = 0; i < RECONOS_NUM_HWTS; i++) {
+		if (rr->slot != RECONOS_RECONFIG_FULL && rr->slot != i) {
+			continue;
+		}
+
+		slot = &_hwslots[i];
+		if (rr->result < 0) {
+			slot->kernel = NULL;
+			slot->invalid = 1;
+			slot->used = 0;
+		} else {
+			slot->kernel = rr->slot == RECONOS_RECONFIG_FULL ? NULL : rr->kernel;
+			slot->invalid = 0;
+		}
+	}
+	pthread_mutex_unlock(&_hwslots_lock);
+}
+
+/*
+ * @see header
+ */
+void *reconfig_manager(void *arg) {
+	struct reconos_reconfig *rr;
+	struct bitstream *bs;
+	struct hwslot *slot;
+	int running, leased;
+
+	while (1) {
+		pthread_mutex_lock(&_reconfig_lock);
+		while (!_reconfig_head) {
+			pthread_cond_wait(&_reconfig_cond, &_reconfig_lock);
+		}
+		rr = _reconfig_head;
+		_reconfig_head = rr->next;
+		if (!_reconfig_head) {
+			_reconfig_tail = NULL;
+		}
+		pthread_mutex_unlock(&_reconfig_lock);
+
+		debug("[reconos-core] reconfiguring slot %d with %s\n", rr->slot, rr->path);
+
+		slot = rr->slot == RECONOS_RECONFIG_FULL ? NULL : &_hwslots[rr->slot];
+
+		running = 0;
+		if (slot) {
+			pthread_mutex_lock(&_hwslots_lock);
+			running = slot->rt != NULL;
+			pthread_mutex_unlock(&_hwslots_lock);
+		}
+
+		// slots not leased before are released again afterwards
+		leased = 1;
+		if (running) {
+			whine("[reconos-core] WARNING: cannot reconfigure slot %d with running thread\n", slot->id);
+			rr->result = -1;
+		} else if (slot && (leased = reconos_broker_acquire(slot->id)) < 0) {
+			whine("[reconos-core] WARNING: slot %d leased by another application\n", slot->id);
+			rr->result = -1;
+		} else if (reconos_broker_connected()) {
+			// the broker holds the slot in reset while reconfiguring
+			rr->result = reconos_broker_reconfig(slot ? slot->id : -1, rr->path);
+			if (rr->result < 0) {
+				whine("[reconos-core] WARNING: failed to reconfigure with %s\n", rr->path);
+			}
+			reconfig_update(rr);
+
+			if (slot && !leased) {
+				reconos_broker_release(slot->id);
+			}
+		} else {
+			if (slot) {
+				hwslot_setreset(slot, 1);
+			}
+
+			if (reconos_devcfg_firmware()) {
+				rr->result = reconos_devcfg_program(rr->path, NULL, 0, slot != NULL);
+			} else {
+				bs = bitstream_get(rr->path);
+				rr->result = bitstream_program(bs, slot != NULL);
+			}
+
+			if (rr->result < 0) {
+				whine("[reconos-core] WARNING: failed to reconfigure with %s\n", rr->path);
+			}
+			reconfig_update(rr);
+		}
+
+		if (rr->callback) {
+			rr->callback(rr, rr->arg);
+		}
+
+		// a waiter may free the request as soon as it is done
+		pthread_mutex_lock(&rr->lock);
+		rr->done = 1;
+		pthread_cond_broadcast(&rr->cond);
+		pthread_mutex_unlock(&rr->lock);
+	}
+
+	return NULL;
+}
+
+
 /* == ReconOS hwslot =================================================== */
 
 /*
@@ -471,6 +1200,11 @@ void hwslot_init(struct hwslot *slot, int id, int osif) {
 	slot->dt_state = DELEGATE_STATE_STOPPED;
 	slot->dt_flags = 0;
 	sem_init(&slot->dt_exit, 0, 0);
+
+	slot->kernel = NULL;
+	slot->used = 0;
+	slot->reserved = 0;
+	slot->invalid = 0;
 }
 
 /*
@@ -497,10 +1231,36 @@ void hwslot_setsignal(struct hwslot *slot, int sig) {
 	reconos_proc_control_hwt_signal(_proc_control, slot->id, sig);
 }
 
+/*
+ * @see header
+ */
+void hwslot_setsched(struct hwslot *slot) {
+	struct sched_param param;
+	int policy;
+
+	if (!slot->rt || !slot->dt) {
+		return;
+	}
+
+	if (slot->rt->priority != RECONOS_THREAD_PRIORITY_DEFAULT) {
+		policy = SCHED_FIFO;
+		param.sched_priority = slot->rt->priority;
+	} else {
+		policy = _options.dt_policy;
+		param.sched_priority = _options.dt_priority;
+	}
+
+	if (pthread_setschedparam(slot->dt, policy, &param)) {
+		whine("[reconos-core] WARNING: unable to set priority of delegate %d\n", slot->id);
+	}
+}
+
 /*
  * @see header
  */
 void hwslot_createdelegate(struct hwslot *slot) {
+	pthread_attr_t attr;
+
 	if (slot->dt) {
 		panic("[reconos-core] ERROR: delegate thread already running\n");
 	}
@@ -508,7 +1268,32 @@ void hwslot_createdelegate(struct hwslot *slot) {
 	slot->dt_state = DELEGATE_STATE_INIT;
 	slot->dt_flags = 0;
 
-	pthread_create(&slot->dt, NULL, dt_delegate, slot);
+	dt_attr_init(&attr);
+	pthread_create(&slot->dt, &attr, dt_delegate, slot);
+	pthread_attr_destroy(&attr);
+	hwslot_setsched(slot);
+}
+
+/*
+ * Binds the kernel mboxes of the thread to the osif of the slot, such
+ * that the driver completes the mbox commands on them.
+ *
+ *   slot - pointer to the ReconOS slot
+ */
+static void hwslot_bindkmboxes(struct hwslot *slot) {
+	struct kmbox *mb;
+	int i;
+
+	for (i = 0; i < slot->rt->resource_count; i++) {
+		if (slot->rt->resources[i].type != RECONOS_RESOURCE_TYPE_KMBOX) {
+			continue;
+		}
+
+		mb = (struct kmbox *)slot->rt->resources[i].ptr;
+		if (reconos_osif_kbind(slot->osif, i, mb->fd) < 0) {
+			panic("[reconos-core] ERROR: unable to bind kernel mbox %d to slot %d\n", i, slot->id);
+		}
+	}
 }
 
 /*
@@ -521,11 +1306,15 @@ void hwslot_createthread(struct hwslot *slot,
 	}
 
 	slot->rt = rt;
+	slot->kernel = rt->name;
+	slot->used = ++_hwslots_clock;
 
 	reconos_proc_control_hwt_reset(_proc_control, slot->id, 1);
 	reconos_proc_control_hwt_signal(_proc_control, slot->id, 0);
 	reconos_proc_control_hwt_reset(_proc_control, slot->id, 0);
 
+	hwslot_bindkmboxes(slot);
+
 	reconos_osif_write(slot->osif, (uint32_t)OSIF_SIGNAL_THREAD_START);
 
 	hwslot_createdelegate(slot);
@@ -571,7 +1360,12 @@ void hwslot_resumethread(struct hwslot *slot,
 	reconos_proc_control_hwt_reset(_proc_control, slot->id, 0);
 	
 	slot->rt = rt;
-	
+	slot->kernel = rt->name;
+	slot->used = ++_hwslots_clock;
+	hwslot_setsched(slot);
+
+	hwslot_bindkmboxes(slot);
+
 	reconos_osif_write(slot->osif, (uint32_t)OSIF_SIGNAL_THREAD_RESUME);
 
 }
@@ -588,7 +1382,10 @@ void hwslot_jointhread(struct hwslot *slot) {
 
 	reconos_proc_control_hwt_reset(_proc_control, slot->id, 1);
 	reconos_proc_control_hwt_signal(_proc_control, slot->id, 0);
+	reconos_osif_kunbind(slot->osif);
 	slot->rt = NULL;
+
+	reconos_broker_release(slot->id);
 }
 
 
@@ -988,7 +1785,7 @@ void *dt_delegate(void *arg) {
 
 		debug("[reconos-dt-%d] waiting for command ...\n", slot->id);
 		slot->dt_state = DELEGATE_STATE_BLOCKED_OSIF;
-		cmd = reconos_osif_read(slot->osif);
+		cmd = reconos_osif_read_cmd(slot->osif);
 		slot->dt_state = DELEGATE_STATE_PROCESSING;
 		debug("[reconos-dt-%d] received command 0x%x\n", slot->id, cmd);
 
@@ -23,6 +23,8 @@
 #define RECONOS_H
 
 #include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #define RECONOS_VERSION_STRING "v3.1"
 
@@ -37,11 +39,15 @@ extern int RECONOS_NUM_HWTS;
  *   sem   - semaphore (sem_t)
  *   mutex - mutex (pthread_mutex)
  *   cond  - condition variable (pthread_cond)
+ *   kmbox - mailbox residing in the kernel (struct kmbox, Linux only),
+ *           its mbox commands are completed by the driver without
+ *           waking the delegate thread
  */
 #define RECONOS_RESOURCE_TYPE_MBOX     0x00000001
 #define RECONOS_RESOURCE_TYPE_SEM      0x00000002
 #define RECONOS_RESOURCE_TYPE_MUTEX    0x00000004
 #define RECONOS_RESOURCE_TYPE_COND     0x00000008
+#define RECONOS_RESOURCE_TYPE_KMBOX    0x00000010
 
 /*
  * Object representing a single resource.
@@ -105,6 +111,15 @@ int reconos_clock_set(int clk, int m, int f);
 #define RECONOS_THREAD_STATE_SUSPENDED    0x10
 #define RECONOS_THREAD_STATE_SUSPENDING   0x20
 
+/*
+ * Definition of the default scheduling attributes
+ *
+ *   priority_default - delegate keeps the priority it was created with
+ *   deadline_none    - no deadline is assigned to system calls
+ */
+#define RECONOS_THREAD_PRIORITY_DEFAULT   0x7FFFFFFF
+#define RECONOS_THREAD_DEADLINE_NONE      0
+
 
 /*
  * Object representing a hardware thread
@@ -121,6 +136,11 @@ int reconos_clock_set(int clk, int m, int f);
  *
  *   bitstreams        - array of bitstreams for the different slots
  *   bitstream_lengths - length of the bitstreams
+ *   bitstream_path    - path of the bitstreams if loaded from the
+ *                       filesystem, used to reconfigure slots on demand
+ *
+ *   priority          - scheduling priority of the delegate thread
+ *   deadline          - relative deadline of system calls in us
  */
 struct reconos_thread {
 	char *name;
@@ -140,7 +160,11 @@ struct reconos_thread {
 
 	char **bitstreams;
 	int *bitstream_lengths;
+	char *bitstream_path;
 	void *(*swentry)(void *data);
+
+	int priority;
+	int deadline;
 };
 
 /*
@@ -203,7 +227,8 @@ void reconos_thread_setresourcepointers(struct reconos_thread *rt,
 
 /*
  * Assigns the bitstream array to the hardware thread. The bitstream
- * array must contain a bitstream for each hardware slot.
+ * array must contain a bitstream for each hardware slot. Replaces the
+ * bitstreams loaded from the filesystem, if any.
  *
  *   rt  - pointer to the ReconOS thread
  *   bitstreams - array of bitstreams (array of chars)
@@ -215,7 +240,10 @@ void reconos_thread_setbitstream(struct reconos_thread *rt,
 
 /*
  * Loads bitstreams from the filesystem and assigns them to the
- * thread. A bitstream for each slot must be provided.
+ * thread. A bitstream for each slot the thread is allowed to run in
+ * must be provided. Bitstreams are cached by their path, so that each
+ * file is only loaded once and shared between all threads. Changing
+ * the allowed slots afterwards loads the bitstreams for the new slots.
  *
  *   rt   - pointer to the ReconOS thread
  *   path - path of the bitstreams, %d replaced by slot number
@@ -233,6 +261,27 @@ void reconos_thread_loadbitstream(struct reconos_thread *rt,
 void reconos_thread_setswentry(struct reconos_thread *rt,
                                void *(*swentry)(void *data));
 
+/*
+ * Sets the scheduling priority of the thread. The priority is applied
+ * to the delegate thread serving the system calls of the hardware
+ * thread, which is then scheduled with SCHED_FIFO. This also orders
+ * the wake-up of delegates blocked on the same resource (e.g. a mbox).
+ * May be called while the thread is running.
+ *
+ *   rt       - pointer to the ReconOS thread
+ *   priority - SCHED_FIFO priority of the delegate thread (1-99)
+ */
+void reconos_thread_setpriority(struct reconos_thread *rt, int priority);
+
+/*
+ * Sets a relative deadline for the system calls of the thread. Deadlines
+ * are only supported by the Zephyr runtime and ignored on Linux.
+ *
+ *   rt       - pointer to the ReconOS thread
+ *   deadline - deadline in microseconds or RECONOS_THREAD_DEADLINE_NONE
+ */
+void reconos_thread_setdeadline(struct reconos_thread *rt, int deadline);
+
 /*
  * Creates the ReconOS thread and executes it in the given slot number.
  *
@@ -243,7 +292,10 @@ void reconos_thread_setswentry(struct reconos_thread *rt,
 void reconos_thread_create(struct reconos_thread *rt, int slot);
 
 /*
- * Creates the ReconOS thread and executes it in a free slot.
+ * Creates the ReconOS thread and executes it in a free slot. Slots
+ * already configured for threads of the same name are preferred. If
+ * none is free and the thread has bitstreams loaded from the filesystem,
+ * the least recently used free slot is reconfigured.
  *
  *   rt - pointer to the ReconOS thread
  *   tt - software or hardware thread
@@ -290,14 +342,162 @@ void reconos_thread_join(struct reconos_thread *rt);
  */
 void reconos_thread_signal(struct reconos_thread *rt);
 
+/* == ReconOS reconfiguration ========================================== */
+
+/*
+ * Definition of the slot id to load a full bitstream
+ */
+#define RECONOS_RECONFIG_FULL -1
+
+struct reconos_reconfig;
+
+/*
+ * Callback executed by the reconfiguration manager when a request
+ * finished. The callback runs in the context of the manager before
+ * the request is marked as done, so it must not free the request.
+ *
+ *   rr  - pointer to the finished request
+ *   arg - argument passed on submission
+ */
+typedef void (*reconos_reconfig_callback)(struct reconos_reconfig *rr,
+                                          void *arg);
+
+/*
+ * Object representing a reconfiguration request
+ *
+ *   slot     - slot to reconfigure (or RECONOS_RECONFIG_FULL)
+ *   path     - path of the bitstream
+ *   kernel   - name of the thread the bitstream contains (null if
+ *              unknown)
+ *   result   - 0 on success, negative on failure
+ *   done     - indicates if the request finished
+ *
+ *   callback - callback executed on completion (can be null)
+ *   arg      - argument passed to the callback
+ */
+struct reconos_reconfig {
+	int slot;
+	char *path;
+	const char *kernel;
+	int result;
+	int done;
+
+	reconos_reconfig_callback callback;
+	void *arg;
+
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+
+	struct reconos_reconfig *next;
+};
+
+/*
+ * Submits a bitstream to the reconfiguration manager and returns
+ * immediately. Requests are processed one after another by a background
+ * thread owning the configuration port, while the hardware threads in
+ * the other slots keep running. The slot is held in reset during its
+ * reconfiguration, so the thread running in it must be suspended before.
+ *
+ *   slot     - slot to reconfigure or RECONOS_RECONFIG_FULL to load a
+ *              full bitstream (may be used before reconos_init())
+ *   path     - path of the bitstream (with the FPGA manager it must
+ *              be located in /lib/firmware), bitstreams compressed
+ *              by rdk are decompressed on the fly (not with the FPGA
+ *              manager)
+ *   callback - callback executed on completion (can be null)
+ *   arg      - argument passed to the callback
+ *
+ *   @returns pointer to the request
+ */
+struct reconos_reconfig *reconos_reconfig_submit(int slot, char *path,
+                                                 reconos_reconfig_callback callback,
+                                                 void *arg);
+
+/*
+ * Checks if the reconfiguration request finished.
+ *
+ *   rr - pointer to the request
+ *
+ *   @returns 1 if finished, 0 otherwise
+ */
+int reconos_reconfig_done(struct reconos_reconfig *rr);
+
+/*
+ * Waits until the reconfiguration request finished and its callback
+ * returned.
+ *
+ *   rr - pointer to the request
+ *
+ *   @returns 0 on success, negative on failure
+ */
+int reconos_reconfig_wait(struct reconos_reconfig *rr);
+
+/*
+ * Frees a finished reconfiguration request.
+ *
+ *   rr - pointer to the request
+ */
+void reconos_reconfig_free(struct reconos_reconfig *rr);
+
+/*
+ * Loads a bitstream into the bitstream cache in advance, such that a
+ * later reconfiguration does not have to wait for the filesystem.
+ *
+ *   path - path of the bitstream
+ */
+void reconos_reconfig_prefetch(char *path);
+
 /* == General functions ================================================ */
 
+/*
+ * Options for the initialization of the ReconOS environment.
+ *
+ *   dt_cpus     - bitmask of the cpus the delegate threads are pinned to
+ *                 (0 to not restrict the affinity)
+ *   dt_policy   - scheduling policy of the delegate threads
+ *                 (SCHED_OTHER, SCHED_FIFO or SCHED_RR)
+ *   dt_priority - priority of the delegate threads if not set per
+ *                 thread using reconos_thread_setpriority(...)
+ *   mlock       - locks all current and future memory of the process
+ *
+ *   bitstream_mmap - maps bitstreams from the filesystem instead of
+ *                    reading them into allocated memory
+ */
+struct reconos_options {
+	unsigned long dt_cpus;
+	int dt_policy;
+	int dt_priority;
+	int mlock;
+
+	int bitstream_mmap;
+};
+
+/*
+ * Initializes the options with the default values, i.e. no affinity,
+ * SCHED_OTHER, no memory locking and bitstreams read into memory.
+ *
+ *   opts - pointer to the options
+ */
+void reconos_options_init(struct reconos_options *opts);
+
 /*
  * Initializes the ReconOS environment and resets the hardware. You must
  * call this method before you can use any of the other functions.
+ * On Linux, setting the environment variable RECONOS_BROKER connects to
+ * the slot broker instead, which shares the hardware between several
+ * applications. Slots are then leased while threads run in them and
+ * hardware threads may only access memory of reconos_alloc_shared().
  */
 void reconos_init();
 
+/*
+ * Initializes the ReconOS environment like reconos_init(), but applies
+ * the given options to the delegate threads and the process.
+ *
+ *   opts - pointer to the options
+ */
+void reconos_init_opts(struct reconos_options *opts);
+
 /*
  * Cleans up the ReconOS environment and resets the hardware. You should
  * call this method before termination to prevent the hardware threads from
@@ -312,4 +512,110 @@ void reconos_cleanup();
  */
 void reconos_cache_flush();
 
+/*
+ * Writes back the cache lines of a buffer to memory, e.g. before a
+ * hardware thread reads it via a non-coherent port.
+ *
+ *   ptr - pointer to the buffer
+ *   len - length of the buffer in bytes
+ */
+void reconos_cache_clean(void *ptr, size_t len);
+
+/*
+ * Invalidates the cache lines of a buffer, e.g. after a hardware thread
+ * wrote it via a non-coherent port. Data written by the processor and
+ * not cleaned before may be lost.
+ *
+ *   ptr - pointer to the buffer
+ *   len - length of the buffer in bytes
+ */
+void reconos_cache_invalidate(void *ptr, size_t len);
+
+/*
+ * Definition of the flags for allocating shared memory
+ *
+ *   pin - additionally pins the pages in the kernel, so that they
+ *         are never swapped or moved while hardware threads use them
+ */
+#define RECONOS_ALLOC_PIN 0x01
+
+/*
+ * Allocates page aligned memory to be shared with hardware threads.
+ * All pages are faulted in before returning, so that the first access
+ * of a hardware thread does not cause a page fault. With the slot
+ * broker the memory is allocated from the arena shared with it.
+ *
+ *   size  - size of the memory in bytes
+ *   flags - allocation flags (refers to RECONOS_ALLOC_...)
+ *
+ *   @returns pointer to the zero initialized memory
+ */
+void *reconos_alloc_shared(size_t size, int flags);
+
+/*
+ * Frees memory allocated by reconos_alloc_shared(...).
+ *
+ *   ptr - pointer to the memory
+ */
+void reconos_free_shared(void *ptr);
+
+/*
+ * Descriptor of a scatter-gather memory transfer of a hardware thread,
+ * describing count rows of len bytes starting stride bytes apart. The
+ * descriptors are read by the memif and must be placed in memory
+ * accessible by the hardware, aligned to 16 bytes. The address and
+ * length must be multiples of the memif width.
+ *
+ *   addr   - address of the first row
+ *   len    - number of bytes per row
+ *   stride - distance between the start of two rows in bytes
+ *   count  - number of rows
+ */
+struct reconos_sg_desc {
+	uint32_t addr;
+	uint32_t len;
+	uint32_t stride;
+	uint32_t count;
+} __attribute__((aligned(16)));
+
+/*
+ * Memory statistics of a hardware thread counted by the proc control
+ *
+ *   bytes_read    - bytes read from main memory
+ *   bytes_written - bytes written to main memory
+ *   stall_cycles  - cycles with a pending memory request but no data
+ *                   transfer (waiting for arbitration, translation or
+ *                   the memory)
+ *   tlb_hits      - address translations served by the tlb
+ *   tlb_misses    - address translations requiring a page table walk
+ *   page_faults   - page faults raised by requests of the thread
+ */
+struct reconos_stats {
+	uint64_t bytes_read;
+	uint64_t bytes_written;
+	uint64_t stall_cycles;
+	uint64_t tlb_hits;
+	uint64_t tlb_misses;
+	uint64_t page_faults;
+};
+
+/*
+ * Reads the memory statistics of the hardware thread in the given slot
+ * since the last reset. Many stall cycles compared to the transferred
+ * bytes indicate a memory bound thread.
+ *
+ *   slot  - number of the slot
+ *   stats - pointer to the statistics to fill
+ *
+ *   @returns 0 on success or -1 on error
+ */
+int reconos_stats_get(int slot, struct reconos_stats *stats);
+
+/*
+ * Clears the memory statistics of the hardware thread in the given slot.
+ *
+ *   slot - number of the slot
+ */
+void reconos_stats_reset(int slot);
+
 #endif /* RECONOS_H */
\ No newline at end of file
@@ -48,10 +48,12 @@
  *     // thread code here
  *   }
  }
+ *
+ * The memif streams carry memif words as defined by the calls library.
  */
 #define THREAD_ENTRY() void rt_imp(hls::stream<uint32_t> osif_sw2hw,\
                                    hls::stream<uint32_t> osif_hw2sw,\
-                                   hls::stream<uint32_t> memif_hwt2mem,\
-                                   hls::stream<uint32_t> memif_mem2hwt)
+                                   hls::stream<memif_word_t> memif_hwt2mem,\
+                                   hls::stream<memif_word_t> memif_mem2hwt)
 
 #endif /* RECONOS_THREAD_H */
\ No newline at end of file
@@ -19,16 +19,87 @@
  */
 
 #include <linux/ioctl.h>
+#include <linux/types.h>
 
 #define RECONOS_IOC_MAGIC       'k'
 
+/*
+ * Maximum number of hardware threads supported by the driver, which
+ * determines the size of the osif masks passed to the ioctls.
+ */
+#define RECONOS_MAX_HWTS        256
+
 /*
  * IOCTL definitions for interrupt controller
  *
- *   intc_wait - wait for interrupt on specific osif
+ *   intc_wait     - wait for interrupt on specific osif
+ *   intc_break    - breaks a wait on specific osif
+ *   intc_enable   - enables the interrupt of a specific osif to be
+ *                   reported by poll or intc_wait_any
+ *   intc_wait_any - enables the interrupts of the given bitmask of osifs
+ *                   (struct reconos_osif_mask, one bit per osif)
+ *                   and waits until one of the enabled osifs is ready,
+ *                   returns the bitmask of ready osifs (does not block
+ *                   if the device was opened with O_NONBLOCK)
  */
 #define RECONOS_OSIF_INTC_WAIT       _IOW(RECONOS_IOC_MAGIC, 20, unsigned int)
 #define RECONOS_OSIF_INTC_BREAK      _IO(RECONOS_IOC_MAGIC, 21)
+#define RECONOS_OSIF_INTC_ENABLE     _IOW(RECONOS_IOC_MAGIC, 22, unsigned int)
+#define RECONOS_OSIF_INTC_WAIT_ANY   _IOWR(RECONOS_IOC_MAGIC, 23, struct reconos_osif_mask)
+
+/*
+ * Argument of the interrupt controller wait any ioctl
+ *
+ *   mask - bitmask of osifs, osif i in bit i % 32 of word i / 32
+ */
+struct reconos_osif_mask {
+	__u32 mask[(RECONOS_MAX_HWTS + 31) / 32];
+};
+
+/*
+ * IOCTL definitions for kernel mboxes and the kernel osif
+ *
+ *   mbox_init      - initializes the mbox of the file with the given
+ *                    size in words, afterwards words are put by write
+ *                    and got by read (blocking unless O_NONBLOCK)
+ *   mbox_tryget    - gets a word if available (-EAGAIN otherwise)
+ *   mbox_tryput    - puts a word if space is left (-EAGAIN otherwise)
+ *   osif_claim     - claims the osif of a specific hardware thread for
+ *                    the file, its registers can then be mapped (one
+ *                    page, if the osifs are placed on separate pages)
+ *   osif_bind_mbox - binds a resource handle of the hardware thread to
+ *                    a kernel mbox (struct reconos_osif_mbox) and
+ *                    enables the kernel path, mbox commands on bound
+ *                    handles are then completed in the kernel
+ *   osif_next_cmd  - processes the commands in the kernel until one
+ *                    must be handled by the caller and returns it, its
+ *                    arguments are read from the file afterwards
+ *   osif_break     - breaks a wait in osif_next_cmd or read
+ *   osif_unbind    - disables the kernel path and unbinds all mboxes
+ *   osif_revoke    - unbinds the osif and revokes the claim of the file
+ *                    including all copies passed to other processes,
+ *                    which fail afterwards and lose their mappings
+ */
+#define RECONOS_MBOX_INIT            _IOW(RECONOS_IOC_MAGIC, 30, unsigned int)
+#define RECONOS_MBOX_TRYGET          _IOR(RECONOS_IOC_MAGIC, 31, unsigned int)
+#define RECONOS_MBOX_TRYPUT          _IOW(RECONOS_IOC_MAGIC, 32, unsigned int)
+#define RECONOS_OSIF_CLAIM           _IOW(RECONOS_IOC_MAGIC, 33, int)
+#define RECONOS_OSIF_BIND_MBOX       _IOW(RECONOS_IOC_MAGIC, 34, struct reconos_osif_mbox)
+#define RECONOS_OSIF_NEXT_CMD        _IOR(RECONOS_IOC_MAGIC, 35, unsigned int)
+#define RECONOS_OSIF_BREAK           _IO(RECONOS_IOC_MAGIC, 36)
+#define RECONOS_OSIF_UNBIND          _IO(RECONOS_IOC_MAGIC, 37)
+#define RECONOS_OSIF_REVOKE          _IO(RECONOS_IOC_MAGIC, 38)
+
+/*
+ * Argument of the osif bind mbox ioctl
+ *
+ *   handle - resource handle used by the hardware thread
+ *   fd     - file descriptor of the kernel mbox (negative to unbind)
+ */
+struct reconos_osif_mbox {
+	int handle;
+	int fd;
+};
 
 /*
  * IOCTL definitions for proc control
@@ -44,6 +115,15 @@
  *   set_hwt_suspres   - set the suspres of a specific hardware thread
  *   clear_hwt_suspres - clears the reset
  *   cache_flush       - flushes the system's cache
+ *   cache_range       - cleans and/or invalidates the cache for a user
+ *                       address range (struct reconos_cache_range)
+ *   pin_range         - faults in and pins a user address range until
+ *                       unpinned or the device is closed
+ *                       (struct reconos_mem_range)
+ *   unpin_range       - unpins a range pinned before by its address
+ *   get_stats         - returns the memory statistics of a hardware
+ *                       thread (struct reconos_hwt_stats)
+ *   reset_stats       - clears the memory statistics of a hardware thread
  */
 #define RECONOS_PROC_CONTROL_GET_NUM_HWTS      _IOR(RECONOS_IOC_MAGIC, 1, int)
 #define RECONOS_PROC_CONTROL_GET_TLB_HITS      _IOR(RECONOS_IOC_MAGIC, 2, int)
@@ -57,3 +137,70 @@
 #define RECONOS_PROC_CONTROL_SET_HWT_SIGNAL    _IOW(RECONOS_IOC_MAGIC, 10, int)
 #define RECONOS_PROC_CONTROL_CLEAR_HWT_SIGNAL  _IOW(RECONOS_IOC_MAGIC, 11, int)
 #define RECONOS_PROC_CONTROL_CACHE_FLUSH       _IO(RECONOS_IOC_MAGIC, 12)
+#define RECONOS_PROC_CONTROL_CACHE_RANGE       _IOW(RECONOS_IOC_MAGIC, 13, struct reconos_cache_range)
+#define RECONOS_PROC_CONTROL_PIN_RANGE         _IOW(RECONOS_IOC_MAGIC, 14, struct reconos_mem_range)
+#define RECONOS_PROC_CONTROL_UNPIN_RANGE       _IOW(RECONOS_IOC_MAGIC, 15, struct reconos_mem_range)
+#define RECONOS_PROC_CONTROL_GET_STATS         _IOWR(RECONOS_IOC_MAGIC, 16, struct reconos_hwt_stats)
+#define RECONOS_PROC_CONTROL_RESET_STATS       _IOW(RECONOS_IOC_MAGIC, 17, int)
+
+/*
+ * Definition of the cache operations
+ *
+ *   clean      - writes back dirty cache lines to memory
+ *   invalidate - discards cache lines to reread them from memory
+ */
+#define RECONOS_CACHE_CLEAN      0x1
+#define RECONOS_CACHE_INVALIDATE 0x2
+
+/*
+ * Argument of the cache range ioctl
+ *
+ *   addr - user virtual start address
+ *   len  - length of the range in bytes
+ *   op   - bitmask of the cache operations (refers to RECONOS_CACHE_...)
+ */
+struct reconos_cache_range {
+	unsigned long addr;
+	unsigned long len;
+	int op;
+};
+
+/*
+ * Argument of the pin ioctls
+ *
+ *   addr - user virtual start address
+ *   len  - length of the range in bytes
+ */
+struct reconos_mem_range {
+	unsigned long addr;
+	unsigned long len;
+};
+
+/*
+ * Definition of the memory statistics counted per hardware thread
+ *
+ *   bytes_read    - bytes read from main memory
+ *   bytes_written - bytes written to main memory
+ *   stall_cycles  - cycles with a pending request but no data transfer
+ *   tlb_hits      - address translations served by the tlb
+ *   tlb_misses    - address translations requiring a page table walk
+ *   page_faults   - page faults raised by requests of the thread
+ */
+#define RECONOS_STATS_BYTES_READ    0
+#define RECONOS_STATS_BYTES_WRITTEN 1
+#define RECONOS_STATS_STALL_CYCLES  2
+#define RECONOS_STATS_TLB_HITS      3
+#define RECONOS_STATS_TLB_MISSES    4
+#define RECONOS_STATS_PAGE_FAULTS   5
+#define RECONOS_STATS_COUNT         6
+
+/*
+ * Argument of the statistics ioctl
+ *
+ *   hwt   - number of the hardware thread (set by the caller)
+ *   count - counters indexed by RECONOS_STATS_...
+ */
+struct reconos_hwt_stats {
+	int hwt;
+	unsigned long long count[RECONOS_STATS_COUNT];
+};
@@ -0,0 +1,473 @@
+/*
+ *                                                        ____  _____
+ *                            ________  _________  ____  / __ \/ ___/
+ *                           / ___/ _ \/ ___/ __ \/ __ \/ / / /\__ \
+ *                          / /  /  __/ /__/ /_/ / / / / /_/ /___/ /
+ *                         /_/   \___/\___/\____/_/ /_/\____//____/
+ *
+ * ======================================================================
+ *
+ *   title:        Linux Driver - Kernel mbox
+ *
+ *   project:      ReconOS
+ *   author:       Christoph Rüthing, University of Paderborn
+ *   description:  Mailboxes residing in the kernel. Every opened file of
+ *                 the mbox device represents one mbox, which is
+ *                 initialized by an ioctl and accessed by reading and
+ *                 writing 32 bit words.
+ *
+ * ======================================================================
+ */
+
+#include "mbox.h"
+
+#include <linux/spinlock.h>
+#include <linux/wait.h>
+#include <linux/poll.h>
+#include <linux/sched.h>
+#include <linux/slab.h>
+#include <linux/miscdevice.h>
+#include <linux/uaccess.h>
+#include <asm/uaccess.h>
+
+/*
+ * Maximum size of a mbox in words
+ */
+#define KMBOX_MAX_SIZE 65536
+
+/*
+ * Struct representing a kernel mbox
+ *
+ *   buf     - ring buffer holding the messages
+ *   size    - size of the ring buffer in words
+ *   fill    - number of messages in the ring buffer
+ *   first   - index of the first message
+ *
+ *   wait    - wait queue for user space readers and writers
+ *   waiters - list of kernel waiters (struct kmbox_waiter)
+ *
+ *   lock    - spinlock for synchronization
+ */
+struct kmbox {
+	uint32_t *buf;
+	size_t size;
+	size_t fill;
+	size_t first;
+
+	wait_queue_head_t wait;
+	struct list_head waiters;
+
+	spinlock_t lock;
+};
+
+/*
+ * Struct representing the mbox device
+ *
+ *   name - name to identify the device driver
+ *   mdev - misc device data structure
+ */
+struct kmbox_dev {
+	char name[25];
+
+	struct miscdevice mdev;
+};
+
+static struct kmbox_dev kmbox_dev;
+
+static struct file_operations kmbox_fops;
+
+
+/* == Mbox functions =================================================== */
+
+/*
+ * Wakes up all user space and kernel waiters after the mbox changed.
+ * Must be called while holding the lock of the mbox.
+ *
+ *   mb - pointer to the mbox
+ */
+static void kmbox_notify(struct kmbox *mb) {
+	struct kmbox_waiter *waiter, *tmp;
+
+	wake_up_interruptible(&mb->wait);
+
+	list_for_each_entry_safe(waiter, tmp, &mb->waiters, list) {
+		list_del_init(&waiter->list);
+		waiter->complete(waiter);
+	}
+}
+
+/*
+ * @see header
+ */
+struct kmbox *kmbox_from_file(struct file *file) {
+	struct kmbox *mb;
+
+	if (file->f_op != &kmbox_fops) {
+		return NULL;
+	}
+
+	mb = (struct kmbox *)file->private_data;
+	if (!mb->buf) {
+		return NULL;
+	}
+
+	return mb;
+}
+
+/*
+ * @see header
+ */
+int kmbox_tryget(struct kmbox *mb, uint32_t *msg,
+                 struct kmbox_waiter *waiter) {
+	unsigned long flags;
+
+	spin_lock_irqsave(&mb->lock, flags);
+	if (mb->fill == 0) {
+		if (waiter && list_empty(&waiter->list)) {
+			list_add_tail(&waiter->list, &mb->waiters);
+		}
+		spin_unlock_irqrestore(&mb->lock, flags);
+		return 0;
+	}
+
+	*msg = mb->buf[mb->first];
+	mb->first = (mb->first + 1) % mb->size;
+	mb->fill--;
+
+	if (waiter) {
+		list_del_init(&waiter->list);
+	}
+	kmbox_notify(mb);
+	spin_unlock_irqrestore(&mb->lock, flags);
+
+	return 1;
+}
+
+/*
+ * @see header
+ */
+int kmbox_tryput(struct kmbox *mb, uint32_t msg,
+                 struct kmbox_waiter *waiter) {
+	unsigned long flags;
+
+	spin_lock_irqsave(&mb->lock, flags);
+	if (mb->fill == mb->size) {
+		if (waiter && list_empty(&waiter->list)) {
+			list_add_tail(&waiter->list, &mb->waiters);
+		}
+		spin_unlock_irqrestore(&mb->lock, flags);
+		return 0;
+	}
+
+	mb->buf[(mb->first + mb->fill) % mb->size] = msg;
+	mb->fill++;
+
+	if (waiter) {
+		list_del_init(&waiter->list);
+	}
+	kmbox_notify(mb);
+	spin_unlock_irqrestore(&mb->lock, flags);
+
+	return 1;
+}
+
+/*
+ * @see header
+ */
+void kmbox_cancel(struct kmbox *mb, struct kmbox_waiter *waiter) {
+	unsigned long flags;
+
+	spin_lock_irqsave(&mb->lock, flags);
+	list_del_init(&waiter->list);
+	spin_unlock_irqrestore(&mb->lock, flags);
+}
+
+/*
+ * Returns the number of messages in the mbox
+ *
+ *   mb - pointer to the mbox
+ */
+static inline size_t kmbox_fill(struct kmbox *mb) {
+	return READ_ONCE(mb->fill);
+}
+
+
+/* == File operations ================================================== */
+
+/*
+ * Function called when opening the device
+ *
+ *    @see kernel documentation
+ */
+static int kmbox_open(struct inode *inode, struct file *filp) {
+	struct kmbox *mb;
+
+	mb = kzalloc(sizeof(struct kmbox), GFP_KERNEL);
+	if (!mb) {
+		return -ENOMEM;
+	}
+
+	spin_lock_init(&mb->lock);
+	init_waitqueue_head(&mb->wait);
+	INIT_LIST_HEAD(&mb->waiters);
+
+	filp->private_data = mb;
+
+	return 0;
+}
+
+/*
+ * Function called when closing the device
+ *
+ *    @see kernel documentation
+ */
+static int kmbox_release(struct inode *inode, struct file *filp) {
+	struct kmbox *mb;
+
+	mb = (struct kmbox *)filp->private_data;
+
+	kfree(mb->buf);
+	kfree(mb);
+
+	return 0;
+}
+
+/*
+ * Function called when reading from the device. Gets as many messages
+ * as available but at least one, blocking if the mbox is empty.
+ *
+ *    @see kernel documentation
+ */
+static ssize_t kmbox_read(struct file *filp, char __user *buf,
+                          size_t count, loff_t *pos) {
+	struct kmbox *mb;
+	uint32_t msg;
+	size_t done;
+
+	mb = (struct kmbox *)filp->private_data;
+
+	if (!mb->buf) {
+		return -EINVAL;
+	}
+
+	count &= ~0x3;
+	for (done = 0; done < count; done += 4) {
+		while (!kmbox_tryget(mb, &msg, NULL)) {
+			if (done > 0) {
+				return done;
+			}
+
+			if (filp->f_flags & O_NONBLOCK) {
+				return -EAGAIN;
+			}
+
+			if (wait_event_interruptible(mb->wait, kmbox_fill(mb) > 0) < 0) {
+				return -ERESTARTSYS;
+			}
+		}
+
+		// the message is lost if copying fails as for a pipe
+		if (put_user(msg, (uint32_t __user *)(buf + done))) {
+			return -EFAULT;
+		}
+	}
+
+	return done;
+}
+
+/*
+ * Function called when writing to the device. Puts all messages,
+ * blocking if the mbox is full.
+ *
+ *    @see kernel documentation
+ */
+static ssize_t kmbox_write(struct file *filp, const char __user *buf,
+                           size_t count, loff_t *pos) {
+	struct kmbox *mb;
+	uint32_t msg;
+	size_t done;
+
+	mb = (struct kmbox *)filp->private_data;
+
+	if (!mb->buf) {
+		return -EINVAL;
+	}
+
+	count &= ~0x3;
+	for (done = 0; done < count; done += 4) {
+		if (get_user(msg, (const uint32_t __user *)(buf + done))) {
+			return done > 0 ? done : -EFAULT;
+		}
+
+		while (!kmbox_tryput(mb, msg, NULL)) {
+			if (filp->f_flags & O_NONBLOCK) {
+				return done > 0 ? done : -EAGAIN;
+			}
+
+			if (wait_event_interruptible(mb->wait, kmbox_fill(mb) < mb->size) < 0) {
+				return done > 0 ? done : -ERESTARTSYS;
+			}
+		}
+	}
+
+	return done;
+}
+
+/*
+ * Function called when issuing an ioctl
+ *
+ * @see kernel documentation
+ */
+static long kmbox_ioctl(struct file *filp, unsigned int cmd,
+                        unsigned long arg) {
+	struct kmbox *mb;
+	unsigned int size;
+	uint32_t *buf, msg;
+	unsigned long flags;
+
+	mb = (struct kmbox *)filp->private_data;
+
+	if (cmd != RECONOS_MBOX_INIT && !mb->buf) {
+		return -EINVAL;
+	}
+
+	switch (cmd) {
+		case RECONOS_MBOX_INIT:
+			if (copy_from_user(&size, (unsigned int *)arg, sizeof(unsigned int))) {
+				return -EFAULT;
+			}
+
+			if (size == 0 || size > KMBOX_MAX_SIZE) {
+				return -EINVAL;
+			}
+
+			buf = kcalloc(size, sizeof(uint32_t), GFP_KERNEL);
+			if (!buf) {
+				return -ENOMEM;
+			}
+
+			spin_lock_irqsave(&mb->lock, flags);
+			if (mb->buf) {
+				spin_unlock_irqrestore(&mb->lock, flags);
+				kfree(buf);
+				return -EBUSY;
+			}
+			mb->buf = buf;
+			mb->size = size;
+			spin_unlock_irqrestore(&mb->lock, flags);
+
+			__printk(KERN_DEBUG "[reconos-mbox] "
+			                    "initialized mbox of size %u\n", size);
+			break;
+
+		case RECONOS_MBOX_TRYGET:
+			if (!kmbox_tryget(mb, &msg, NULL)) {
+				return -EAGAIN;
+			}
+
+			if (copy_to_user((uint32_t *)arg, &msg, sizeof(uint32_t))) {
+				return -EFAULT;
+			}
+			break;
+
+		case RECONOS_MBOX_TRYPUT:
+			if (copy_from_user(&msg, (uint32_t *)arg, sizeof(uint32_t))) {
+				return -EFAULT;
+			}
+
+			if (!kmbox_tryput(mb, msg, NULL)) {
+				return -EAGAIN;
+			}
+			break;
+
+		default:
+			return -EINVAL;
+	}
+
+	return 0;
+}
+
+/*
+ * Function called when polling the device. The device is readable if
+ * the mbox is not empty and writable if it is not full.
+ *
+ * @see kernel documentation
+ */
+static unsigned int kmbox_poll(struct file *filp, poll_table *wait) {
+	struct kmbox *mb;
+	unsigned int mask = 0;
+
+	mb = (struct kmbox *)filp->private_data;
+
+	if (!mb->buf) {
+		return POLLERR;
+	}
+
+	poll_wait(filp, &mb->wait, wait);
+
+	if (kmbox_fill(mb) > 0) {
+		mask |= POLLIN | POLLRDNORM;
+	}
+	if (kmbox_fill(mb) < mb->size) {
+		mask |= POLLOUT | POLLWRNORM;
+	}
+
+	return mask;
+}
+
+/*
+ * Struct for file operations to register driver
+ *
+ *    @see kernel documentation
+ */
+static struct file_operations kmbox_fops = {
+	.owner          = THIS_MODULE,
+	.open           = kmbox_open,
+	.release        = kmbox_release,
+	.read           = kmbox_read,
+	.write          = kmbox_write,
+	.unlocked_ioctl = kmbox_ioctl,
+	.poll           = kmbox_poll,
+};
+
+
+/* == Init and exit functions ========================================== */
+
+/*
+ * @see header
+ */
+int kmbox_init() {
+	struct kmbox_dev *dev = &kmbox_dev;
+
+	__printk(KERN_INFO "[reconos-mbox] "
+	                   "initializing driver ...\n");
+
+	strncpy(dev->name, "reconos-mbox", 25);
+
+	// registering misc device
+	dev->mdev.minor = MISC_DYNAMIC_MINOR;
+	dev->mdev.fops = &kmbox_fops;
+	dev->mdev.name = dev->name;
+
+	if (misc_register(&dev->mdev) < 0) {
+		__printk(KERN_WARNING "[reconos-mbox] "
+		                      "error while registering misc-device\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * @see header
+ */
+int kmbox_exit() {
+	struct kmbox_dev *dev = &kmbox_dev;
+
+	__printk(KERN_INFO "[reconos-mbox] "
+	                   "removing driver ...\n");
+
+	misc_deregister(&dev->mdev);
+
+	return 0;
+}
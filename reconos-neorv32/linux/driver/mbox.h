@@ -0,0 +1,106 @@
+/*
+ *                                                        ____  _____
+ *                            ________  _________  ____  / __ \/ ___/
+ *                           / ___/ _ \/ ___/ __ \/ __ \/ / / /\__ \
+ *                          / /  /  __/ /__/ /_/ / / / / /_/ /___/ /
+ *                         /_/   \___/\___/\____/_/ /_/\____//____/
+ *
+ * ======================================================================
+ *
+ *   title:        Linux Driver - Kernel mbox
+ *
+ *   project:      ReconOS
+ *   author:       Christoph Rüthing, University of Paderborn
+ *   description:  Mailboxes residing in the kernel. User space accesses
+ *                 them via read and write on the mbox device, while
+ *                 hardware threads bound to the kernel osif access them
+ *                 directly from the interrupt handler.
+ *
+ * ======================================================================
+ */
+
+#ifndef RECONOS_DRV_MBOX_H
+#define RECONOS_DRV_MBOX_H
+
+#include "reconos.h"
+
+#include <linux/list.h>
+#include <linux/fs.h>
+
+struct kmbox;
+
+/*
+ * Struct representing a kernel user waiting on a mbox
+ *
+ *   list     - list head to queue the waiter in the mbox
+ *   complete - function called when the mbox changed, afterwards
+ *              the waiter is no longer queued (called while holding
+ *              the lock of the mbox, so it must not access the mbox)
+ */
+struct kmbox_waiter {
+	struct list_head list;
+	void (*complete)(struct kmbox_waiter *waiter);
+};
+
+/*
+ * Returns the mbox of a file of the mbox device
+ *
+ *   file - pointer to the file
+ *
+ *   @returns the mbox or NULL if the file is no initialized mbox
+ */
+extern struct kmbox *kmbox_from_file(struct file *file);
+
+/*
+ * Tries to get a single word out of the mbox. If the mbox is empty
+ * the waiter is queued atomically to be completed on the next change.
+ *
+ *   mb     - pointer to the mbox
+ *   msg    - pointer to store the message in
+ *   waiter - waiter to queue or NULL
+ *
+ *   @returns 1 on success, otherwise 0
+ */
+extern int kmbox_tryget(struct kmbox *mb, uint32_t *msg,
+                        struct kmbox_waiter *waiter);
+
+/*
+ * Tries to put a single word into the mbox. If the mbox is full
+ * the waiter is queued atomically to be completed on the next change.
+ *
+ *   mb     - pointer to the mbox
+ *   msg    - message to put into the mbox
+ *   waiter - waiter to queue or NULL
+ *
+ *   @returns 1 on success, otherwise 0
+ */
+extern int kmbox_tryput(struct kmbox *mb, uint32_t msg,
+                        struct kmbox_waiter *waiter);
+
+/*
+ * Removes a waiter from the mbox if still queued
+ *
+ *   mb     - pointer to the mbox
+ *   waiter - waiter to remove
+ */
+extern void kmbox_cancel(struct kmbox *mb, struct kmbox_waiter *waiter);
+
+/*
+ * Initialization function called by module loading
+ *
+ *   no parameters
+ *
+ *   @returns -1 on failure, otherwise 0
+ */
+extern int kmbox_init(void);
+
+/*
+ * Exit function called by module unloading
+ *
+ *   no parameters
+ *
+ *   @returns always 0
+ */
+extern int kmbox_exit(void);
+
+#endif /* RECONOS_DRV_MBOX_H */
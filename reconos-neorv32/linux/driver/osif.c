@@ -0,0 +1,1112 @@
+/*
+ *                                                        ____  _____
+ *                            ________  _________  ____  / __ \/ ___/
+ *                           / ___/ _ \/ ___/ __ \/ __ \/ / / /\__ \
+ *                          / /  /  __/ /__/ /_/ / / / / /_/ /___/ /
+ *                         /_/   \___/\___/\____/_/ /_/\____//____/
+ *
+ * ======================================================================
+ *
+ *   title:        Linux Driver - Kernel OSIF
+ *
+ *   project:      ReconOS
+ *   author:       Christoph Rüthing, University of Paderborn
+ *   description:  Optional kernel path for the OSIF of a hardware thread.
+ *                 A delegate thread claims the OSIF of its hardware thread
+ *                 and some of its resource handles to kernel mboxes.
+ *                 Afterwards, the interrupt handler parses the commands
+ *                 of the hardware thread and completes mbox commands on
+ *                 bound handles without returning to user space. All
+ *                 other commands are forwarded to the delegate thread,
+ *                 which then accesses the FIFO by reading and writing
+ *                 the device until fetching the next command.
+ *                 Without the kernel path, the delegate maps the page of
+ *                 its claimed OSIF and accesses the FIFO directly.
+ *
+ * ======================================================================
+ */
+
+#include "osif.h"
+#include "osif_intc.h"
+#include "mbox.h"
+
+#include <linux/spinlock.h>
+#include <linux/wait.h>
+#include <linux/sched.h>
+#include <linux/interrupt.h>
+#include <linux/slab.h>
+#include <linux/fs.h>
+#include <linux/file.h>
+#include <linux/miscdevice.h>
+#include <linux/of_address.h>
+#include <linux/mm.h>
+#include <linux/uaccess.h>
+#include <linux/delay.h>
+#include <asm/io.h>
+#include <asm/uaccess.h>
+
+/*
+ * Register definitions as offset from the base address of an osif
+ *
+ *   recv_reg         - reads data from the hardware thread
+ *   send_reg         - writes data to the hardware thread
+ *   recv_status_reg  - status of the receiving fifo
+ *   send_status_reg  - status of the sending fifo
+ *   mem_size         - default distance of the registers of two osifs
+ *                      (overwritten by reconos,osif-stride)
+ */
+#define OSIF_FIFO_RECV_REG          0x00
+#define OSIF_FIFO_SEND_REG          0x04
+#define OSIF_FIFO_RECV_STATUS_REG   0x08
+#define OSIF_FIFO_SEND_STATUS_REG   0x0C
+#define OSIF_FIFO_MEM_SIZE          0x10
+
+#define OSIF_FIFO_RECV_STATUS_EMPTY_MASK 0x80000000
+#define OSIF_FIFO_SEND_STATUS_FULL_MASK  0x80000000
+
+/*
+ * Definition of the osif commands handled in the kernel
+ *
+ *   self-describing
+ */
+#define OSIF_CMD_MBOX_GET              0x000000F0
+#define OSIF_CMD_MBOX_PUT              0x000000F1
+#define OSIF_CMD_MBOX_TRYGET           0x000000F2
+#define OSIF_CMD_MBOX_TRYPUT           0x000000F3
+#define OSIF_CMD_MASK                  0x000000FF
+
+/*
+ * Maximum number of resource handles bound to kernel mboxes
+ */
+#define OSIF_MAX_HANDLES 64
+
+/*
+ * Definition of the states of an osif
+ *
+ *   user   - the delegate thread accesses the fifo
+ *   kernel - the kernel parses the commands of the hardware thread
+ *   get    - waiting for a message in a kernel mbox
+ *   put    - waiting for space in a kernel mbox
+ *   cmd    - a command was forwarded and waits to be fetched
+ *   reply  - the response of a command waits for space in the fifo
+ */
+#define OSIF_STATE_USER   0
+#define OSIF_STATE_KERNEL 1
+#define OSIF_STATE_GET    2
+#define OSIF_STATE_PUT    3
+#define OSIF_STATE_CMD    4
+#define OSIF_STATE_REPLY  5
+
+/*
+ * Struct representing the osif of a single hardware thread
+ *
+ *   index     - index of the hardware thread
+ *   mem       - pointer to the io memory of the fifo
+ *
+ *   file      - file the osif is claimed by (NULL if unclaimed)
+ *   kernel    - indicates whether the kernel path is enabled
+ *   state     - state of the osif (refers to OSIF_STATE_...)
+ *   words     - words of the current command read so far
+ *   count     - number of words in words
+ *   fwd       - index of the next forwarded word to read by user space
+ *   brk       - indicates whether a wait should be breaked
+ *   reply     - words of the response to the current command
+ *   nreply    - number of words in reply
+ *   sent      - number of words of reply written to the fifo
+ *
+ *   pending   - mbox of the pending get or put
+ *   waiter    - waiter to queue in the mbox of the pending operation
+ *   tasklet   - tasklet to continue a pending operation or response
+ *
+ *   mbox      - array of the kernel mboxes bound to resource handles
+ *   mbox_file - array of the files of the bound kernel mboxes
+ *
+ *   wait      - wait queue for the delegate thread
+ *   lock      - spinlock for synchronization
+ *
+ *   mapping   - address space of the claiming file to revoke its mappings
+ */
+struct osif_hwt {
+	int index;
+	void __iomem *mem;
+
+	struct file *file;
+	int kernel;
+	int state;
+	uint32_t words[3];
+	int count;
+	int fwd;
+	int brk;
+	uint32_t reply[2];
+	int nreply;
+	int sent;
+
+	struct kmbox *pending;
+	struct kmbox_waiter waiter;
+	struct tasklet_struct tasklet;
+
+	struct kmbox *mbox[OSIF_MAX_HANDLES];
+	struct file *mbox_file[OSIF_MAX_HANDLES];
+
+	wait_queue_head_t wait;
+	spinlock_t lock;
+
+	struct address_space mapping;
+};
+
+/*
+ * Struct representing the osif device
+ *
+ *   name      - name to identify the device driver
+ *   base_addr - base addr of the fifos
+ *   mem_size  - memory size of the fifos
+ *   stride    - distance of the registers of two osifs
+ *
+ *   mem       - pointer to the io memory
+ *   hwts      - array of the osifs, one per hardware thread
+ *
+ *   mdev      - misc device data structure
+ */
+struct osif_dev {
+	char name[25];
+	uint32_t base_addr;
+	int mem_size;
+	uint32_t stride;
+
+	void __iomem *mem;
+	struct osif_hwt *hwts;
+
+	struct miscdevice mdev;
+};
+
+static struct osif_dev osif;
+
+
+/* == Low level functions ============================================== */
+
+/*
+ * Returns whether the fifo from the hardware thread holds data
+ *
+ *   hwt - pointer to the osif
+ */
+static inline int osif_fifo_ready(struct osif_hwt *hwt) {
+	return !(ioread32(hwt->mem + OSIF_FIFO_RECV_STATUS_REG) & OSIF_FIFO_RECV_STATUS_EMPTY_MASK);
+}
+
+/*
+ * Reads a word from the fifo, which must hold data
+ *
+ *   hwt - pointer to the osif
+ */
+static inline uint32_t osif_fifo_read(struct osif_hwt *hwt) {
+	return ioread32(hwt->mem + OSIF_FIFO_RECV_REG);
+}
+
+/*
+ * Returns whether the fifo to the hardware thread has space. It stays
+ * full if the hardware thread is held in reset or does not read.
+ *
+ *   hwt - pointer to the osif
+ */
+static inline int osif_fifo_writable(struct osif_hwt *hwt) {
+	return !(ioread32(hwt->mem + OSIF_FIFO_SEND_STATUS_REG) & OSIF_FIFO_SEND_STATUS_FULL_MASK);
+}
+
+/*
+ * Writes a word to the fifo, which must have space
+ *
+ *   hwt  - pointer to the osif
+ *   data - word to write
+ */
+static inline void osif_fifo_write(struct osif_hwt *hwt, uint32_t data) {
+	iowrite32(data, hwt->mem + OSIF_FIFO_SEND_REG);
+}
+
+
+/* == Command handling ================================================= */
+
+/*
+ * Forwards the current command to the delegate thread
+ *
+ *   hwt - pointer to the osif
+ */
+static inline void osif_forward(struct osif_hwt *hwt) {
+	hwt->state = OSIF_STATE_CMD;
+	wake_up_interruptible(&hwt->wait);
+
+	__printk(KERN_DEBUG "[reconos-osif] "
+	                    "forwarding command 0x%x of %d\n",
+	                    hwt->words[0], hwt->index);
+}
+
+/*
+ * Appends a word to the response of the current command, which is
+ * written to the fifo when entering the reply state
+ *
+ *   hwt  - pointer to the osif
+ *   data - word to append
+ */
+static inline void osif_reply(struct osif_hwt *hwt, uint32_t data) {
+	hwt->reply[hwt->nreply++] = data;
+	hwt->state = OSIF_STATE_REPLY;
+}
+
+/*
+ * Decodes the words of the current command and executes it if complete
+ *
+ *   hwt - pointer to the osif
+ */
+static inline void osif_decode(struct osif_hwt *hwt) {
+	uint32_t cmd, handle, data;
+	struct kmbox *mb;
+	int ret;
+
+	cmd = hwt->words[0] & OSIF_CMD_MASK;
+	if (cmd < OSIF_CMD_MBOX_GET || cmd > OSIF_CMD_MBOX_TRYPUT) {
+		osif_forward(hwt);
+		return;
+	}
+
+	if (hwt->count < 2) {
+		return;
+	}
+
+	handle = hwt->words[1];
+	if (handle >= OSIF_MAX_HANDLES || !hwt->mbox[handle]) {
+		osif_forward(hwt);
+		return;
+	}
+	mb = hwt->mbox[handle];
+
+	if ((cmd == OSIF_CMD_MBOX_PUT || cmd == OSIF_CMD_MBOX_TRYPUT) && hwt->count < 3) {
+		return;
+	}
+
+	switch (cmd) {
+		case OSIF_CMD_MBOX_GET:
+			hwt->pending = mb;
+			hwt->state = OSIF_STATE_GET;
+			break;
+
+		case OSIF_CMD_MBOX_PUT:
+			hwt->pending = mb;
+			hwt->state = OSIF_STATE_PUT;
+			break;
+
+		case OSIF_CMD_MBOX_TRYGET:
+			data = 0;
+			ret = kmbox_tryget(mb, &data, NULL);
+			osif_reply(hwt, data);
+			osif_reply(hwt, ret);
+			hwt->count = 0;
+			break;
+
+		case OSIF_CMD_MBOX_TRYPUT:
+			ret = kmbox_tryput(mb, hwt->words[2], NULL);
+			osif_reply(hwt, ret);
+			hwt->count = 0;
+			break;
+	}
+}
+
+/*
+ * Processes the commands of the hardware thread until a command must
+ * be forwarded, a mbox operation blocks or the fifo is empty. If the
+ * fifo to the hardware thread is full, the response is retried by the
+ * tasklet instead of waiting with the lock held. Must be called while
+ * holding the lock of the osif.
+ *
+ *   hwt - pointer to the osif
+ */
+static void osif_process(struct osif_hwt *hwt) {
+	uint32_t data;
+
+	while (1) {
+		switch (hwt->state) {
+			case OSIF_STATE_GET:
+				if (!kmbox_tryget(hwt->pending, &data, &hwt->waiter)) {
+					return;
+				}
+				hwt->pending = NULL;
+				hwt->count = 0;
+				osif_reply(hwt, data);
+				break;
+
+			case OSIF_STATE_PUT:
+				if (!kmbox_tryput(hwt->pending, hwt->words[2], &hwt->waiter)) {
+					return;
+				}
+				hwt->pending = NULL;
+				hwt->count = 0;
+				osif_reply(hwt, 0);
+				break;
+
+			case OSIF_STATE_REPLY:
+				while (hwt->sent < hwt->nreply) {
+					if (!osif_fifo_writable(hwt)) {
+						tasklet_schedule(&hwt->tasklet);
+						return;
+					}
+					osif_fifo_write(hwt, hwt->reply[hwt->sent++]);
+				}
+				hwt->nreply = 0;
+				hwt->sent = 0;
+				hwt->state = OSIF_STATE_KERNEL;
+				break;
+
+			case OSIF_STATE_KERNEL:
+				if (!osif_fifo_ready(hwt)) {
+					// interrupt is level triggered, so no data is lost
+					osif_intc_enable_handler(hwt->index);
+					return;
+				}
+				hwt->words[hwt->count++] = osif_fifo_read(hwt);
+				osif_decode(hwt);
+				break;
+
+			default:
+				return;
+		}
+	}
+}
+
+/*
+ * Interrupt handler called by the interrupt controller
+ *
+ *   irq  - index of the hardware thread
+ *   data - pointer to the osif
+ */
+static void osif_interrupt(int irq, void *data) {
+	struct osif_hwt *hwt = (struct osif_hwt *)data;
+	unsigned long flags;
+
+	spin_lock_irqsave(&hwt->lock, flags);
+	if (hwt->state == OSIF_STATE_USER) {
+		wake_up_interruptible(&hwt->wait);
+	} else {
+		osif_process(hwt);
+	}
+	spin_unlock_irqrestore(&hwt->lock, flags);
+}
+
+/*
+ * Tasklet continuing a pending mbox operation or response
+ *
+ *   data - pointer to the osif
+ */
+static void osif_tasklet(unsigned long data) {
+	struct osif_hwt *hwt = (struct osif_hwt *)data;
+	unsigned long flags;
+
+	spin_lock_irqsave(&hwt->lock, flags);
+	if (hwt->state == OSIF_STATE_GET || hwt->state == OSIF_STATE_PUT
+	    || hwt->state == OSIF_STATE_REPLY) {
+		osif_process(hwt);
+	}
+	spin_unlock_irqrestore(&hwt->lock, flags);
+}
+
+/*
+ * Function called by the mbox when a pending operation may continue
+ *
+ *   waiter - pointer to the waiter of the osif
+ */
+static void osif_complete(struct kmbox_waiter *waiter) {
+	struct osif_hwt *hwt = container_of(waiter, struct osif_hwt, waiter);
+
+	tasklet_schedule(&hwt->tasklet);
+}
+
+/*
+ * Returns whether a forwarded command is ready or the wait was breaked
+ *
+ *   hwt - pointer to the osif
+ */
+static inline int osif_cmd_ready(struct osif_hwt *hwt) {
+	return READ_ONCE(hwt->state) == OSIF_STATE_CMD || READ_ONCE(hwt->brk);
+}
+
+/*
+ * Returns whether data for the delegate is ready or the wait was breaked
+ *
+ *   hwt - pointer to the osif
+ */
+static inline int osif_data_ready(struct osif_hwt *hwt) {
+	return osif_fifo_ready(hwt) || READ_ONCE(hwt->brk);
+}
+
+
+/* == Binding functions ================================================ */
+
+/*
+ * Claims the osif of a hardware thread for the file
+ *
+ *   filp  - pointer to the file
+ *   index - index of the hardware thread
+ */
+static long osif_claim(struct file *filp, int index) {
+	struct osif_hwt *hwt;
+	unsigned long flags;
+
+	if (index < 0 || index >= NUM_HWTS) {
+		return -EINVAL;
+	}
+
+	// a revoked file keeps the address space of its previous claim
+	if (filp->private_data || filp->f_mapping != file_inode(filp)->i_mapping) {
+		return -EBUSY;
+	}
+
+	hwt = &osif.hwts[index];
+
+	spin_lock_irqsave(&hwt->lock, flags);
+	if (hwt->file) {
+		spin_unlock_irqrestore(&hwt->lock, flags);
+		return -EBUSY;
+	}
+	hwt->file = filp;
+	hwt->state = OSIF_STATE_USER;
+	hwt->count = 0;
+	hwt->fwd = 0;
+	hwt->brk = 0;
+	spin_unlock_irqrestore(&hwt->lock, flags);
+
+	// the mappings of the file are tracked per osif to revoke them
+	filp->f_mapping = &hwt->mapping;
+	filp->private_data = hwt;
+
+	__printk(KERN_DEBUG "[reconos-osif] "
+	                    "claimed osif %d\n", index);
+
+	return 0;
+}
+
+/*
+ * Enables the kernel path of the osif by taking over its interrupt
+ *
+ *   hwt - pointer to the osif
+ */
+static long osif_enable_kernel(struct osif_hwt *hwt) {
+	if (hwt->kernel) {
+		return 0;
+	}
+
+	if (osif_intc_set_handler(hwt->index, osif_interrupt, hwt) < 0) {
+		return -EBUSY;
+	}
+	hwt->kernel = 1;
+
+	__printk(KERN_DEBUG "[reconos-osif] "
+	                    "enabled kernel path of osif %d\n", hwt->index);
+
+	return 0;
+}
+
+/*
+ * Disables the kernel path of the osif, releases all bound mboxes and
+ * breaks the delegate thread waiting for a command
+ *
+ *   hwt - pointer to the osif
+ */
+static void osif_unbind(struct osif_hwt *hwt) {
+	struct file *files[OSIF_MAX_HANDLES];
+	unsigned long flags;
+	int i;
+
+	if (!hwt->kernel) {
+		return;
+	}
+
+	spin_lock_irqsave(&hwt->lock, flags);
+	if (hwt->pending) {
+		kmbox_cancel(hwt->pending, &hwt->waiter);
+		hwt->pending = NULL;
+	}
+	hwt->state = OSIF_STATE_USER;
+	hwt->nreply = 0;
+	hwt->sent = 0;
+	hwt->brk = 1;
+	for (i = 0; i < OSIF_MAX_HANDLES; i++) {
+		files[i] = hwt->mbox_file[i];
+		hwt->mbox_file[i] = NULL;
+		hwt->mbox[i] = NULL;
+	}
+	spin_unlock_irqrestore(&hwt->lock, flags);
+
+	wake_up_interruptible(&hwt->wait);
+
+	osif_intc_set_handler(hwt->index, NULL, NULL);
+	tasklet_kill(&hwt->tasklet);
+	hwt->kernel = 0;
+
+	for (i = 0; i < OSIF_MAX_HANDLES; i++) {
+		if (files[i]) {
+			fput(files[i]);
+		}
+	}
+
+	__printk(KERN_DEBUG "[reconos-osif] "
+	                    "disabled kernel path of osif %d\n", hwt->index);
+}
+
+/*
+ * Revokes the claim of the file, such that all copies of it fail and
+ * its mappings are removed, and frees the osif for another claim
+ *
+ *   filp - pointer to the file
+ *   hwt  - pointer to the osif
+ */
+static void osif_revoke(struct file *filp, struct osif_hwt *hwt) {
+	unsigned long flags;
+
+	osif_unbind(hwt);
+
+	// unmapping before releasing keeps mappings of the next claim
+	WRITE_ONCE(filp->private_data, NULL);
+	unmap_mapping_range(&hwt->mapping, 0, 0, 1);
+
+	spin_lock_irqsave(&hwt->lock, flags);
+	hwt->file = NULL;
+	spin_unlock_irqrestore(&hwt->lock, flags);
+
+	__printk(KERN_DEBUG "[reconos-osif] "
+	                    "revoked osif %d\n", hwt->index);
+}
+
+/*
+ * Binds a resource handle to a kernel mbox or unbinds it
+ *
+ *   hwt  - pointer to the osif
+ *   bind - handle and file descriptor of the mbox (negative to unbind)
+ */
+static long osif_bind_mbox(struct osif_hwt *hwt,
+                           struct reconos_osif_mbox *bind) {
+	struct file *file = NULL, *old;
+	struct kmbox *mb = NULL;
+	unsigned long flags;
+
+	long ret;
+
+	if (bind->handle < 0 || bind->handle >= OSIF_MAX_HANDLES) {
+		return -EINVAL;
+	}
+
+	ret = osif_enable_kernel(hwt);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (bind->fd >= 0) {
+		file = fget(bind->fd);
+		if (!file) {
+			return -EBADF;
+		}
+
+		mb = kmbox_from_file(file);
+		if (!mb) {
+			fput(file);
+			return -EINVAL;
+		}
+	}
+
+	spin_lock_irqsave(&hwt->lock, flags);
+	old = hwt->mbox_file[bind->handle];
+	if (old && hwt->pending == hwt->mbox[bind->handle]) {
+		spin_unlock_irqrestore(&hwt->lock, flags);
+		if (file) {
+			fput(file);
+		}
+		return -EBUSY;
+	}
+	hwt->mbox_file[bind->handle] = file;
+	hwt->mbox[bind->handle] = mb;
+	spin_unlock_irqrestore(&hwt->lock, flags);
+
+	if (old) {
+		fput(old);
+	}
+
+	return 0;
+}
+
+
+/* == File operations ================================================== */
+
+/*
+ * Function called when opening the device
+ *
+ *    @see kernel documentation
+ */
+static int osif_open(struct inode *inode, struct file *filp) {
+	filp->private_data = NULL;
+
+	return 0;
+}
+
+/*
+ * Function called when closing the device
+ *
+ *    @see kernel documentation
+ */
+static int osif_release(struct inode *inode, struct file *filp) {
+	struct osif_hwt *hwt;
+
+	unsigned long flags;
+
+	hwt = (struct osif_hwt *)filp->private_data;
+	if (hwt) {
+		osif_unbind(hwt);
+
+		spin_lock_irqsave(&hwt->lock, flags);
+		hwt->file = NULL;
+		spin_unlock_irqrestore(&hwt->lock, flags);
+	}
+
+	return 0;
+}
+
+/*
+ * Function called when reading from the device. Reads the words of a
+ * forwarded command, at least one, blocking if none is available.
+ *
+ *    @see kernel documentation
+ */
+static ssize_t osif_read(struct file *filp, char __user *buf,
+                         size_t count, loff_t *pos) {
+	struct osif_hwt *hwt;
+	uint32_t data;
+	size_t done;
+
+	hwt = (struct osif_hwt *)filp->private_data;
+	if (!hwt || !hwt->kernel) {
+		return -EINVAL;
+	}
+
+	if (READ_ONCE(hwt->state) != OSIF_STATE_USER) {
+		return -EBUSY;
+	}
+
+	count &= ~0x3;
+	for (done = 0; done < count; done += 4) {
+		if (hwt->fwd < hwt->count) {
+			data = hwt->words[hwt->fwd++];
+		} else {
+			if (!osif_fifo_ready(hwt)) {
+				if (done > 0) {
+					break;
+				}
+
+				osif_intc_enable_handler(hwt->index);
+				if (wait_event_interruptible(hwt->wait, osif_data_ready(hwt)) < 0) {
+					return -ERESTARTSYS;
+				}
+
+				if (!osif_fifo_ready(hwt)) {
+					hwt->brk = 0;
+					return -EINTR;
+				}
+			}
+			data = osif_fifo_read(hwt);
+		}
+
+		if (put_user(data, (uint32_t __user *)(buf + done))) {
+			return -EFAULT;
+		}
+	}
+
+	hwt->brk = 0;
+
+	return done;
+}
+
+/*
+ * Function called when writing to the device. Writes all words to
+ * the hardware thread, sleeping while its fifo is full, or returns
+ * -EAGAIN for non-blocking files.
+ *
+ *    @see kernel documentation
+ */
+static ssize_t osif_write(struct file *filp, const char __user *buf,
+                          size_t count, loff_t *pos) {
+	struct osif_hwt *hwt;
+	uint32_t data;
+	size_t done;
+	unsigned long flags;
+
+	hwt = (struct osif_hwt *)filp->private_data;
+	if (!hwt || !hwt->kernel) {
+		return -EINVAL;
+	}
+
+	count &= ~0x3;
+	for (done = 0; done < count; done += 4) {
+		if (get_user(data, (const uint32_t __user *)(buf + done))) {
+			return done > 0 ? done : -EFAULT;
+		}
+
+		spin_lock_irqsave(&hwt->lock, flags);
+		while (!osif_fifo_writable(hwt)) {
+			spin_unlock_irqrestore(&hwt->lock, flags);
+
+			if (done > 0) {
+				return done;
+			}
+			if (filp->f_flags & O_NONBLOCK) {
+				return -EAGAIN;
+			}
+			if (signal_pending(current)) {
+				return -ERESTARTSYS;
+			}
+			usleep_range(10, 100);
+
+			spin_lock_irqsave(&hwt->lock, flags);
+		}
+		osif_fifo_write(hwt, data);
+		spin_unlock_irqrestore(&hwt->lock, flags);
+	}
+
+	return done;
+}
+
+/*
+ * Lets the kernel process the commands of the hardware thread and
+ * waits until a command must be forwarded to the delegate thread.
+ *
+ *   hwt - pointer to the osif
+ *   cmd - pointer to store the command in
+ */
+static long osif_next_cmd(struct osif_hwt *hwt, uint32_t *cmd) {
+	unsigned long flags;
+
+	spin_lock_irqsave(&hwt->lock, flags);
+	if (hwt->state == OSIF_STATE_USER) {
+		hwt->state = OSIF_STATE_KERNEL;
+		hwt->count = 0;
+		hwt->fwd = 0;
+		osif_process(hwt);
+	}
+	spin_unlock_irqrestore(&hwt->lock, flags);
+
+	if (wait_event_interruptible(hwt->wait, osif_cmd_ready(hwt)) < 0) {
+		return -ERESTARTSYS;
+	}
+
+	spin_lock_irqsave(&hwt->lock, flags);
+	hwt->brk = 0;
+	if (hwt->state != OSIF_STATE_CMD) {
+		spin_unlock_irqrestore(&hwt->lock, flags);
+		return -EINTR;
+	}
+	*cmd = hwt->words[0];
+	hwt->fwd = 1;
+	hwt->state = OSIF_STATE_USER;
+	spin_unlock_irqrestore(&hwt->lock, flags);
+
+	return 0;
+}
+
+/*
+ * Function called when issuing an ioctl
+ *
+ * @see kernel documentation
+ */
+static long osif_ioctl(struct file *filp, unsigned int cmd,
+                       unsigned long arg) {
+	struct osif_hwt *hwt;
+	struct reconos_osif_mbox bind;
+	unsigned long flags;
+	uint32_t data;
+	int index;
+	long ret;
+
+	hwt = (struct osif_hwt *)filp->private_data;
+
+	if (cmd == RECONOS_OSIF_CLAIM) {
+		if (copy_from_user(&index, (int *)arg, sizeof(int))) {
+			return -EFAULT;
+		}
+
+		return osif_claim(filp, index);
+	}
+
+	if (!hwt) {
+		return -EINVAL;
+	}
+
+	switch (cmd) {
+		case RECONOS_OSIF_BIND_MBOX:
+			if (copy_from_user(&bind, (struct reconos_osif_mbox *)arg, sizeof(struct reconos_osif_mbox))) {
+				return -EFAULT;
+			}
+
+			return osif_bind_mbox(hwt, &bind);
+
+		case RECONOS_OSIF_UNBIND:
+			osif_unbind(hwt);
+			break;
+
+		case RECONOS_OSIF_REVOKE:
+			osif_revoke(filp, hwt);
+			break;
+
+		case RECONOS_OSIF_NEXT_CMD:
+			if (!hwt->kernel) {
+				return -EINVAL;
+			}
+
+			ret = osif_next_cmd(hwt, &data);
+			if (ret == 0 && copy_to_user((uint32_t *)arg, &data, sizeof(uint32_t))) {
+				return -EFAULT;
+			}
+
+			return ret;
+
+		case RECONOS_OSIF_BREAK:
+			spin_lock_irqsave(&hwt->lock, flags);
+			hwt->brk = 1;
+			spin_unlock_irqrestore(&hwt->lock, flags);
+
+			wake_up_interruptible(&hwt->wait);
+			break;
+
+		default:
+			return -EINVAL;
+	}
+
+	return 0;
+}
+
+/*
+ * Function called when accessing a mapping of the device. Inserts the
+ * registers of the claimed osif, unless the claim was revoked.
+ *
+ * @see kernel documentation
+ */
+static vm_fault_t osif_vm_fault(struct vm_fault *vmf) {
+	struct osif_hwt *hwt;
+
+	hwt = (struct osif_hwt *)READ_ONCE(vmf->vma->vm_file->private_data);
+	if (!hwt) {
+		return VM_FAULT_SIGBUS;
+	}
+
+	return vmf_insert_pfn(vmf->vma, vmf->address,
+	                      (osif.base_addr + hwt->index * osif.stride) >> PAGE_SHIFT);
+}
+
+static const struct vm_operations_struct osif_vm_ops = {
+	.fault = osif_vm_fault,
+};
+
+/*
+ * Function called when mapping the device. Maps the registers of the
+ * claimed osif, which requires the osifs to be placed on separate pages.
+ * The registers are inserted on access, so that revoking the claim
+ * removes them from all mappings.
+ *
+ * @see kernel documentation
+ */
+static int osif_mmap(struct file *filp, struct vm_area_struct *vma) {
+	struct osif_hwt *hwt;
+
+	hwt = (struct osif_hwt *)filp->private_data;
+	if (!hwt) {
+		return -EINVAL;
+	}
+
+	if (osif.stride % PAGE_SIZE) {
+		return -ENODEV;
+	}
+
+	if (vma->vm_pgoff != 0 || vma->vm_end - vma->vm_start != PAGE_SIZE) {
+		return -EINVAL;
+	}
+
+	vma->vm_page_prot = pgprot_noncached(vma->vm_page_prot);
+	vm_flags_set(vma, VM_IO | VM_PFNMAP | VM_DONTEXPAND | VM_DONTDUMP);
+	vma->vm_ops = &osif_vm_ops;
+
+	return 0;
+}
+
+/*
+ * Struct for file operations to register driver
+ *
+ *    @see kernel documentation
+ */
+static struct file_operations osif_fops = {
+	.owner          = THIS_MODULE,
+	.open           = osif_open,
+	.release        = osif_release,
+	.read           = osif_read,
+	.write          = osif_write,
+	.unlocked_ioctl = osif_ioctl,
+	.mmap           = osif_mmap,
+};
+
+
+/* == Sysfs attributes ================================================= */
+
+/*
+ * Prints the distance of the registers of two osifs, which user space
+ * needs to address the osifs when mapping them from /dev/mem.
+ *
+ *   @see kernel documentation
+ */
+static ssize_t stride_show(struct device *d, struct device_attribute *attr,
+                           char *buf) {
+	return scnprintf(buf, PAGE_SIZE, "%u\n", osif.stride);
+}
+static DEVICE_ATTR_RO(stride);
+
+static struct attribute *osif_attrs[] = {
+	&dev_attr_stride.attr,
+	NULL
+};
+
+static const struct attribute_group osif_group = {
+	.attrs = osif_attrs,
+};
+
+static const struct attribute_group *osif_groups[] = {
+	&osif_group,
+	NULL
+};
+
+
+/* == Init and exit functions ========================================== */
+
+/*
+ * Struct for device tree matching
+ */
+static struct of_device_id osif_of_match[] =
+{
+    { .compatible = "upb,reconos-osif-3.1"},
+    {}
+};
+
+/*
+ * @see header
+ */
+int osif_init() {
+	struct osif_dev *dev = &osif;
+	struct device_node *node = NULL;
+	struct resource res;
+	struct osif_hwt *hwt;
+	int i;
+
+	__printk(KERN_INFO "[reconos-osif] "
+	                   "initializing driver ...\n");
+
+	// get matching of node
+	node = of_find_matching_node(NULL, osif_of_match);
+	if (!node)
+	{
+		__printk(KERN_ERR "[reconos-osif] "
+		                  "device tree node not found\n");
+		goto of_failed;
+	}
+
+	strncpy(dev->name, "reconos-osif", 25);
+
+	// getting address from device tree
+	if (of_address_to_resource(node, 0, &res))
+	{
+		__printk(KERN_ERR "[reconos-osif] "
+	                      "address could not be determined\n");
+		goto of_failed;
+	}
+	dev->base_addr = res.start;
+	dev->mem_size = res.end - res.start + 1;
+	__printk(KERN_INFO "[reconos-osif] "
+	                   "found memory at 0x%08x with size 0x%x\n",
+	                   dev->base_addr, dev->mem_size);
+
+	if (of_property_read_u32(node, "reconos,osif-stride", &dev->stride)) {
+		dev->stride = OSIF_FIFO_MEM_SIZE;
+	}
+
+	if (dev->mem_size < NUM_HWTS * dev->stride) {
+		__printk(KERN_ERR "[reconos-osif] "
+		                  "memory too small for %d osifs\n", NUM_HWTS);
+		goto of_failed;
+	}
+
+	// the region is not requested, since user space maps it as well
+	dev->mem = ioremap(dev->base_addr, dev->mem_size);
+	if (!dev->mem) {
+		__printk(KERN_WARNING "[reconos-osif] "
+		                      "ioremap failed\n");
+		goto of_failed;
+	}
+
+	dev->hwts = kcalloc(NUM_HWTS, sizeof(struct osif_hwt), GFP_KERNEL);
+	if (!dev->hwts) {
+		__printk(KERN_WARNING "[reconos-osif] "
+		                      "cannot allocate osifs\n");
+		goto hwts_failed;
+	}
+
+	for (i = 0; i < NUM_HWTS; i++) {
+		hwt = &dev->hwts[i];
+		hwt->index = i;
+		hwt->mem = dev->mem + i * dev->stride;
+		hwt->state = OSIF_STATE_USER;
+		INIT_LIST_HEAD(&hwt->waiter.list);
+		hwt->waiter.complete = osif_complete;
+		tasklet_init(&hwt->tasklet, osif_tasklet, (unsigned long)hwt);
+		init_waitqueue_head(&hwt->wait);
+		spin_lock_init(&hwt->lock);
+		address_space_init_once(&hwt->mapping);
+	}
+
+	// registering misc device
+	dev->mdev.minor = MISC_DYNAMIC_MINOR;
+	dev->mdev.fops = &osif_fops;
+	dev->mdev.name = dev->name;
+	dev->mdev.groups = osif_groups;
+	// osifs are claimed exclusively, so that any user may open the device
+	dev->mdev.mode = 0666;
+
+	if (misc_register(&dev->mdev) < 0) {
+		__printk(KERN_WARNING "[reconos-osif] "
+		                      "error while registering misc-device\n");
+		goto reg_failed;
+	}
+
+	goto out;
+
+reg_failed:
+	kfree(dev->hwts);
+
+hwts_failed:
+	iounmap(dev->mem);
+
+of_failed:
+	return -1;
+
+out:
+	return 0;
+}
+
+/*
+ * @see header
+ */
+int osif_exit() {
+	struct osif_dev *dev = &osif;
+	int i;
+
+	__printk(KERN_INFO "[reconos-osif] "
+	                   "removing driver ...\n");
+
+	misc_deregister(&dev->mdev);
+
+	for (i = 0; i < NUM_HWTS; i++) {
+		tasklet_kill(&dev->hwts[i].tasklet);
+	}
+
+	kfree(dev->hwts);
+	iounmap(dev->mem);
+
+	return 0;
+}
@@ -0,0 +1,45 @@
+/*
+ *                                                        ____  _____
+ *                            ________  _________  ____  / __ \/ ___/
+ *                           / ___/ _ \/ ___/ __ \/ __ \/ / / /\__ \
+ *                          / /  /  __/ /__/ /_/ / / / / /_/ /___/ /
+ *                         /_/   \___/\___/\____/_/ /_/\____//____/
+ *
+ * ======================================================================
+ *
+ *   title:        Linux Driver - Kernel OSIF
+ *
+ *   project:      ReconOS
+ *   author:       Christoph Rüthing, University of Paderborn
+ *   description:  Optional kernel path for the OSIF of a hardware thread.
+ *                 Mbox commands on handles bound to kernel mboxes are
+ *                 completed directly in the interrupt handler, while all
+ *                 other commands are forwarded to the delegate thread.
+ *
+ * ======================================================================
+ */
+
+#ifndef RECONOS_DRV_OSIF_H
+#define RECONOS_DRV_OSIF_H
+
+#include "reconos.h"
+
+/*
+ * Initialization function called by module loading
+ *
+ *   no parameters
+ *
+ *   @returns -1 on failure, otherwise 0
+ */
+extern int osif_init(void);
+
+/*
+ * Exit function called by module unloading
+ *
+ *   no parameters
+ *
+ *   @returns always 0
+ */
+extern int osif_exit(void);
+
+#endif /* RECONOS_DRV_OSIF_H */
@@ -26,6 +26,7 @@
 
 #include <linux/spinlock.h>
 #include <linux/wait.h>
+#include <linux/poll.h>
 #include <linux/sched.h>
 #include <linux/interrupt.h>
 #include <linux/slab.h>
@@ -55,10 +56,16 @@
  *   irq             - irq number (should always be IRQ)
  *
  *   mem             - pointer to the io memory
- *   wait            - wait queue for interrupts
+ *   wait            - array of wait queues, one per hardware thread
+ *   wait_any        - wait queue for poll and wait_any, woken on every
+ *                     interrupt
  *   irq_reg         - array representing the interrupt signals
  *   irq_enable      - array representing the interrupt enables
  *   irq_break       - array indicating whether breaked in wait
+ *   irq_pending     - array of the interrupts raised in the last handler
+ *   handler         - array of kernel handlers, one per hardware thread,
+ *                     called instead of waking up user space
+ *   handler_data    - array of the data passed to the handlers
  *
  *   mdev            - misc device data structure
  *
@@ -71,10 +78,14 @@ struct osif_intc_dev {
 	int irq;
 
 	void __iomem *mem;
-	wait_queue_head_t wait;
+	wait_queue_head_t *wait;
+	wait_queue_head_t wait_any;
 	uint32_t *irq_reg;
 	uint32_t *irq_enable;
 	uint32_t *irq_break;
+	uint32_t *irq_pending;
+	osif_intc_handler_t *handler;
+	void **handler_data;
 
 	struct miscdevice mdev;
 
@@ -83,19 +94,34 @@ struct osif_intc_dev {
 
 static struct osif_intc_dev osif_intc;
 
+/*
+ * Struct representing an opened file of the device
+ *
+ *   dev   - pointer to the interrupt controller struct
+ *   armed - array of the interrupts enabled by enable and wait_any
+ *           which were not reported as ready yet
+ */
+struct osif_intc_file {
+	struct osif_intc_dev *dev;
+	uint32_t *armed;
+};
+
 
 /* == Low level functions ============================================== */
 
 /*
  * Reads the interrupt register
  *
- *   dev - pointer to the interrupt controller struct
+ *   dev     - pointer to the interrupt controller struct
+ *   pending - array to store the newly raised interrupts in
  */
-static inline void read_interrupt(struct osif_intc_dev *dev) {
+static inline void read_interrupt(struct osif_intc_dev *dev,
+                                  uint32_t *pending) {
 	int i;
 
 	for (i = 0; i < DYNAMIC_REG_COUNT; i++) {
-		dev->irq_reg[i] |= ioread32(dev->mem + i * 4) & dev->irq_enable[i];
+		pending[i] = ioread32(dev->mem + i * 4) & dev->irq_enable[i];
+		dev->irq_reg[i] |= pending[i];
 	}
 }
 /*
@@ -201,6 +227,25 @@ static inline int get_break(struct osif_intc_dev *dev,
 	return (dev->irq_break[irq / 32] >> irq % 32) & 0x1;
 }
 
+/*
+ * Returns whether one of the armed interrupts of the file is ready,
+ * i.e. raised or breaked.
+ *
+ *   file - pointer to the file struct
+ */
+static inline int get_ready(struct osif_intc_file *file) {
+	struct osif_intc_dev *dev = file->dev;
+	int i;
+
+	for (i = 0; i < DYNAMIC_REG_COUNT; i++) {
+		if ((dev->irq_reg[i] | dev->irq_break[i]) & file->armed[i]) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
 /* == File operations ================================================== */
 
 /*
@@ -209,7 +254,83 @@ static inline int get_break(struct osif_intc_dev *dev,
  *    @see kernel documentation
  */
 static int osif_intc_open(struct inode *inode, struct file *filp) {
-	filp->private_data = &osif_intc;
+	struct osif_intc_file *file;
+
+	file = kzalloc(sizeof(struct osif_intc_file), GFP_KERNEL);
+	if (!file) {
+		return -ENOMEM;
+	}
+
+	file->armed = kcalloc(DYNAMIC_REG_COUNT, sizeof(uint32_t), GFP_KERNEL);
+	if (!file->armed) {
+		kfree(file);
+		return -ENOMEM;
+	}
+
+	file->dev = &osif_intc;
+	filp->private_data = file;
+
+	return 0;
+}
+
+/*
+ * Function called when closing the device
+ *
+ *    @see kernel documentation
+ */
+static int osif_intc_release(struct inode *inode, struct file *filp) {
+	struct osif_intc_file *file;
+
+	file = (struct osif_intc_file *)filp->private_data;
+
+	kfree(file->armed);
+	kfree(file);
+
+	return 0;
+}
+
+/*
+ * Enables the interrupts of the given bitmask for the file and waits
+ * until one of them is ready. The bitmask is replaced by the ready ones,
+ * which must be enabled again after the osif was drained.
+ *
+ *   file     - pointer to the file struct
+ *   mask     - array of DYNAMIC_REG_COUNT words
+ *   nonblock - do not wait if none is ready
+ */
+static long osif_intc_wait_any(struct osif_intc_file *file, uint32_t *mask,
+                               int nonblock) {
+	struct osif_intc_dev *dev = file->dev;
+	unsigned long flags;
+	int i, irq;
+
+	spin_lock_irqsave(&dev->lock, flags);
+	for (irq = 0; irq < NUM_HWTS; irq++) {
+		// keep already armed interrupts to not lose raised ones
+		if ((mask[irq / 32] & ~file->armed[irq / 32]) >> irq % 32 & 0x1) {
+			file->armed[irq / 32] |= 0x1 << irq % 32;
+			disable_break(dev, irq);
+			enable_interrupt(dev, irq);
+		}
+	}
+	spin_unlock_irqrestore(&dev->lock, flags);
+
+	if (nonblock) {
+		if (!get_ready(file)) {
+			return -EAGAIN;
+		}
+	} else {
+		if (wait_event_interruptible(dev->wait_any, get_ready(file)) < 0) {
+			return -ERESTARTSYS;
+		}
+	}
+
+	spin_lock_irqsave(&dev->lock, flags);
+	for (i = 0; i < DYNAMIC_REG_COUNT; i++) {
+		mask[i] = (dev->irq_reg[i] | dev->irq_break[i]) & file->armed[i];
+		file->armed[i] &= ~mask[i];
+	}
+	spin_unlock_irqrestore(&dev->lock, flags);
 
 	return 0;
 }
@@ -221,14 +342,38 @@ static int osif_intc_open(struct inode *inode, struct file *filp) {
  */
 static long osif_intc_ioctl(struct file *filp, unsigned int cmd,
                                unsigned long arg) {
+	struct osif_intc_file *file;
 	struct osif_intc_dev *dev;
+	struct reconos_osif_mask *mask;
 	int irq;
 	unsigned long ret, flags;
+	long res;
+
+	file = (struct osif_intc_file *)filp->private_data;
+	dev = file->dev;
+
+	if (cmd == RECONOS_OSIF_INTC_WAIT_ANY) {
+		mask = kmalloc(sizeof(struct reconos_osif_mask), GFP_KERNEL);
+		if (!mask) {
+			return -ENOMEM;
+		}
 
-	dev = (struct osif_intc_dev *)filp->private_data;
+		if (copy_from_user(mask, (struct reconos_osif_mask *)arg, sizeof(struct reconos_osif_mask))) {
+			kfree(mask);
+			return -EFAULT;
+		}
+
+		res = osif_intc_wait_any(file, mask->mask, filp->f_flags & O_NONBLOCK);
+		if (res == 0 && copy_to_user((struct reconos_osif_mask *)arg, mask, sizeof(struct reconos_osif_mask))) {
+			res = -EFAULT;
+		}
+
+		kfree(mask);
+		return res;
+	}
 
 	ret = copy_from_user(&irq, (unsigned int *)arg, sizeof(unsigned int));
-	if (irq > NUM_HWTS) {
+	if (irq < 0 || irq >= NUM_HWTS) {
 		__printk(KERN_WARNING "[reconos-osif-intc] "
 		                      "index out of range, aborting wait ...\n");
 
@@ -245,7 +390,7 @@ static long osif_intc_ioctl(struct file *filp, unsigned int cmd,
 			enable_interrupt(dev, irq);
 			spin_unlock_irqrestore(&dev->lock, flags);
 
-			if (wait_event_interruptible(dev->wait, get_interrupt(dev, irq) || get_break(dev, irq)) < 0) {
+			if (wait_event_interruptible(dev->wait[irq], get_interrupt(dev, irq) || get_break(dev, irq)) < 0) {
 				__printk(KERN_INFO "[reconos-osif-intc] "
 				                   "interrupted in waiting, aborting ...\n");
 
@@ -265,7 +410,18 @@ static long osif_intc_ioctl(struct file *filp, unsigned int cmd,
 			disable_interrupt(dev, irq);
 			spin_unlock_irqrestore(&dev->lock, flags);
 
-			wake_up_interruptible(&dev->wait);
+			wake_up_interruptible(&dev->wait[irq]);
+			wake_up_interruptible(&dev->wait_any);
+			break;
+
+		case RECONOS_OSIF_INTC_ENABLE:
+			spin_lock_irqsave(&dev->lock, flags);
+			if (!((file->armed[irq / 32] >> irq % 32) & 0x1)) {
+				file->armed[irq / 32] |= 0x1 << irq % 32;
+				disable_break(dev, irq);
+				enable_interrupt(dev, irq);
+			}
+			spin_unlock_irqrestore(&dev->lock, flags);
 			break;
 
 		default:
@@ -275,6 +431,26 @@ static long osif_intc_ioctl(struct file *filp, unsigned int cmd,
 	return 0;
 }
 
+/*
+ * Function called when polling the device. The device is readable if
+ * one of the interrupts enabled by this file is ready.
+ *
+ * @see kernel documentation
+ */
+static unsigned int osif_intc_poll(struct file *filp, poll_table *wait) {
+	struct osif_intc_file *file;
+
+	file = (struct osif_intc_file *)filp->private_data;
+
+	poll_wait(filp, &file->dev->wait_any, wait);
+
+	if (get_ready(file)) {
+		return POLLIN | POLLRDNORM;
+	}
+
+	return 0;
+}
+
 /*
  * Struct for file operations to register driver
  *
@@ -283,7 +459,9 @@ static long osif_intc_ioctl(struct file *filp, unsigned int cmd,
 static struct file_operations osif_intc_fops = {
 	.owner          = THIS_MODULE,
 	.open           = osif_intc_open,
+	.release        = osif_intc_release,
 	.unlocked_ioctl = osif_intc_ioctl,
+	.poll           = osif_intc_poll,
 };
 
 
@@ -296,20 +474,53 @@ static struct file_operations osif_intc_fops = {
  */
 static irqreturn_t interrupt(int irq, void *data) {
 	struct osif_intc_dev *dev;
+	osif_intc_handler_t handler;
+	void *handler_data;
 	unsigned long flags;
+	uint32_t pending;
+	int i, hwt, any;
 
 	dev = (struct osif_intc_dev *)data;
 
 	// read irqs and disable active ones
 	spin_lock_irqsave(&dev->lock, flags);
-	read_interrupt(dev);
+	read_interrupt(dev, dev->irq_pending);
 	disable_interrupt_active(dev);
 	spin_unlock_irqrestore(&dev->lock, flags);
 
 	__printk(KERN_DEBUG "[reconos-osif-intc] "
 	                    " osif interrupt: 0x%x\n", dev->irq_reg[0]);
 
-	wake_up_interruptible(&dev->wait);
+	// only wake the delegates whose interrupt was raised
+	any = 0;
+	for (i = 0; i < DYNAMIC_REG_COUNT; i++) {
+		pending = dev->irq_pending[i];
+		any |= pending != 0;
+		while (pending) {
+			hwt = i * 32 + __ffs(pending);
+			pending &= pending - 1;
+
+			if (hwt >= NUM_HWTS) {
+				continue;
+			}
+
+			// the handler may be changed concurrently
+			spin_lock_irqsave(&dev->lock, flags);
+			handler = dev->handler[hwt];
+			handler_data = dev->handler_data[hwt];
+			spin_unlock_irqrestore(&dev->lock, flags);
+
+			if (handler) {
+				handler(hwt, handler_data);
+			} else {
+				wake_up_interruptible(&dev->wait[hwt]);
+			}
+		}
+	}
+
+	if (any) {
+		wake_up_interruptible(&dev->wait_any);
+	}
 
 	return IRQ_HANDLED;
 }
@@ -333,6 +544,7 @@ int osif_intc_init() {
 	struct osif_intc_dev *dev = NULL;
 	struct device_node *node = NULL;
 	struct resource res;
+	int i;
 
 	__printk(KERN_INFO "[reconos-osif] "
 	                   "initializing driver ...\n");
@@ -353,8 +565,19 @@ int osif_intc_init() {
 	// set some general information of intc
 	strncpy(dev->name, "reconos-osif-intc", 25);
 
-	init_waitqueue_head(&dev->wait);
 	spin_lock_init(&dev->lock);
+	init_waitqueue_head(&dev->wait_any);
+
+	// allocating wait queues
+	dev->wait = kcalloc(NUM_HWTS, sizeof(wait_queue_head_t), GFP_KERNEL);
+	if (!dev->wait) {
+		__printk(KERN_WARNING "[reconos-osif-intc] "
+		                      "cannot allocate wait queues\n");
+		goto wait_failed;
+	}
+	for (i = 0; i < NUM_HWTS; i++) {
+		init_waitqueue_head(&dev->wait[i]);
+	}
 
 	// allocating interrupt-register
 	dev->irq_reg = kcalloc(DYNAMIC_REG_COUNT, sizeof(uint32_t), GFP_KERNEL);
@@ -378,6 +601,21 @@ int osif_intc_init() {
 		goto irqbreak_failed;
 	}
 
+	dev->irq_pending = kcalloc(DYNAMIC_REG_COUNT, sizeof(uint32_t), GFP_KERNEL);
+	if (!dev->irq_pending) {
+		__printk(KERN_WARNING "[reconos-osif-intc] "
+		                      "cannot allocate irq-pending\n");
+		goto irqpending_failed;
+	}
+
+	dev->handler = kcalloc(NUM_HWTS, sizeof(osif_intc_handler_t), GFP_KERNEL);
+	dev->handler_data = kcalloc(NUM_HWTS, sizeof(void *), GFP_KERNEL);
+	if (!dev->handler || !dev->handler_data) {
+		__printk(KERN_WARNING "[reconos-osif-intc] "
+		                      "cannot allocate handlers\n");
+		goto handler_failed;
+	}
+
 	// getting address from device tree
 	if (of_address_to_resource(node, 0, &res))
 	{
@@ -453,6 +691,12 @@ map_failed:
 	release_mem_region(dev->base_addr, dev->mem_size);
 
 req_failed:
+handler_failed:
+	kfree(dev->handler);
+	kfree(dev->handler_data);
+	kfree(dev->irq_pending);
+
+irqpending_failed:
 	kfree(dev->irq_break);
 
 irqbreak_failed:
@@ -462,6 +706,9 @@ irqenable_failed:
 	kfree(dev->irq_reg);
 
 irqreg_failed:
+	kfree(dev->wait);
+
+wait_failed:
 of_failed:
 	return -1;
 
@@ -488,6 +735,54 @@ int osif_intc_exit() {
 	kfree(dev->irq_enable);
 	kfree(dev->irq_reg);
 	kfree(dev->irq_break);
+	kfree(dev->irq_pending);
+	kfree(dev->handler);
+	kfree(dev->handler_data);
+	kfree(dev->wait);
 
 	return 0;
 }
+
+/*
+ * @see header
+ */
+int osif_intc_set_handler(int irq, osif_intc_handler_t handler,
+                          void *data) {
+	struct osif_intc_dev *dev = &osif_intc;
+	unsigned long flags;
+	int ret = 0;
+
+	if (irq < 0 || irq >= NUM_HWTS) {
+		return -EINVAL;
+	}
+
+	spin_lock_irqsave(&dev->lock, flags);
+	if (handler && dev->handler[irq]) {
+		ret = -EBUSY;
+	} else {
+		disable_interrupt(dev, irq);
+		dev->irq_reg[irq / 32] &= ~(0x1 << irq % 32);
+		dev->handler[irq] = handler;
+		dev->handler_data[irq] = data;
+	}
+	spin_unlock_irqrestore(&dev->lock, flags);
+
+	// the handler is only called from the interrupt, so wait for it
+	synchronize_irq(dev->irq);
+
+	return ret;
+}
+
+/*
+ * @see header
+ */
+void osif_intc_enable_handler(int irq) {
+	struct osif_intc_dev *dev = &osif_intc;
+	unsigned long flags;
+
+	spin_lock_irqsave(&dev->lock, flags);
+	if (dev->handler[irq]) {
+		enable_interrupt(dev, irq);
+	}
+	spin_unlock_irqrestore(&dev->lock, flags);
+}
@@ -44,4 +44,34 @@ extern int osif_intc_init(void);
  */
 extern int osif_intc_exit(void);
 
+/*
+ * Type of a kernel handler of an interrupt
+ *
+ *   irq  - interrupt index which was raised
+ *   data - data passed when setting the handler
+ */
+typedef void (*osif_intc_handler_t)(int irq, void *data);
+
+/*
+ * Sets a kernel handler for an interrupt, which is called from the
+ * interrupt context instead of waking up user space. The interrupt is
+ * disabled when calling the handler and must be enabled again by
+ * osif_intc_enable_handler after the osif was drained.
+ *
+ *   irq     - interrupt index to set the handler for
+ *   handler - handler to call or NULL to remove the handler
+ *   data    - data passed to the handler
+ *
+ *   @returns -EBUSY if already set, otherwise 0
+ */
+extern int osif_intc_set_handler(int irq, osif_intc_handler_t handler,
+                                 void *data);
+
+/*
+ * Enables an interrupt having a kernel handler
+ *
+ *   irq - interrupt index to enable
+ */
+extern void osif_intc_enable_handler(int irq);
+
 #endif /* RECONOS_DRV_OSIF_INTC_H */
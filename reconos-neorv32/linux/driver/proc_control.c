@@ -14,7 +14,9 @@
  *   description:  Driver for the proc control of the ReconOS system. It
  *                 allows to control the dirfferent components, reset the
  *                 entire system and read out some information like the
- *                 number of OSIFs, ...
+ *                 number of OSIFs, ... The memory statistics of the
+ *                 hardware threads are exported through sysfs in
+ *                 /sys/class/misc/reconos-proc-control/stats.
  *
  * ======================================================================
  */
@@ -36,6 +38,15 @@
 #include <asm/io.h>
 #include <asm/uaccess.h>
 #include <asm/pgtable.h>
+#include <linux/mm.h>
+#include <linux/list.h>
+#include <linux/mutex.h>
+#include <linux/highmem.h>
+#include <linux/device.h>
+#include <asm/cacheflush.h>
+#if defined(RECONOS_ARCH_zynq)
+#include <asm/outercache.h>
+#endif
 
 
 /* == General definitions ============================================== */
@@ -51,6 +62,8 @@
  *   sys_reset_reg       - write to initiate system reset
  *   hwt_reset_reg       - write to set reset of hardware threads
  *   hwt_signal_reg     - write to set signal of hardware threads
+ *   perf_reg            - performance counter of hardware threads
+ *                         (RECONOS_STATS_COUNT per thread, write to clear)
  */
 #define NUM_HWTS_REG           0x00
 #define PGD_ADDR_REG           0x04
@@ -60,6 +73,8 @@
 #define SYS_RESET_REG          0x14
 #define HWT_RESET_REG(hwt)     (0x18 + HWT_REG_OFFSET(hwt) * 4)
 #define HWT_SIGNAL_REG(hwt)    (HWT_RESET_REG(hwt) + DYNAMIC_REG_COUNT * 4)
+#define PERF_REG(hwt, cnt)     (0x18 + DYNAMIC_REG_COUNT * 8 + \
+                                ((hwt) * RECONOS_STATS_COUNT + (cnt)) * 4)
 
 /*
  * Struct representing the proc control device
@@ -75,6 +90,8 @@
  *   page_fault_addr - address which caused the page fault
  *   hwt_resets      - array representing the reset signals
  *   hwt_signals     - array representing the signals
+ *   stats           - accumulated 64 bit performance counters
+ *   stats_last      - last values read from the 32 bit hardware counters
  *
  *   mdev            - misc device data structure
  *
@@ -92,6 +109,8 @@ struct proc_control_dev {
 	uint32_t page_fault_addr;
 	uint32_t *hwt_resets;
 	uint32_t *hwt_signals;
+	uint64_t *stats;
+	uint32_t *stats_last;
 
 	struct miscdevice mdev;
 
@@ -100,6 +119,36 @@ struct proc_control_dev {
 
 static struct proc_control_dev proc_control;
 
+/*
+ * Struct representing a pinned range of user memory
+ *
+ *   addr     - user virtual start address
+ *   nr_pages - number of pinned pages
+ *   pages    - array of the pinned pages
+ *   list     - list of pinned ranges of the file
+ */
+struct proc_control_pin {
+	unsigned long addr;
+	int nr_pages;
+	struct page **pages;
+
+	struct list_head list;
+};
+
+/*
+ * Struct representing an opened file of the device
+ *
+ *   dev      - pointer to the proc control struct
+ *   pins     - list of the ranges pinned by this file
+ *   pin_lock - mutex protecting the list of pinned ranges
+ */
+struct proc_control_file {
+	struct proc_control_dev *dev;
+
+	struct list_head pins;
+	struct mutex pin_lock;
+};
+
 
 /* == Low level functions ============================================== */
 
@@ -151,6 +200,199 @@ static void flush_cache(void) {
 }
 #endif
 
+/*
+ * Cache maintenance on a range of the current process' address space.
+ * The pages are pinned during the operation, so the range must be
+ * mapped. The inner cache is always cleaned and invalidated by line,
+ * the outer cache is only cleaned or invalidated as requested. Cleaning
+ * proceeds from the inner to the outer cache, invalidating alone from
+ * the outer to the inner one, as the dma mapping of arm does.
+ *
+ *   addr - user virtual start address
+ *   len  - length of the range in bytes
+ *   op   - bitmask of RECONOS_CACHE_CLEAN and RECONOS_CACHE_INVALIDATE
+ */
+#if defined(RECONOS_ARCH_zynq)
+static int cache_range(unsigned long addr, unsigned long len, int op) {
+	struct page *page;
+	unsigned long end, off, size;
+	phys_addr_t phys;
+	void *kaddr;
+
+	end = addr + len;
+	while (addr < end) {
+		off = addr & ~PAGE_MASK;
+		size = min(end - addr, PAGE_SIZE - off);
+
+		if (get_user_pages_fast(addr & PAGE_MASK, 1, 0, &page) != 1) {
+			return -EFAULT;
+		}
+
+		kaddr = kmap(page) + off;
+		phys = page_to_phys(page) + off;
+
+		if (op == RECONOS_CACHE_INVALIDATE) {
+			// outer first, so that the inner cache cannot refill stale
+			// lines from the outer one in between
+			outer_inv_range(phys, phys + size);
+			__cpuc_flush_dcache_area(kaddr, size);
+		} else {
+			// inner first, so that its dirty lines reach the outer cache
+			__cpuc_flush_dcache_area(kaddr, size);
+			if ((op & RECONOS_CACHE_CLEAN) && (op & RECONOS_CACHE_INVALIDATE)) {
+				outer_flush_range(phys, phys + size);
+			} else if (op & RECONOS_CACHE_CLEAN) {
+				outer_clean_range(phys, phys + size);
+			}
+		}
+
+		kunmap(page);
+		put_page(page);
+
+		addr += size;
+	}
+
+	return 0;
+}
+#elif defined(RECONOS_ARCH_microblaze)
+static int cache_range(unsigned long addr, unsigned long len, int op) {
+	flush_cache();
+
+	return 0;
+}
+#endif
+
+
+/* == Performance counters ============================================= */
+
+/*
+ * Accumulates the hardware counters into the 64 bit counters. The
+ * hardware counters wrap around, so they must be read at least once
+ * per wrap (about 17 seconds at 250 MB/s) to not lose any bytes.
+ *
+ *   dev - pointer to the proc control struct
+ */
+static void update_stats(struct proc_control_dev *dev) {
+	uint32_t data;
+	int i, j;
+
+	spin_lock(&dev->lock);
+
+	for (i = 0; i < NUM_HWTS; i++) {
+		for (j = 0; j < RECONOS_STATS_COUNT; j++) {
+			data = read_reg(dev, PERF_REG(i, j));
+			dev->stats[i * RECONOS_STATS_COUNT + j] +=
+			      (uint32_t)(data - dev->stats_last[i * RECONOS_STATS_COUNT + j]);
+			dev->stats_last[i * RECONOS_STATS_COUNT + j] = data;
+		}
+	}
+
+	spin_unlock(&dev->lock);
+}
+
+/*
+ * Clears the counters of a single hardware thread
+ *
+ *   dev - pointer to the proc control struct
+ *   hwt - number of the hardware thread
+ */
+static void reset_stats(struct proc_control_dev *dev, int hwt) {
+	int j;
+
+	spin_lock(&dev->lock);
+
+	for (j = 0; j < RECONOS_STATS_COUNT; j++) {
+		write_reg(dev, PERF_REG(hwt, j), 0);
+		dev->stats[hwt * RECONOS_STATS_COUNT + j] = 0;
+		dev->stats_last[hwt * RECONOS_STATS_COUNT + j] = 0;
+	}
+
+	spin_unlock(&dev->lock);
+}
+
+/*
+ * Prints one counter of all hardware threads separated by spaces
+ *
+ *   buf - sysfs buffer to print to
+ *   cnt - index of the counter (refers to RECONOS_STATS_...)
+ *
+ *   @returns number of bytes printed
+ */
+static ssize_t show_stats(char *buf, int cnt) {
+	struct proc_control_dev *dev = &proc_control;
+	ssize_t len = 0;
+	int i;
+
+	update_stats(dev);
+
+	for (i = 0; i < NUM_HWTS; i++) {
+		len += scnprintf(buf + len, PAGE_SIZE - len, "%llu%c",
+		                 (unsigned long long)dev->stats[i * RECONOS_STATS_COUNT + cnt],
+		                 i == NUM_HWTS - 1 ? '\n' : ' ');
+	}
+
+	return len;
+}
+
+#define STATS_ATTR(_name, _cnt)                                        \
+static ssize_t _name##_show(struct device *d,                          \
+                            struct device_attribute *attr, char *buf) { \
+	return show_stats(buf, _cnt);                                      \
+}                                                                      \
+static DEVICE_ATTR_RO(_name)
+
+STATS_ATTR(bytes_read, RECONOS_STATS_BYTES_READ);
+STATS_ATTR(bytes_written, RECONOS_STATS_BYTES_WRITTEN);
+STATS_ATTR(stall_cycles, RECONOS_STATS_STALL_CYCLES);
+STATS_ATTR(tlb_hits, RECONOS_STATS_TLB_HITS);
+STATS_ATTR(tlb_misses, RECONOS_STATS_TLB_MISSES);
+STATS_ATTR(page_faults, RECONOS_STATS_PAGE_FAULTS);
+
+/*
+ * Clears the counters of the hardware thread written to the file or of
+ * all hardware threads if a negative number is written.
+ *
+ *   @see kernel documentation
+ */
+static ssize_t reset_store(struct device *d, struct device_attribute *attr,
+                           const char *buf, size_t count) {
+	int hwt, i;
+
+	if (kstrtoint(buf, 0, &hwt) || hwt >= NUM_HWTS) {
+		return -EINVAL;
+	}
+
+	for (i = 0; i < NUM_HWTS; i++) {
+		if (hwt < 0 || hwt == i) {
+			reset_stats(&proc_control, i);
+		}
+	}
+
+	return count;
+}
+static DEVICE_ATTR_WO(reset);
+
+static struct attribute *stats_attrs[] = {
+	&dev_attr_bytes_read.attr,
+	&dev_attr_bytes_written.attr,
+	&dev_attr_stall_cycles.attr,
+	&dev_attr_tlb_hits.attr,
+	&dev_attr_tlb_misses.attr,
+	&dev_attr_page_faults.attr,
+	&dev_attr_reset.attr,
+	NULL
+};
+
+static const struct attribute_group stats_group = {
+	.name  = "stats",
+	.attrs = stats_attrs,
+};
+
+static const struct attribute_group *proc_control_groups[] = {
+	&stats_group,
+	NULL
+};
+
 
 /* == File operations ================================================== */
 
@@ -160,11 +402,137 @@ static void flush_cache(void) {
  *    @see kernel documentation
  */
 static int proc_control_open(struct inode *inode, struct file *filp) {
-	filp->private_data = &proc_control;
+	struct proc_control_file *file;
+
+	file = kzalloc(sizeof(struct proc_control_file), GFP_KERNEL);
+	if (!file) {
+		return -ENOMEM;
+	}
+
+	file->dev = &proc_control;
+	INIT_LIST_HEAD(&file->pins);
+	mutex_init(&file->pin_lock);
+
+	filp->private_data = file;
+
+	return 0;
+}
+
+/*
+ * Releases the pages of a pinned range
+ *
+ *   pin - pointer to the pinned range
+ */
+static void unpin_pages(struct proc_control_pin *pin) {
+	int i;
+
+	for (i = 0; i < pin->nr_pages; i++) {
+		set_page_dirty_lock(pin->pages[i]);
+		put_page(pin->pages[i]);
+	}
+
+	list_del(&pin->list);
+	kfree(pin->pages);
+	kfree(pin);
+}
+
+/*
+ * Function called when closing the device
+ *
+ *    @see kernel documentation
+ */
+static int proc_control_release(struct inode *inode, struct file *filp) {
+	struct proc_control_file *file;
+	struct proc_control_pin *pin, *tmp;
+
+	file = (struct proc_control_file *)filp->private_data;
+
+	list_for_each_entry_safe(pin, tmp, &file->pins, list) {
+		unpin_pages(pin);
+	}
+
+	kfree(file);
 
 	return 0;
 }
 
+/*
+ * Faults in the pages of a user address range for writing and pins
+ * them, such that the hardware threads do not cause page faults when
+ * accessing the range.
+ *
+ *   file - pointer to the file struct
+ *   addr - user virtual start address
+ *   len  - length of the range in bytes
+ */
+static int pin_range(struct proc_control_file *file,
+                     unsigned long addr, unsigned long len) {
+	struct proc_control_pin *pin;
+	unsigned long start;
+	int nr_pages, res;
+
+	if (len == 0) {
+		return -EINVAL;
+	}
+
+	start = addr & PAGE_MASK;
+	nr_pages = (PAGE_ALIGN(addr + len) - start) >> PAGE_SHIFT;
+
+	pin = kzalloc(sizeof(struct proc_control_pin), GFP_KERNEL);
+	if (!pin) {
+		return -ENOMEM;
+	}
+
+	pin->pages = kcalloc(nr_pages, sizeof(struct page *), GFP_KERNEL);
+	if (!pin->pages) {
+		kfree(pin);
+		return -ENOMEM;
+	}
+
+	// 1 requests write access (write or FOLL_WRITE depending on kernel)
+	res = get_user_pages_fast(start, nr_pages, 1, pin->pages);
+	if (res < 0) {
+		res = 0;
+	}
+	pin->addr = addr;
+	pin->nr_pages = res;
+
+	mutex_lock(&file->pin_lock);
+	list_add(&pin->list, &file->pins);
+
+	if (res != nr_pages) {
+		unpin_pages(pin);
+		mutex_unlock(&file->pin_lock);
+		return -EFAULT;
+	}
+	mutex_unlock(&file->pin_lock);
+
+	return 0;
+}
+
+/*
+ * Unpins a range pinned before.
+ *
+ *   file - pointer to the file struct
+ *   addr - user virtual start address as passed to pin_range
+ */
+static int unpin_range(struct proc_control_file *file, unsigned long addr) {
+	struct proc_control_pin *pin;
+	int res = -EINVAL;
+
+	mutex_lock(&file->pin_lock);
+	list_for_each_entry(pin, &file->pins, list) {
+		if (pin->addr == addr) {
+			unpin_pages(pin);
+			res = 0;
+			break;
+		}
+	}
+	mutex_unlock(&file->pin_lock);
+
+	return res;
+}
+
 /*
  * Function called when issuing an ioctl
  *
@@ -172,12 +540,17 @@ static int proc_control_open(struct inode *inode, struct file *filp) {
  */
 static long proc_control_ioctl(struct file *filp, unsigned int cmd,
                                unsigned long arg) {
+	struct proc_control_file *file;
 	struct proc_control_dev *dev;
+	struct reconos_cache_range range;
+	struct reconos_mem_range mem;
+	struct reconos_hwt_stats stats;
 	uint32_t data;
 	int i, hwt;
 	unsigned long ret;
 
-	dev = (struct proc_control_dev *)filp->private_data;
+	file = (struct proc_control_file *)filp->private_data;
+	dev = file->dev;
 
 	switch (cmd) {
 		case RECONOS_PROC_CONTROL_GET_NUM_HWTS:
@@ -234,6 +607,12 @@ static long proc_control_ioctl(struct file *filp, unsigned int cmd,
 			}
 			write_reg(dev, SYS_RESET_REG, 0);
 
+			// the reset clears the hardware counters as well
+			for (i = 0; i < NUM_HWTS * RECONOS_STATS_COUNT; i++) {
+				dev->stats[i] = 0;
+				dev->stats_last[i] = 0;
+			}
+
 			spin_unlock(&dev->lock);
 			break;
 
@@ -301,6 +680,58 @@ static long proc_control_ioctl(struct file *filp, unsigned int cmd,
 			flush_cache();
 			break;
 
+		case RECONOS_PROC_CONTROL_CACHE_RANGE:
+			if (copy_from_user(&range, (struct reconos_cache_range *)arg, sizeof(range))) {
+				return -EFAULT;
+			}
+
+			return cache_range(range.addr, range.len, range.op);
+
+		case RECONOS_PROC_CONTROL_PIN_RANGE:
+			if (copy_from_user(&mem, (struct reconos_mem_range *)arg, sizeof(mem))) {
+				return -EFAULT;
+			}
+
+			return pin_range(file, mem.addr, mem.len);
+
+		case RECONOS_PROC_CONTROL_UNPIN_RANGE:
+			if (copy_from_user(&mem, (struct reconos_mem_range *)arg, sizeof(mem))) {
+				return -EFAULT;
+			}
+
+			return unpin_range(file, mem.addr);
+
+		case RECONOS_PROC_CONTROL_GET_STATS:
+			if (copy_from_user(&stats, (struct reconos_hwt_stats *)arg, sizeof(stats))) {
+				return -EFAULT;
+			}
+
+			if (stats.hwt < 0 || stats.hwt >= NUM_HWTS) {
+				return -EINVAL;
+			}
+
+			update_stats(dev);
+			for (i = 0; i < RECONOS_STATS_COUNT; i++) {
+				stats.count[i] = dev->stats[stats.hwt * RECONOS_STATS_COUNT + i];
+			}
+
+			if (copy_to_user((struct reconos_hwt_stats *)arg, &stats, sizeof(stats))) {
+				return -EFAULT;
+			}
+			break;
+
+		case RECONOS_PROC_CONTROL_RESET_STATS:
+			if (copy_from_user(&hwt, (int *)arg, sizeof(int))) {
+				return -EFAULT;
+			}
+
+			if (hwt < 0 || hwt >= NUM_HWTS) {
+				return -EINVAL;
+			}
+
+			reset_stats(dev, hwt);
+			break;
+
 		default:
 			return -EINVAL;
 	}
@@ -316,6 +747,7 @@ static long proc_control_ioctl(struct file *filp, unsigned int cmd,
 struct file_operations proc_control_fops = {
 	.owner          = THIS_MODULE,
 	.open           = proc_control_open,
+	.release        = proc_control_release,
 	.unlocked_ioctl = proc_control_ioctl,
 };
 
@@ -468,6 +900,15 @@ int proc_control_init(void) {
 		goto hwt_signals_failed;
 	}
 
+	// allocating performance counters
+	dev->stats = kcalloc(NUM_HWTS * RECONOS_STATS_COUNT, sizeof(uint64_t), GFP_KERNEL);
+	dev->stats_last = kcalloc(NUM_HWTS * RECONOS_STATS_COUNT, sizeof(uint32_t), GFP_KERNEL);
+	if (!dev->stats || !dev->stats_last) {
+		__printk(KERN_WARNING "[reconos-proc-control] "
+		                      "cannot allocate proc control memory\n");
+		goto stats_failed;
+	}
+
 	// getting address from device tree
 	if (of_address_to_resource(node, 0, &res))
 	{
@@ -525,6 +966,7 @@ int proc_control_init(void) {
 	dev->mdev.minor = MISC_DYNAMIC_MINOR;
 	dev->mdev.fops = &proc_control_fops;
 	dev->mdev.name = dev->name;
+	dev->mdev.groups = proc_control_groups;
 
 	if (misc_register(&dev->mdev) < 0) {
 		__printk(KERN_WARNING "[reconos-proc-control] "
@@ -552,6 +994,9 @@ map_failed:
 	release_mem_region(dev->base_addr, dev->mem_size);
 
 req_failed:
+stats_failed:
+	kfree(dev->stats);
+	kfree(dev->stats_last);
 	kfree(dev->hwt_signals);
 
 hwt_signals_failed:
@@ -576,6 +1021,9 @@ int proc_control_exit(void) {
 	misc_deregister(&dev->mdev);
 
 	kfree(dev->hwt_resets);
+	kfree(dev->hwt_signals);
+	kfree(dev->stats);
+	kfree(dev->stats_last);
 
 	free_irq(dev->irq, dev);
 
@@ -12,7 +12,7 @@
  *   project:      ReconOS
  *   author:       Christoph Rüthing, University of Paderborn
  *   description:  Driver for the entire ReconOS system including the
- *                 OSIFs and the proc control.
+ *                 OSIFs, the proc control and the timer.
  *
  * ======================================================================
  */
@@ -20,7 +20,10 @@
 #include "reconos.h"
 
 #include "osif_intc.h"
+#include "osif.h"
+#include "mbox.h"
 #include "proc_control.h"
+#include "timer.h"
 
 
 // extern variables available in the entire module
@@ -38,6 +41,11 @@ static __init int reconos_init(void) {
 	if (NUM_HWTS < 0) {
 		goto num_hwts_failed;
 	}
+	if (NUM_HWTS > RECONOS_MAX_HWTS) {
+		__printk(KERN_ERR "[reconos] more than %d HWTs not supported\n",
+		                  RECONOS_MAX_HWTS);
+		goto num_hwts_failed;
+	}
 
 	ret = proc_control_init();
 	if (ret < 0) {
@@ -49,8 +57,32 @@ static __init int reconos_init(void) {
 		goto osif_intc_failed;
 	}
 
+	ret = kmbox_init();
+	if (ret < 0) {
+		goto kmbox_failed;
+	}
+
+	ret = osif_init();
+	if (ret < 0) {
+		goto osif_failed;
+	}
+
+	ret = timer_init();
+	if (ret < 0) {
+		goto timer_failed;
+	}
+
 	return 0;
 
+timer_failed:
+	osif_exit();
+
+osif_failed:
+	kmbox_exit();
+
+kmbox_failed:
+	osif_intc_exit();
+
 osif_intc_failed:
 	proc_control_exit();
 
@@ -62,6 +94,9 @@ num_hwts_failed:
 static __exit void reconos_exit(void) {
 	__printk(KERN_INFO "[reconos] removing driver ...\n");
 
+	timer_exit();
+	osif_exit();
+	kmbox_exit();
 	osif_intc_exit();
 	proc_control_exit();
 
@@ -0,0 +1,159 @@
+/*
+ *                                                        ____  _____
+ *                            ________  _________  ____  / __ \/ ___/
+ *                           / ___/ _ \/ ___/ __ \/ __ \/ / / /\__ \
+ *                          / /  /  __/ /__/ /_/ / / / / /_/ /___/ /
+ *                         /_/   \___/\___/\____/_/ /_/\____//____/
+ *
+ * ======================================================================
+ *
+ *   title:        Linux Driver - Timer
+ *
+ *   project:      ReconOS
+ *   author:       Christoph Rüthing, University of Paderborn
+ *   description:  Maps the registers of the ReconOS timer into user
+ *                 space, so that reading the timer does not require
+ *                 access to /dev/mem. The device is only registered if
+ *                 the timer is present in the device tree.
+ *
+ * ======================================================================
+ */
+
+#include "timer.h"
+
+#include <linux/fs.h>
+#include <linux/mm.h>
+#include <linux/miscdevice.h>
+#include <linux/of_address.h>
+
+
+/* == General definitions ============================================== */
+
+/*
+ * Struct representing the timer device
+ *
+ *   name       - name to identify the device driver
+ *   base_addr  - base address of the registers
+ *   mem_size   - memory size of the registers
+ *   registered - indicates if the misc device is registered
+ *
+ *   mdev       - misc device data structure
+ */
+struct timer_dev {
+	char name[25];
+	uint32_t base_addr;
+	int mem_size;
+	int registered;
+
+	struct miscdevice mdev;
+};
+
+static struct timer_dev timer;
+
+
+/* == File operations ================================================== */
+
+/*
+ * Function called when mapping the device. Maps the registers of the
+ * timer uncached.
+ *
+ * @see kernel documentation
+ */
+static int timer_mmap(struct file *filp, struct vm_area_struct *vma) {
+	struct timer_dev *dev = &timer;
+
+	vma->vm_page_prot = pgprot_noncached(vma->vm_page_prot);
+
+	return vm_iomap_memory(vma, dev->base_addr, dev->mem_size);
+}
+
+/*
+ * Struct for file operations to register driver
+ *
+ *    @see kernel documentation
+ */
+static struct file_operations timer_fops = {
+	.owner          = THIS_MODULE,
+	.mmap           = timer_mmap,
+};
+
+
+/* == Init and exit functions ========================================== */
+
+/*
+ * Struct for device tree matching
+ */
+static struct of_device_id timer_of_match[] =
+{
+    { .compatible = "upb,reconos-timer-1.0"},
+    {}
+};
+
+/*
+ * @see header
+ */
+int timer_init() {
+	struct timer_dev *dev = &timer;
+	struct device_node *node = NULL;
+	struct resource res;
+
+	__printk(KERN_INFO "[reconos-timer] "
+	                   "initializing driver ...\n");
+
+	// the timer is optional
+	node = of_find_matching_node(NULL, timer_of_match);
+	if (!node)
+	{
+		__printk(KERN_INFO "[reconos-timer] "
+		                   "device tree node not found, skipping\n");
+		return 0;
+	}
+
+	strncpy(dev->name, "reconos-timer", 25);
+
+	// getting address from device tree
+	if (of_address_to_resource(node, 0, &res))
+	{
+		__printk(KERN_ERR "[reconos-timer] "
+	                      "address could not be determined\n");
+		return -1;
+	}
+	dev->base_addr = res.start;
+	dev->mem_size = res.end - res.start + 1;
+	__printk(KERN_INFO "[reconos-timer] "
+	                   "found memory at 0x%08x with size 0x%x\n",
+	                   dev->base_addr, dev->mem_size);
+
+	// registering misc device
+	dev->mdev.minor = MISC_DYNAMIC_MINOR;
+	dev->mdev.fops = &timer_fops;
+	dev->mdev.name = dev->name;
+	// the timer is used for measurements without root
+	dev->mdev.mode = 0666;
+
+	if (misc_register(&dev->mdev) < 0) {
+		__printk(KERN_WARNING "[reconos-timer] "
+		                      "error while registering misc-device\n");
+		return -1;
+	}
+	dev->registered = 1;
+
+	return 0;
+}
+
+/*
+ * @see header
+ */
+int timer_exit() {
+	struct timer_dev *dev = &timer;
+
+	__printk(KERN_INFO "[reconos-timer] "
+	                   "removing driver ...\n");
+
+	if (dev->registered) {
+		misc_deregister(&dev->mdev);
+		dev->registered = 0;
+	}
+
+	return 0;
+}
@@ -0,0 +1,43 @@
+/*
+ *                                                        ____  _____
+ *                            ________  _________  ____  / __ \/ ___/
+ *                           / ___/ _ \/ ___/ __ \/ __ \/ / / /\__ \
+ *                          / /  /  __/ /__/ /_/ / / / / /_/ /___/ /
+ *                         /_/   \___/\___/\____/_/ /_/\____//____/
+ *
+ * ======================================================================
+ *
+ *   title:        Linux Driver - Timer
+ *
+ *   project:      ReconOS
+ *   author:       Christoph Rüthing, University of Paderborn
+ *   description:  Maps the registers of the ReconOS timer into user
+ *                 space, if present in the device tree.
+ *
+ * ======================================================================
+ */
+
+#ifndef RECONOS_DRV_TIMER_H
+#define RECONOS_DRV_TIMER_H
+
+#include "reconos.h"
+
+/*
+ * Initialization function called by module loading
+ *
+ *   no parameters
+ *
+ *   @returns -1 on failure, otherwise 0
+ */
+extern int timer_init(void);
+
+/*
+ * Exit function called by module unloading
+ *
+ *   no parameters
+ *
+ *   @returns always 0
+ */
+extern int timer_exit(void);
+
+#endif /* RECONOS_DRV_TIMER_H */
@@ -0,0 +1,718 @@
+/*
+ *                                                        ____  _____
+ *                            ________  _________  ____  / __ \/ ___/
+ *                           / ___/ _ \/ ___/ __ \/ __ \/ / / /\__ \
+ *                          / /  /  __/ /__/ /_/ / / / / /_/ /___/ /
+ *                         /_/   \___/\___/\____/_/ /_/\____//____/
+ *
+ * ======================================================================
+ *
+ *   title:        Slot broker - Daemon
+ *
+ *   project:      ReconOS
+ *   author:       Christoph Rüthing, University of Paderborn
+ *   description:  Daemon owning the ReconOS hardware to share it between
+ *                 several applications. It resets the system once, sets
+ *                 its own address space for the memory management unit
+ *                 and claims the osifs of all slots. Applications lease
+ *                 slots and receive the claimed osif to access the fifos
+ *                 directly, which is revoked when the slot is released. Resets and reconfigurations of a slot are
+ *                 only executed for the application leasing it and all
+ *                 slots of an application are released if it exits.
+ *                 Leases give no memory isolation, since all hardware
+ *                 threads use the address space of the broker. A slot
+ *                 accessing memory outside of the arenas is held in
+ *                 reset until its application releases it.
+ *
+ * ======================================================================
+ */
+
+#include "broker.h"
+
+#include "../../driver/include/reconos.h"
+#include "../../../lib/runtime/arch/arch.h"
+#include "../../../lib/runtime/utils.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#define OSIF_DEV "/dev/reconos-osif"
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
+#define BROKER_MAX_CLIENTS 32
+
+
+/* == General definitions ============================================== */
+
+/*
+ * Struct representing a slot
+ *
+ *   osif    - file descriptor of the osif claimed by the broker
+ *   owner   - client leasing the slot or NULL
+ *   faulted - indicates whether the slot caused a page fault outside
+ *             of the arenas and is held in reset until released
+ *   faults  - last value of the page fault counter of the slot
+ */
+struct broker_slot {
+	int osif;
+	struct broker_client *owner;
+	int faulted;
+	uint64_t faults;
+};
+
+/*
+ * Struct representing a connected application
+ *
+ *   fd         - file descriptor of the connection
+ *   arena      - pointer to the arena (NULL if not created)
+ *   arena_size - size of the arena
+ */
+struct broker_client {
+	int fd;
+	char *arena;
+	size_t arena_size;
+};
+
+static int proc_control;
+static unsigned int num_slots;
+static struct broker_slot *slots;
+
+static struct broker_client clients[BROKER_MAX_CLIENTS];
+static pthread_mutex_t clients_lock = PTHREAD_MUTEX_INITIALIZER;
+
+
+/* == Slot functions =================================================== */
+
+/*
+ * Claims the osif of a slot with a new file, which is passed to the
+ * next client leasing the slot
+ *
+ *   num - index of the slot
+ */
+static void slot_claim(int num) {
+	slots[num].osif = open(OSIF_DEV, O_RDWR);
+	if (slots[num].osif < 0 || ioctl(slots[num].osif, RECONOS_OSIF_CLAIM, &num) < 0) {
+		panic("[reconos-broker] unable to claim osif %d\n", num);
+	}
+}
+
+/*
+ * Holds a slot in reset and disables the kernel path of its osif
+ *
+ *   num - index of the slot
+ */
+static void slot_idle(int num) {
+	reconos_proc_control_hwt_reset(proc_control, num, 1);
+	reconos_proc_control_hwt_signal(proc_control, num, 0);
+	ioctl(slots[num].osif, RECONOS_OSIF_UNBIND);
+}
+
+/*
+ * Takes a slot back from its client. Revoking the claim of the leased
+ * osif invalidates the copy of the client including its mapping of the
+ * fifos, before the osif is claimed again for the next lease.
+ *
+ *   num - index of the slot
+ */
+static void slot_revoke(int num) {
+	slot_idle(num);
+
+	ioctl(slots[num].osif, RECONOS_OSIF_REVOKE);
+	close(slots[num].osif);
+	slot_claim(num);
+
+	pthread_mutex_lock(&clients_lock);
+	slots[num].owner = NULL;
+	slots[num].faulted = 0;
+	pthread_mutex_unlock(&clients_lock);
+}
+
+/*
+ * Reconfigures a slot with a partial bitstream
+ *
+ *   num  - index of the slot
+ *   path - path of the bitstream
+ *
+ *   @returns 0 on success, otherwise -1
+ */
+static int slot_reconfigure(int num, const char *path) {
+	struct stat st;
+	char *data;
+	int fd, res;
+
+	slot_idle(num);
+
+	if (reconos_devcfg_firmware()) {
+		return reconos_devcfg_program(path, NULL, 0, 1);
+	}
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0 || fstat(fd, &st) < 0) {
+		whine("[reconos-broker] failed to open bitstream %s\n", path);
+		if (fd >= 0) {
+			close(fd);
+		}
+		return -1;
+	}
+
+	data = (char *)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		whine("[reconos-broker] failed to map bitstream %s\n", path);
+		return -1;
+	}
+
+	res = reconos_devcfg_program(path, data, st.st_size, 1);
+	munmap(data, st.st_size);
+
+	return res;
+}
+
+
+/* == Arena functions ================================================== */
+
+/*
+ * Finds a free range of addresses for an arena, must be called while
+ * holding the lock of the clients
+ *
+ *   size - size of the arena
+ *
+ *   @returns the address or 0 if the window is exhausted
+ */
+static uintptr_t arena_find(size_t size) {
+	uintptr_t addr = RECONOS_BROKER_ARENA_BASE;
+	uintptr_t start, end;
+	int i, moved;
+
+	do {
+		moved = 0;
+		for (i = 0; i < BROKER_MAX_CLIENTS; i++) {
+			if (clients[i].fd < 0 || !clients[i].arena) {
+				continue;
+			}
+
+			start = (uintptr_t)clients[i].arena;
+			end = start + clients[i].arena_size;
+			if (addr < end && addr + size > start) {
+				addr = end;
+				moved = 1;
+			}
+		}
+	} while (moved);
+
+	if (addr + size > RECONOS_BROKER_ARENA_LIMIT || addr + size < addr) {
+		return 0;
+	}
+
+	return addr;
+}
+
+/*
+ * Creates the arena of a client, which is mapped, faulted in and pinned
+ * in the broker
+ *
+ *   client - pointer to the client
+ *   size   - requested size of the arena
+ *   fd     - pointer to store the file descriptor of the arena in
+ *
+ *   @returns 0 on success, otherwise the negative error number
+ */
+static int arena_create(struct broker_client *client, size_t size, int *fd) {
+	char name[64];
+	uintptr_t addr;
+	void *ptr;
+	long page_size;
+
+	if (client->arena) {
+		return -EBUSY;
+	}
+
+	page_size = sysconf(_SC_PAGESIZE);
+	size = (size + page_size - 1) & ~(page_size - 1);
+	if (size == 0) {
+		return -EINVAL;
+	}
+
+	snprintf(name, sizeof(name), "/reconos-broker-%d-%d", getpid(), client->fd);
+	*fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (*fd < 0) {
+		return -errno;
+	}
+	shm_unlink(name);
+
+	if (ftruncate(*fd, size) < 0) {
+		close(*fd);
+		return -ENOMEM;
+	}
+
+	pthread_mutex_lock(&clients_lock);
+	addr = arena_find(size);
+	ptr = addr ? mmap((void *)addr, size, PROT_READ | PROT_WRITE, MAP_SHARED, *fd, 0) : MAP_FAILED;
+	if (ptr != MAP_FAILED && ptr != (void *)addr) {
+		munmap(ptr, size);
+		ptr = MAP_FAILED;
+	}
+	if (ptr == MAP_FAILED) {
+		pthread_mutex_unlock(&clients_lock);
+		close(*fd);
+		return -ENOMEM;
+	}
+	client->arena = (char *)ptr;
+	client->arena_size = size;
+	pthread_mutex_unlock(&clients_lock);
+
+	// writing faults in the shared pages for reading and writing
+	memset(ptr, 0, size);
+
+	if (reconos_proc_control_pin(proc_control, ptr, size) < 0) {
+		whine("[reconos-broker] unable to pin arena at 0x%08lx\n", (unsigned long)addr);
+	}
+
+	return 0;
+}
+
+/*
+ * Destroys the arena of a client
+ *
+ *   client - pointer to the client
+ */
+static void arena_destroy(struct broker_client *client) {
+	char *arena;
+
+	if (!client->arena) {
+		return;
+	}
+
+	reconos_proc_control_unpin(proc_control, client->arena);
+
+	pthread_mutex_lock(&clients_lock);
+	arena = client->arena;
+	client->arena = NULL;
+	munmap(arena, client->arena_size);
+	pthread_mutex_unlock(&clients_lock);
+}
+
+
+/* == Client functions ================================================= */
+
+/*
+ * Sends a response to the client
+ *
+ *   client - pointer to the client
+ *   resp   - pointer to the response
+ *   fd     - file descriptor to pass or -1
+ */
+static void client_respond(struct broker_client *client,
+                           struct reconos_broker_resp *resp, int fd) {
+	struct msghdr msg;
+	struct iovec iov;
+	struct cmsghdr *cmsg;
+	char buf[CMSG_SPACE(sizeof(int))];
+
+	memset(&msg, 0, sizeof(msg));
+	iov.iov_base = resp;
+	iov.iov_len = sizeof(struct reconos_broker_resp);
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+
+	if (fd >= 0) {
+		msg.msg_control = buf;
+		msg.msg_controllen = sizeof(buf);
+		cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_RIGHTS;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+		memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+	}
+
+	if (sendmsg(client->fd, &msg, MSG_NOSIGNAL) < 0) {
+		whine("[reconos-broker] failed to respond to client %d\n", client->fd);
+	}
+}
+
+/*
+ * Releases all slots and the arena of a client and closes the
+ * connection
+ *
+ *   client - pointer to the client
+ */
+static void client_close(struct broker_client *client) {
+	int i;
+
+	debug("[reconos-broker] closing client %d\n", client->fd);
+
+	for (i = 0; i < num_slots; i++) {
+		if (slots[i].owner == client) {
+			slot_revoke(i);
+		}
+	}
+
+	arena_destroy(client);
+
+	pthread_mutex_lock(&clients_lock);
+	close(client->fd);
+	client->fd = -1;
+	pthread_mutex_unlock(&clients_lock);
+}
+
+/*
+ * Handles a single request of a client
+ *
+ *   client - pointer to the client
+ *   req    - pointer to the request
+ */
+static void client_handle(struct broker_client *client,
+                          struct reconos_broker_req *req) {
+	struct reconos_broker_resp resp;
+	int fd = -1, close_fd = 0;
+	uintptr_t addr;
+
+	resp.result = 0;
+	resp.arg = 0;
+
+	if (req->cmd != RECONOS_BROKER_ARENA) {
+		if (req->slot < 0 || req->slot >= num_slots) {
+			resp.result = -EINVAL;
+			client_respond(client, &resp, -1);
+			return;
+		}
+
+		if (req->cmd != RECONOS_BROKER_LEASE && slots[req->slot].owner != client) {
+			resp.result = -EPERM;
+			client_respond(client, &resp, -1);
+			return;
+		}
+	}
+
+	switch (req->cmd) {
+		case RECONOS_BROKER_ARENA:
+			resp.result = arena_create(client, req->arg, &fd);
+			if (resp.result == 0) {
+				addr = (uintptr_t)client->arena;
+				resp.arg = addr;
+				close_fd = 1;
+			}
+			break;
+
+		case RECONOS_BROKER_LEASE:
+			if (slots[req->slot].owner && slots[req->slot].owner != client) {
+				resp.result = -EBUSY;
+				break;
+			}
+
+			slots[req->slot].owner = client;
+			fd = slots[req->slot].osif;
+			debug("[reconos-broker] leased slot %d to client %d\n", req->slot, client->fd);
+			break;
+
+		case RECONOS_BROKER_RELEASE:
+			slot_revoke(req->slot);
+			debug("[reconos-broker] released slot %d\n", req->slot);
+			break;
+
+		case RECONOS_BROKER_RESET:
+			// a faulted slot stays in reset until it is released
+			pthread_mutex_lock(&clients_lock);
+			if (slots[req->slot].faulted && req->arg == 0) {
+				resp.result = -EFAULT;
+			} else {
+				reconos_proc_control_hwt_reset(proc_control, req->slot, req->arg != 0);
+			}
+			pthread_mutex_unlock(&clients_lock);
+			break;
+
+		case RECONOS_BROKER_SIGNAL:
+			reconos_proc_control_hwt_signal(proc_control, req->slot, req->arg != 0);
+			break;
+
+		case RECONOS_BROKER_RECONF:
+			req->path[RECONOS_BROKER_PATH_LEN - 1] = '\0';
+			if (slot_reconfigure(req->slot, req->path) < 0) {
+				whine("[reconos-broker] failed to reconfigure slot %d with %s\n", req->slot, req->path);
+				resp.result = -EIO;
+			}
+			break;
+
+		default:
+			resp.result = -EINVAL;
+	}
+
+	client_respond(client, &resp, resp.result == 0 ? fd : -1);
+
+	if (close_fd && fd >= 0) {
+		close(fd);
+	}
+}
+
+
+/* == Page fault handling ============================================== */
+
+/*
+ * Finds the slot which caused the current page fault by comparing the
+ * page fault counters of all slots with their last values
+ *
+ *   @returns the index of the slot or -1 if unknown
+ */
+static int pgf_slot() {
+	uint64_t count[RECONOS_STATS_COUNT];
+	int i, num = -1;
+
+	for (i = 0; i < num_slots; i++) {
+		if (reconos_proc_control_get_stats(proc_control, i, count) < 0) {
+			continue;
+		}
+
+		if (count[RECONOS_STATS_PAGE_FAULTS] != slots[i].faults) {
+			slots[i].faults = count[RECONOS_STATS_PAGE_FAULTS];
+			num = i;
+		}
+	}
+
+	return num;
+}
+
+/*
+ * Backs a faulting address outside of the arenas with a zeroed scratch
+ * page, such that the memory management unit can complete the request
+ * without accessing memory of the broker or of any client. The page is
+ * never unmapped, since its translation may remain in the tlb.
+ *
+ *   addr - address which caused the page fault
+ */
+static void pgf_scratch(uint32_t addr) {
+	long page_size;
+	void *page, *ptr;
+
+	page_size = sysconf(_SC_PAGESIZE);
+	page = (void *)(uintptr_t)(addr & ~(page_size - 1));
+
+	ptr = mmap(page, page_size, PROT_READ | PROT_WRITE,
+	           MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+	if (ptr != MAP_FAILED && ptr != page) {
+		munmap(ptr, page_size);
+		ptr = MAP_FAILED;
+	}
+
+	if (ptr == MAP_FAILED) {
+		// the address belongs to the broker, which the hardware threads
+		// can access anyway, since they share its address space
+		__sync_fetch_and_add((uint32_t *)(uintptr_t)addr, 0);
+		return;
+	}
+
+	memset(ptr, 0, page_size);
+	reconos_proc_control_pin(proc_control, ptr, page_size);
+}
+
+/*
+ * Handles page faults of the memory management unit. Arenas are
+ * pinned, so faults only occur for memory not allocated from an arena.
+ * For these, the slot causing the fault is held in reset and marked as
+ * faulted, so that its owner fails to release the reset again, while
+ * the fault is cleared to keep serving the slots of other clients.
+ *
+ *   arg - ignored
+ */
+static void *broker_pgfhandler(void *arg) {
+	uint32_t addr;
+	uintptr_t start;
+	int i, num, found;
+
+	while (1) {
+		addr = reconos_proc_control_get_fault_addr(proc_control);
+		num = pgf_slot();
+
+		found = 0;
+		pthread_mutex_lock(&clients_lock);
+		for (i = 0; i < BROKER_MAX_CLIENTS; i++) {
+			start = (uintptr_t)clients[i].arena;
+			if (clients[i].fd >= 0 && clients[i].arena &&
+			    addr >= start && addr < start + clients[i].arena_size) {
+				// faults in the page without changing it
+				__sync_fetch_and_add((uint32_t *)(uintptr_t)addr, 0);
+				found = 1;
+				break;
+			}
+		}
+		pthread_mutex_unlock(&clients_lock);
+
+		if (found) {
+			reconos_proc_control_clear_page_fault(proc_control);
+			continue;
+		}
+
+		whine("[reconos-broker] page fault of slot %d outside of arenas at 0x%08x\n", num, addr);
+
+		pgf_scratch(addr);
+		reconos_proc_control_clear_page_fault(proc_control);
+
+		if (num < 0) {
+			continue;
+		}
+
+		// resetting after the retry lets the memory controller take the
+		// data of a faulting write from the fifo before it is cleared
+		pthread_mutex_lock(&clients_lock);
+		reconos_proc_control_hwt_reset(proc_control, num, 1);
+		slots[num].faulted = 1;
+		if (slots[num].owner) {
+			whine("[reconos-broker] holding slot %d of client %d in reset\n",
+			      num, slots[num].owner->fd);
+		}
+		pthread_mutex_unlock(&clients_lock);
+	}
+
+	return NULL;
+}
+
+
+/* == Main function ==================================================== */
+
+/*
+ * Accepts a new client
+ *
+ *   lfd - file descriptor of the listening socket
+ */
+static void broker_accept(int lfd) {
+	int fd, i;
+
+	fd = accept(lfd, NULL, NULL);
+	if (fd < 0) {
+		return;
+	}
+
+	for (i = 0; i < BROKER_MAX_CLIENTS; i++) {
+		if (clients[i].fd < 0) {
+			break;
+		}
+	}
+	if (i == BROKER_MAX_CLIENTS) {
+		whine("[reconos-broker] too many clients\n");
+		close(fd);
+		return;
+	}
+
+	debug("[reconos-broker] accepted client %d\n", fd);
+
+	pthread_mutex_lock(&clients_lock);
+	clients[i].fd = fd;
+	clients[i].arena = NULL;
+	clients[i].arena_size = 0;
+	pthread_mutex_unlock(&clients_lock);
+}
+
+int main(int argc, char **argv) {
+	struct sockaddr_un addr;
+	struct pollfd pfds[BROKER_MAX_CLIENTS + 1];
+	struct broker_client *pclients[BROKER_MAX_CLIENTS + 1];
+	struct reconos_broker_req req;
+	const char *path;
+	pthread_t pgf_handler;
+	ssize_t len;
+	int lfd, i, n;
+
+	path = argc > 1 ? argv[1] : RECONOS_BROKER_SOCKET;
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		panic("[reconos-broker] socket path too long\n");
+	}
+
+	// the broker itself must access the hardware directly
+	unsetenv(RECONOS_BROKER_ENV);
+
+	signal(SIGPIPE, SIG_IGN);
+
+	for (i = 0; i < BROKER_MAX_CLIENTS; i++) {
+		clients[i].fd = -1;
+	}
+
+	reconos_drv_init();
+
+	proc_control = reconos_proc_control_open();
+	num_slots = reconos_proc_control_get_num_hwts(proc_control);
+	reconos_proc_control_sys_reset(proc_control);
+	reconos_proc_control_set_pgd(proc_control);
+
+	slots = (struct broker_slot *)calloc(num_slots, sizeof(struct broker_slot));
+	if (!slots) {
+		panic("[reconos-broker] failed to allocate memory\n");
+	}
+
+	for (i = 0; i < num_slots; i++) {
+		slot_claim(i);
+		slot_idle(i);
+	}
+
+	if (pthread_create(&pgf_handler, NULL, broker_pgfhandler, NULL)) {
+		panic("[reconos-broker] unable to start page fault handler\n");
+	}
+
+	lfd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+	if (lfd < 0) {
+		panic("[reconos-broker] unable to create socket\n");
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+	unlink(path);
+
+	if (bind(lfd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(lfd, 8) < 0) {
+		panic("[reconos-broker] unable to listen on %s\n", path);
+	}
+
+	printf("[reconos-broker] managing %d slots on %s\n", num_slots, path);
+
+	while (1) {
+		pfds[0].fd = lfd;
+		pfds[0].events = POLLIN;
+		for (i = 0, n = 1; i < BROKER_MAX_CLIENTS; i++) {
+			if (clients[i].fd >= 0) {
+				pfds[n].fd = clients[i].fd;
+				pfds[n].events = POLLIN;
+				pclients[n] = &clients[i];
+				n++;
+			}
+		}
+
+		if (poll(pfds, n, -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			panic("[reconos-broker] poll failed\n");
+		}
+
+		for (i = 1; i < n; i++) {
+			if (!(pfds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+				continue;
+			}
+
+			len = recv(pfds[i].fd, &req, sizeof(req), 0);
+			if (len == sizeof(req)) {
+				client_handle(pclients[i], &req);
+			} else {
+				client_close(pclients[i]);
+			}
+		}
+
+		if (pfds[0].revents & POLLIN) {
+			broker_accept(lfd);
+		}
+	}
+
+	return 0;
+}
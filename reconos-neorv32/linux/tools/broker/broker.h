@@ -0,0 +1,106 @@
+/*
+ *                                                        ____  _____
+ *                            ________  _________  ____  / __ \/ ___/
+ *                           / ___/ _ \/ ___/ __ \/ __ \/ / / /\__ \
+ *                          / /  /  __/ /__/ /_/ / / / / /_/ /___/ /
+ *                         /_/   \___/\___/\____/_/ /_/\____//____/
+ *
+ * ======================================================================
+ *
+ *   title:        Slot broker - Protocol
+ *
+ *   project:      ReconOS
+ *   author:       Christoph Rüthing, University of Paderborn
+ *   description:  Protocol between the slot broker daemon and the
+ *                 runtime of the applications sharing the hardware.
+ *                 Applications connect to the unix socket of the broker,
+ *                 lease slots and receive the claimed osif of a slot as
+ *                 file descriptor. Memory accessed by the hardware
+ *                 threads is allocated from an arena shared with the
+ *                 broker, whose address space the memory management
+ *                 unit translates. Leases do not isolate the memory of
+ *                 the applications: all hardware threads share this
+ *                 address space and can access the arenas of other
+ *                 applications as well as the memory of the broker.
+ *
+ * ======================================================================
+ */
+
+#ifndef RECONOS_BROKER_H
+#define RECONOS_BROKER_H
+
+#include <stdint.h>
+
+/*
+ * Environment variable enabling the broker in the runtime. It holds the
+ * path of the socket or is empty to use the default path.
+ */
+#define RECONOS_BROKER_ENV    "RECONOS_BROKER"
+#define RECONOS_BROKER_SOCKET "/var/run/reconos-broker.sock"
+
+/*
+ * Environment variable setting the size of the arena in MiB
+ */
+#define RECONOS_BROKER_ARENA_ENV  "RECONOS_BROKER_ARENA"
+#define RECONOS_BROKER_ARENA_SIZE 16
+
+/*
+ * Window of virtual addresses the arenas are placed in. An arena is
+ * mapped at the same address in the broker and the application, which
+ * fails if the application uses the address already.
+ */
+#define RECONOS_BROKER_ARENA_BASE  0x70000000
+#define RECONOS_BROKER_ARENA_LIMIT 0x90000000
+
+#define RECONOS_BROKER_PATH_LEN 256
+
+/*
+ * Definition of the requests
+ *
+ *   arena   - creates the arena of the application with the size in
+ *             arg and returns its address in arg and a file descriptor
+ *   lease   - leases the slot and returns the osif claimed by the
+ *             broker as file descriptor, the slot is held in reset
+ *   release - releases the slot, which is held in reset again, and
+ *             revokes the file descriptor of the osif, so that its
+ *             copy and mapping in the application become invalid
+ *   reset   - sets (arg = 1) or clears (arg = 0) the reset of the slot,
+ *             clearing fails with -EFAULT after the slot accessed
+ *             memory outside of the arenas, until it is released
+ *   signal  - sets (arg = 1) or clears (arg = 0) the signal of the slot
+ *   reconf  - reconfigures the slot with the partial bitstream in path
+ */
+#define RECONOS_BROKER_ARENA   0x01
+#define RECONOS_BROKER_LEASE   0x02
+#define RECONOS_BROKER_RELEASE 0x03
+#define RECONOS_BROKER_RESET   0x04
+#define RECONOS_BROKER_SIGNAL  0x05
+#define RECONOS_BROKER_RECONF  0x06
+
+/*
+ * Request sent by the application
+ *
+ *   cmd  - request as defined above
+ *   slot - slot the request refers to
+ *   arg  - argument of the request
+ *   path - path of the bitstream
+ */
+struct reconos_broker_req {
+	uint32_t cmd;
+	int32_t slot;
+	uint32_t arg;
+	char path[RECONOS_BROKER_PATH_LEN];
+};
+
+/*
+ * Response sent by the broker, optionally along with a file descriptor
+ *
+ *   result - 0 on success, otherwise the negative error number
+ *   arg    - result value of the request
+ */
+struct reconos_broker_resp {
+	int32_t result;
+	uint32_t arg;
+};
+
+#endif /* RECONOS_BROKER_H */
@@ -25,7 +25,9 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#define TIMER_DEV "/dev/reconos-timer"
 #define TIMER_BASE_ADDR 0x64a00000
+#define TIMER_BASE_SIZE 0x10000
 #define CLK_FREQ 100000000
 
 volatile uint32_t *ptr = 0;
@@ -34,26 +36,42 @@ volatile uint32_t *ptr = 0;
 /* == Timer functions ================================================== */
 
 /*
- * @see header
+ * Maps the timer registers from the given file
+ *
+ *   dev    - path of the device to map from
+ *   offset - offset of the registers in the device
+ *
+ *   @returns 0 on success, otherwise -1
  */
-void timer_init() {
+static int timer_map(const char *dev, off_t offset) {
 	int fd;
+	void *mem;
 
-	fd = open("/dev/mem", O_RDWR | O_SYNC);
+	fd = open(dev, O_RDWR | O_SYNC);
 	if (fd < 0) {
-		printf("ERROR: Could not open /dev/mem\n");
-		close(fd);
-		return;
+		return -1;
 	}
 
-	ptr = (uint32_t *)mmap(0, 0x10000, PROT_READ | PROT_WRITE, MAP_SHARED, fd, TIMER_BASE_ADDR);
-	if (ptr == MAP_FAILED) {
-		printf("ERROR: Could not map memory\n");
-		close(fd);
-		return;
+	mem = mmap(0, TIMER_BASE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, offset);
+	close(fd);
+	if (mem == MAP_FAILED) {
+		return -1;
 	}
 
-	close(fd);
+	ptr = (uint32_t *)mem;
+
+	return 0;
+}
+
+/*
+ * @see header
+ */
+void timer_init() {
+	if (timer_map(TIMER_DEV, 0) < 0 &&
+	    timer_map("/dev/mem", TIMER_BASE_ADDR) < 0) {
+		printf("ERROR: Could not map timer\n");
+		return;
+	}
 
 	timer_reset();
 	timer_setstep(0);
@@ -92,7 +110,9 @@ unsigned int timer_get() {
  * @see header
  */
 void timer_cleanup() {
-	munmap((void *)ptr, 0x10000);
+	if (ptr) {
+		munmap((void *)ptr, TIMER_BASE_SIZE);
+	}
 	ptr = 0;
 }
 
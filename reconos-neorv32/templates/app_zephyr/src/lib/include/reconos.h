@@ -23,6 +23,7 @@
 #define RECONOS_H
 
 #include <pthread.h>
+#include <stdint.h>
 
 #define RECONOS_VERSION_STRING "v3.1"
 
@@ -105,6 +106,15 @@ int reconos_clock_set(int clk, int m, int f);
 #define RECONOS_THREAD_STATE_SUSPENDED    0x10
 #define RECONOS_THREAD_STATE_SUSPENDING   0x20
 
+/*
+ * Definition of the default scheduling attributes
+ *
+ *   priority_default - delegate keeps the priority it was created with
+ *   deadline_none    - no deadline is assigned to system calls
+ */
+#define RECONOS_THREAD_PRIORITY_DEFAULT   0x7FFFFFFF
+#define RECONOS_THREAD_DEADLINE_NONE      0
+
 
 /*
  * Object representing a hardware thread
@@ -121,6 +131,9 @@ int reconos_clock_set(int clk, int m, int f);
  *
  *   bitstreams        - array of bitstreams for the different slots
  *   bitstream_lengths - length of the bitstreams
+ *
+ *   priority          - scheduling priority of the delegate thread
+ *   deadline          - relative deadline of system calls in us
  */
 struct reconos_thread {
 	char *name;
@@ -141,6 +154,9 @@ struct reconos_thread {
 	char **bitstreams;
 	int *bitstream_lengths;
 	void *(*swentry)(void *data);
+
+	int priority;
+	int deadline;
 };
 
 /*
@@ -215,7 +231,9 @@ void reconos_thread_setbitstream(struct reconos_thread *rt,
 
 /*
  * Loads bitstreams from the filesystem and assigns them to the
- * thread. A bitstream for each slot must be provided.
+ * thread. A bitstream for each slot the thread is allowed to run in
+ * must be provided. Bitstreams are cached by their path, so that each
+ * file is only loaded once and shared between all threads.
  *
  *   rt   - pointer to the ReconOS thread
  *   path - path of the bitstreams, %d replaced by slot number
@@ -233,6 +251,29 @@ void reconos_thread_loadbitstream(struct reconos_thread *rt,
 void reconos_thread_setswentry(struct reconos_thread *rt,
                                void *(*swentry)(void *data));
 
+/*
+ * Sets the scheduling priority of the thread. The priority is applied
+ * to the delegate thread serving the system calls of the hardware
+ * thread and thereby also orders the wake-up of delegates blocked on
+ * the same resource (e.g. a mbox). As in Zephyr, lower values mean
+ * higher priority. May be called while the thread is running.
+ *
+ *   rt       - pointer to the ReconOS thread
+ *   priority - Zephyr priority of the delegate thread
+ */
+void reconos_thread_setpriority(struct reconos_thread *rt, int priority);
+
+/*
+ * Sets a relative deadline for the system calls of the thread. Each
+ * command received by the delegate thread is scheduled earliest
+ * deadline first among delegates of equal priority. Only effective
+ * if CONFIG_SCHED_DEADLINE is enabled.
+ *
+ *   rt       - pointer to the ReconOS thread
+ *   deadline - deadline in microseconds or RECONOS_THREAD_DEADLINE_NONE
+ */
+void reconos_thread_setdeadline(struct reconos_thread *rt, int deadline);
+
 /*
  * Creates the ReconOS thread and executes it in the given slot number.
  *
@@ -312,4 +353,44 @@ void reconos_cleanup();
  */
 void reconos_cache_flush();
 
+/*
+ * Memory statistics of a hardware thread counted by the proc control
+ *
+ *   bytes_read    - bytes read from main memory
+ *   bytes_written - bytes written to main memory
+ *   stall_cycles  - cycles with a pending memory request but no data
+ *                   transfer (waiting for arbitration, translation or
+ *                   the memory)
+ *   tlb_hits      - address translations served by the tlb
+ *   tlb_misses    - address translations requiring a page table walk
+ *   page_faults   - page faults raised by requests of the thread
+ */
+struct reconos_stats {
+	uint64_t bytes_read;
+	uint64_t bytes_written;
+	uint64_t stall_cycles;
+	uint64_t tlb_hits;
+	uint64_t tlb_misses;
+	uint64_t page_faults;
+};
+
+/*
+ * Reads the memory statistics of the hardware thread in the given slot
+ * since the last reset. Many stall cycles compared to the transferred
+ * bytes indicate a memory bound thread.
+ *
+ *   slot  - number of the slot
+ *   stats - pointer to the statistics to fill
+ *
+ *   @returns 0 on success or -1 on error
+ */
+int reconos_stats_get(int slot, struct reconos_stats *stats);
+
+/*
+ * Clears the memory statistics of the hardware thread in the given slot.
+ *
+ *   slot - number of the slot
+ */
+void reconos_stats_reset(int slot);
+
 #endif /* RECONOS_H */
\ No newline at end of file
@@ -47,6 +47,8 @@ extern void reconos_proc_control_sys_reset(int fd);
 extern void reconos_proc_control_hwt_reset(int fd, int num, int reset);
 extern void reconos_proc_control_hwt_signal(int fd, int num, int signal);
 extern void reconos_proc_control_cache_flush(int fd);
+extern int reconos_proc_control_get_stats(int fd, int num, uint64_t *count);
+extern void reconos_proc_control_reset_stats(int fd, int num);
 extern void reconos_proc_control_close(int fd);
 
 
@@ -172,11 +172,17 @@ void reconos_osif_close(int fd) {
 #define PROC_CONTROL_TLB_MISSES_REG      4
 #define PROC_CONTROL_SYS_RESET_REG       5
 #define PROC_CONTROL_HWT_RESET_REG       6
+#define PROC_CONTROL_PERF_REG(hwt, cnt)  (PROC_CONTROL_HWT_RESET_REG + \
+                                          2 * ((NUM_HWTS - 1) / 32 + 1) + \
+                                          (hwt) * PROC_CONTROL_PERF_COUNT + (cnt))
+#define PROC_CONTROL_PERF_COUNT          6
 
 struct proc_control_dev {
 	volatile uint32_t *ptr;
 	uint32_t *hwt_reset;
 	size_t hwt_reset_count;
+	uint64_t *stats;
+	uint32_t *stats_last;
 };
 
 struct proc_control_dev proc_control_dev;
@@ -217,6 +223,12 @@ void reconos_proc_control_sys_reset(int fd) {
 	for (i = 0; i < NUM_HWTS; i++)
 		proc_control_dev.hwt_reset[i] = 0xFFFFFFFF;
 	proc_control_dev.ptr[PROC_CONTROL_SYS_RESET_REG] = 0;
+
+	// the reset clears the hardware counters as well
+	for (i = 0; i < NUM_HWTS * PROC_CONTROL_PERF_COUNT; i++) {
+		proc_control_dev.stats[i] = 0;
+		proc_control_dev.stats_last[i] = 0;
+	}
 }
 
 void reconos_proc_control_hwt_reset(int fd, int num, int reset) {
@@ -230,6 +242,38 @@ void reconos_proc_control_hwt_reset(int fd, int num, int reset) {
 	}
 }
 
+int reconos_proc_control_get_stats(int fd, int num, uint64_t *count) {
+	uint32_t data;
+	int i;
+
+	if (num < 0 || num >= NUM_HWTS)
+		return -1;
+
+	// accumulate the wrapping 32 bit hardware counters
+	for (i = 0; i < PROC_CONTROL_PERF_COUNT; i++) {
+		data = proc_control_dev.ptr[PROC_CONTROL_PERF_REG(num, i)];
+		proc_control_dev.stats[num * PROC_CONTROL_PERF_COUNT + i] +=
+		      (uint32_t)(data - proc_control_dev.stats_last[num * PROC_CONTROL_PERF_COUNT + i]);
+		proc_control_dev.stats_last[num * PROC_CONTROL_PERF_COUNT + i] = data;
+
+		count[i] = proc_control_dev.stats[num * PROC_CONTROL_PERF_COUNT + i];
+	}
+
+	return 0;
+}
+
+void reconos_proc_control_reset_stats(int fd, int num) {
+	int i;
+
+	if (num >= 0 && num < NUM_HWTS) {
+		for (i = 0; i < PROC_CONTROL_PERF_COUNT; i++) {
+			proc_control_dev.ptr[PROC_CONTROL_PERF_REG(num, i)] = 0;
+			proc_control_dev.stats[num * PROC_CONTROL_PERF_COUNT + i] = 0;
+			proc_control_dev.stats_last[num * PROC_CONTROL_PERF_COUNT + i] = 0;
+		}
+	}
+}
+
 // void reconos_proc_control_hwt_signal(int fd, int num, int signal) {
 // 	if (sig){
 // 		if (hwt >= 0 && hwt < NUM_HWTS) {
@@ -386,6 +430,12 @@ void reconos_drv_init() {
 	if (!proc_control_dev.hwt_reset)
 		panic("[reconos-proc-control] failed to allocate memory\n");
 
+	// allocate memory for the accumulated performance counters
+	proc_control_dev.stats = (uint64_t*)calloc(NUM_HWTS * PROC_CONTROL_PERF_COUNT, sizeof(uint64_t));
+	proc_control_dev.stats_last = (uint32_t*)calloc(NUM_HWTS * PROC_CONTROL_PERF_COUNT, sizeof(uint32_t));
+	if (!proc_control_dev.stats || !proc_control_dev.stats_last)
+		panic("[reconos-proc-control] failed to allocate memory\n");
+
 	// reset entire system
 	for (i = 0; i < proc_control_dev.hwt_reset_count; i++)
 		proc_control_dev.hwt_reset[i] = 0xFFFFFFFF;
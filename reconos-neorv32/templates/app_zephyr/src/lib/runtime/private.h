@@ -25,6 +25,7 @@
 
 #include <stdint.h>
 #include <semaphore.h>
+#include <zephyr/kernel.h>
 
 
 /* == ReconOS proc control ============================================= */
@@ -37,6 +38,37 @@
 void *proc_pgfhandler(void *arg);
 
 
+/* == ReconOS bitstream ================================================ */
+
+/*
+ * Object representing a bitstream loaded into memory. Bitstreams are
+ * cached process-wide by their path and shared between all threads.
+ *
+ *   path   - path of the bitstream in the filesystem
+ *   data   - contents of the bitstream
+ *   length - length of the bitstream in bytes
+ *   mapped - indicates if data is mapped from the file
+ *   next   - next bitstream in the cache
+ */
+struct bitstream {
+	char *path;
+	char *data;
+	int length;
+	int mapped;
+
+	struct bitstream *next;
+};
+
+/*
+ * Returns the bitstream of the given path. The bitstream is only
+ * loaded from the filesystem if it is not already in the cache.
+ *
+ *   path - path of the bitstream
+ *
+ *   @returns pointer to the cached bitstream
+ */
+struct bitstream *bitstream_get(const char *path);
+
 /* == ReconOS hwslot =================================================== */
 
 /*
@@ -75,6 +107,8 @@ void *proc_pgfhandler(void *arg);
  *   dt_state  - state of the delegate thread
  *   dt_flags  - flags to the delegate thread
  *   dt_exit   - semaphore for synchronizing with the delegate on exit
+ *   dt_tid    - kernel thread id of the delegate thread
+ *   dt_prio   - priority the delegate thread was created with
  */
 struct hwslot {
 	int id;
@@ -86,6 +120,8 @@ struct hwslot {
 	int dt_state;
 	int dt_flags;
 	sem_t dt_exit;
+	k_tid_t dt_tid;
+	int dt_prio;
 };
 
 /*
@@ -118,6 +154,14 @@ void hwslot_setreset(struct hwslot *slot, int reset);
  */
 void hwslot_setsignal(struct hwslot *slot, int sig);
 
+/*
+ * Applies the scheduling attributes of the running thread to the
+ * delegate thread of the slot.
+ *
+ *   slot - pointer to the ReconOS slot
+ */
+void hwslot_setsched(struct hwslot *slot);
+
 /*
  * Creates a new delegate thread if not present.
  *
@@ -125,6 +125,9 @@ void reconos_thread_init(struct reconos_thread *rt,
 
 	rt->bitstreams = NULL;
 	rt->bitstream_lengths = NULL;
+
+	rt->priority = RECONOS_THREAD_PRIORITY_DEFAULT;
+	rt->deadline = RECONOS_THREAD_DEADLINE_NONE;
 }
 
 /*
@@ -195,46 +198,61 @@ void reconos_thread_setbitstream(struct reconos_thread *rt,
 	rt->bitstream_lengths = bitstream_lengths;
 }
 
+/*
+ * Replaces each %d in the bitstream path by the slot id.
+ *
+ *   buf  - buffer to write the path into
+ *   path - path of the bitstreams
+ *   slot - slot id
+ */
+static void bitstream_path(char *buf, const char *path, int slot) {
+	while (*path) {
+		if (path[0] == '%' && path[1] == 'd') {
+			buf += sprintf(buf, "%d", slot);
+			path += 2;
+		} else {
+			*buf++ = *path++;
+		}
+	}
+	*buf = '\0';
+}
+
 /*
  * @see header
  */
 void reconos_thread_loadbitstream(struct reconos_thread *rt,
                                   char *path) {
-	FILE *file;
-	unsigned int i, size;
+	struct bitstream *bs;
+	char *slot_path;
+	int i;
 
 	debug("[reconos-core] loading bitstreams from %s\n", path);
 
-	rt->bitstream_lengths = (int *)malloc(RECONOS_NUM_HWTS * sizeof(int));
+	rt->bitstream_lengths = (int *)calloc(RECONOS_NUM_HWTS, sizeof(int));
 	if (!rt->bitstream_lengths) {
 		panic("[reconos-core] ERROR: failed to allocate memory for bitstream");
 	}
 
-	rt->bitstreams = (char **)malloc(RECONOS_NUM_HWTS * sizeof(char *));
+	rt->bitstreams = (char **)calloc(RECONOS_NUM_HWTS, sizeof(char *));
 	if (!rt->bitstreams) {
 		panic("[reconos-core] ERROR: failed to allocate memory for bitstream");
 	}
 
-	for (i = 0; i < RECONOS_NUM_HWTS; i++) {
-		file = fopen(path, "rb");
-		if (!file) {
-			panic("[reconos-core] ERROR: failed to open bitstream\n");
-		}
-
-		fseek(file, 0L, SEEK_END);
-		size = ftell(file);
-		rewind(file);
-
-		rt->bitstream_lengths[i] = size;
-		rt->bitstreams[i] = (char *)malloc(size * sizeof(char));
-		if (!rt->bitstreams[i]) {
-			panic("[reconos-core] ERROR: failed to allocate memory for bitstream\n");
-		}
+	// a slot id has at most 10 digits
+	slot_path = (char *)malloc(strlen(path) * 5 + 1);
+	if (!slot_path) {
+		panic("[reconos-core] ERROR: failed to allocate memory for bitstream");
+	}
 
-		fread(rt->bitstreams[i], sizeof(char), size, file);
+	for (i = 0; i < rt->allowed_hwslot_count; i++) {
+		bitstream_path(slot_path, path, rt->allowed_hwslots[i]->id);
+		bs = bitstream_get(slot_path);
 
-		fclose(file);
+		rt->bitstreams[rt->allowed_hwslots[i]->id] = bs->data;
+		rt->bitstream_lengths[rt->allowed_hwslots[i]->id] = bs->length;
 	}
+
+	free(slot_path);
 }
 
 /*
@@ -245,6 +263,24 @@ void reconos_thread_setswentry(struct reconos_thread *rt,
 	rt->swentry = swentry;
 }
 
+/*
+ * @see header
+ */
+void reconos_thread_setpriority(struct reconos_thread *rt, int priority) {
+	rt->priority = priority;
+
+	if (rt->state == RECONOS_THREAD_STATE_RUNNING_HW) {
+		hwslot_setsched(rt->hwslot);
+	}
+}
+
+/*
+ * @see header
+ */
+void reconos_thread_setdeadline(struct reconos_thread *rt, int deadline) {
+	rt->deadline = deadline;
+}
+
 /*
  * @see header
  */
@@ -468,6 +504,39 @@ void reconos_cache_flush() {
 	reconos_proc_control_cache_flush(_proc_control);
 }
 
+/*
+ * @see header
+ */
+int reconos_stats_get(int slot, struct reconos_stats *stats) {
+	uint64_t count[6];
+
+	if (slot < 0 || slot >= RECONOS_NUM_HWTS) {
+		return -1;
+	}
+
+	if (reconos_proc_control_get_stats(_proc_control, slot, count) < 0) {
+		return -1;
+	}
+
+	stats->bytes_read = count[0];
+	stats->bytes_written = count[1];
+	stats->stall_cycles = count[2];
+	stats->tlb_hits = count[3];
+	stats->tlb_misses = count[4];
+	stats->page_faults = count[5];
+
+	return 0;
+}
+
+/*
+ * @see header
+ */
+void reconos_stats_reset(int slot) {
+	if (slot >= 0 && slot < RECONOS_NUM_HWTS) {
+		reconos_proc_control_reset_stats(_proc_control, slot);
+	}
+}
+
 
 /* == ReconOS proc control============================================== */
 
@@ -489,6 +558,68 @@ void *proc_pgfhandler(void *arg) {
 	}
 }
 
+/* == ReconOS bitstream ================================================ */
+
+static struct bitstream *_bitstreams;
+K_MUTEX_DEFINE(_bitstreams_lock);
+
+/*
+ * @see header
+ */
+struct bitstream *bitstream_get(const char *path) {
+	struct bitstream *bs;
+	FILE *file;
+
+	k_mutex_lock(&_bitstreams_lock, K_FOREVER);
+
+	for (bs = _bitstreams; bs; bs = bs->next) {
+		if (!strcmp(bs->path, path)) {
+			k_mutex_unlock(&_bitstreams_lock);
+			return bs;
+		}
+	}
+
+	debug("[reconos-core] loading bitstream %s\n", path);
+
+	bs = (struct bitstream *)malloc(sizeof(struct bitstream));
+	if (!bs) {
+		panic("[reconos-core] ERROR: failed to allocate memory for bitstream\n");
+	}
+
+	bs->path = strdup(path);
+	if (!bs->path) {
+		panic("[reconos-core] ERROR: failed to allocate memory for bitstream\n");
+	}
+
+	file = fopen(path, "rb");
+	if (!file) {
+		panic("[reconos-core] ERROR: failed to open bitstream %s\n", path);
+	}
+
+	fseek(file, 0L, SEEK_END);
+	bs->length = ftell(file);
+	rewind(file);
+
+	bs->mapped = 0;
+	bs->data = (char *)malloc(bs->length);
+	if (!bs->data) {
+		panic("[reconos-core] ERROR: failed to allocate memory for bitstream\n");
+	}
+
+	if (fread(bs->data, sizeof(char), bs->length, file) != bs->length) {
+		panic("[reconos-core] ERROR: failed to read bitstream %s\n", path);
+	}
+
+	fclose(file);
+
+	bs->next = _bitstreams;
+	_bitstreams = bs;
+
+	k_mutex_unlock(&_bitstreams_lock);
+
+	return bs;
+}
+
 /* == ReconOS hwslot =================================================== */
 
 /*
@@ -504,6 +635,8 @@ void hwslot_init(struct hwslot *slot, int id, int osif) {
 	slot->dt_state = DELEGATE_STATE_STOPPED;
 	slot->dt_flags = 0;
 	sem_init(&slot->dt_exit, 0, 0);
+	slot->dt_tid = NULL;
+	slot->dt_prio = 0;
 }
 
 /*
@@ -530,6 +663,21 @@ void hwslot_setsignal(struct hwslot *slot, int sig) {
 	//reconos_proc_control_hwt_signal(_proc_control, slot->id, sig);
 }
 
+/*
+ * @see header
+ */
+void hwslot_setsched(struct hwslot *slot) {
+	if (!slot->rt || !slot->dt_tid) {
+		return;
+	}
+
+	if (slot->rt->priority != RECONOS_THREAD_PRIORITY_DEFAULT) {
+		k_thread_priority_set(slot->dt_tid, slot->rt->priority);
+	} else {
+		k_thread_priority_set(slot->dt_tid, slot->dt_prio);
+	}
+}
+
 /*
  * @see header
  */
@@ -608,6 +756,7 @@ void hwslot_resumethread(struct hwslot *slot,
 	reconos_proc_control_hwt_reset(_proc_control, slot->id, 0);
 	
 	slot->rt = rt;
+	hwslot_setsched(slot);
 	
 	reconos_osif_write(slot->osif, (uint32_t)OSIF_SIGNAL_THREAD_RESUME);
 
@@ -1015,6 +1164,10 @@ void *dt_delegate(void *arg) {
 
 	slot = (struct hwslot *)arg;
 
+	slot->dt_tid = k_current_get();
+	slot->dt_prio = k_thread_priority_get(slot->dt_tid);
+	hwslot_setsched(slot);
+
 	slot->dt_state = DELEGATE_STATE_PROCESSING;
 
 	while (1) {
@@ -1029,6 +1182,13 @@ void *dt_delegate(void *arg) {
 		slot->dt_state = DELEGATE_STATE_PROCESSING;
 		debug("[reconos-dt-%d] received command 0x%x\n", slot->id, cmd);
 
+#ifdef CONFIG_SCHED_DEADLINE
+		// rearm deadline so that each syscall is scheduled relative to its arrival
+		if (slot->rt && slot->rt->deadline != RECONOS_THREAD_DEADLINE_NONE) {
+			k_thread_deadline_set(slot->dt_tid, k_us_to_cyc_ceil32(slot->rt->deadline));
+		}
+#endif
+
 		switch (cmd & OSIF_CMD_MASK) {
 			case OSIF_CMD_MBOX_PUT:
 				dt_mbox_put(slot);
@@ -87,6 +87,7 @@ import_pcore $ip_repo reconos_fifo_async_v1_00_a ""
 import_pcore $ip_repo reconos_fifo_sync_v1_00_a ""
 import_pcore $ip_repo reconos_hwt_idle_v1_00_a ""
 import_pcore $ip_repo reconos_memif_arbiter_v1_00_a "cs.upb.de:reconos:reconos:3.01.a"
+import_pcore $ip_repo reconos_memif_cache_v1_00_a "cs.upb.de:reconos:reconos:3.01.a"
 import_pcore $ip_repo reconos_memif_memory_controller_v1_00_a "cs.upb.de:reconos:reconos:3.01.a xilinx.com:ip:axi_master_burst:2.0"
 import_pcore $ip_repo reconos_memif_mmu_microblaze_v1_00_a ""
 import_pcore $ip_repo reconos_memif_mmu_zynq_v1_00_a "cs.upb.de:reconos:reconos:3.01.a"
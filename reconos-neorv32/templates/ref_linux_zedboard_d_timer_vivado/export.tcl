@@ -210,17 +210,25 @@ proc reconos_hw_setup {new_project_name new_project_path reconos_ip_dir} {
     
     create_bd_cell -type ip -vlnv cs.upb.de:reconos:reconos_memif_arbiter:1.0 reconos_memif_arbiter_0
     set_property -dict [list CONFIG.C_NUM_HWTS <<NUM_SLOTS>> ] [get_bd_cells reconos_memif_arbiter_0]
+    set_property -dict [list CONFIG.C_MEMIF_DATA_WIDTH <<MEMIF_DATA_WIDTH>> ] [get_bd_cells reconos_memif_arbiter_0]
     
     create_bd_cell -type ip -vlnv cs.upb.de:reconos:reconos_memif_memory_controller:1.0 reconos_memif_memory_controller_0
+    set_property -dict [list CONFIG.C_MEMIF_DATA_WIDTH <<MEMIF_DATA_WIDTH>> CONFIG.C_M_AXI_DATA_WIDTH <<MEMIF_DATA_WIDTH>> ] [get_bd_cells reconos_memif_memory_controller_0]
+    # the mmu passes the read enable through during the data of a request
+    set_property -dict [list CONFIG.C_PREFETCH 0 ] [get_bd_cells reconos_memif_memory_controller_0]
     create_bd_cell -type ip -vlnv cs.upb.de:reconos:reconos_memif_mmu_zynq:1.0 reconos_memif_mmu_zynq_0
+    set_property -dict [list CONFIG.C_MEMIF_DATA_WIDTH <<MEMIF_DATA_WIDTH>> ] [get_bd_cells reconos_memif_mmu_zynq_0]
     create_bd_cell -type ip -vlnv cs.upb.de:reconos:reconos_osif_intc:1.0 reconos_osif_intc_0
     set_property -dict [list CONFIG.C_NUM_INTERRUPTS <<NUM_SLOTS>> ] [get_bd_cells reconos_osif_intc_0]
     
     create_bd_cell -type ip -vlnv cs.upb.de:reconos:reconos_osif:1.0 reconos_osif_0
     set_property -dict [list CONFIG.C_NUM_HWTS  <<NUM_SLOTS>> ] [get_bd_cells reconos_osif_0]
+    # one page per osif to map them into user space separately (max. 16 slots)
+    set_property -dict [list CONFIG.C_OSIF_STRIDE {4096} ] [get_bd_cells reconos_osif_0]
     
     create_bd_cell -type ip -vlnv cs.upb.de:reconos:reconos_proc_control:1.0 reconos_proc_control_0
     set_property -dict [list CONFIG.C_NUM_HWTS  <<NUM_SLOTS>> ] [get_bd_cells reconos_proc_control_0]
+    set_property -dict [list CONFIG.C_MEMIF_DATA_WIDTH <<MEMIF_DATA_WIDTH>> ] [get_bd_cells reconos_proc_control_0]
     
     create_bd_cell -type ip -vlnv cs.upb.de:reconos:timer:1.0 timer_0
 
@@ -276,15 +284,13 @@ proc reconos_hw_setup {new_project_name new_project_path reconos_ip_dir} {
 
         connect_bd_intf_net [get_bd_intf_pins "slot_<<Id>>/MEMIF_Hwt2Mem"] [get_bd_intf_pins "reconos_fifo_memif_hwt2mem_<<Id>>/FIFO_M"]
         connect_bd_intf_net [get_bd_intf_pins "slot_<<Id>>/MEMIF_Mem2Hwt"] [get_bd_intf_pins "reconos_fifo_memif_mem2hwt_<<Id>>/FIFO_S"]
-        connect_bd_intf_net [get_bd_intf_pins "reconos_memif_arbiter_0/MEMIF_Hwt2Mem_<<Id>>"] [get_bd_intf_pins "reconos_fifo_memif_hwt2mem_<<Id>>/FIFO_S"]
-        connect_bd_intf_net [get_bd_intf_pins "reconos_memif_arbiter_0/MEMIF_Mem2Hwt_<<Id>>"] [get_bd_intf_pins "reconos_fifo_memif_mem2hwt_<<Id>>/FIFO_M"]
         
         # Set sizes of FIFOs
-        set_property -dict [list CONFIG.C_FIFO_ADDR_WIDTH {3}] [get_bd_cells "reconos_fifo_osif_hw2sw_<<Id>>"]
-        set_property -dict [list CONFIG.C_FIFO_ADDR_WIDTH {3}] [get_bd_cells "reconos_fifo_osif_sw2hw_<<Id>>"]
+        set_property -dict [list CONFIG.C_FIFO_ADDR_WIDTH {<<OsifFifoAddrWidth>>}] [get_bd_cells "reconos_fifo_osif_hw2sw_<<Id>>"]
+        set_property -dict [list CONFIG.C_FIFO_ADDR_WIDTH {<<OsifFifoAddrWidth>>}] [get_bd_cells "reconos_fifo_osif_sw2hw_<<Id>>"]
         
-        set_property -dict [list CONFIG.C_FIFO_ADDR_WIDTH {7}] [get_bd_cells "reconos_fifo_memif_hwt2mem_<<Id>>"]
-        set_property -dict [list CONFIG.C_FIFO_ADDR_WIDTH {7}] [get_bd_cells "reconos_fifo_memif_mem2hwt_<<Id>>"]
+        set_property -dict [list CONFIG.C_FIFO_ADDR_WIDTH {<<MemifFifoAddrWidth>>} CONFIG.C_FIFO_DATA_WIDTH {<<MEMIF_DATA_WIDTH>>}] [get_bd_cells "reconos_fifo_memif_hwt2mem_<<Id>>"]
+        set_property -dict [list CONFIG.C_FIFO_ADDR_WIDTH {<<MemifFifoAddrWidth>>} CONFIG.C_FIFO_DATA_WIDTH {<<MEMIF_DATA_WIDTH>>}] [get_bd_cells "reconos_fifo_memif_mem2hwt_<<Id>>"]
 
         # HWTs
         connect_bd_net [get_bd_pins reconos_clock_0/CLK<<Clk>>_Out] [get_bd_pins "slot_<<Id>>/HWT_Clk"]
@@ -300,6 +306,26 @@ proc reconos_hw_setup {new_project_name new_project_path reconos_ip_dir} {
         connect_bd_net [get_bd_pins "reconos_proc_control_0/PROC_Hwt_Signal_<<Id>>"] [get_bd_pins "slot_<<Id>>/HWT_Signal"]
 	<<end generate>>
 
+	# Connect memif FIFOs to the arbiter, optionally through a cache
+	<<generate for SLOTS(Cache == "none")>>
+        connect_bd_intf_net [get_bd_intf_pins "reconos_memif_arbiter_0/MEMIF_Hwt2Mem_<<Id>>"] [get_bd_intf_pins "reconos_fifo_memif_hwt2mem_<<Id>>/FIFO_S"]
+        connect_bd_intf_net [get_bd_intf_pins "reconos_memif_arbiter_0/MEMIF_Mem2Hwt_<<Id>>"] [get_bd_intf_pins "reconos_fifo_memif_mem2hwt_<<Id>>/FIFO_M"]
+	<<end generate>>
+
+	<<generate for SLOTS(Cache == "cache")>>
+        create_bd_cell -type ip -vlnv cs.upb.de:reconos:reconos_memif_cache:1.0 "reconos_memif_cache_<<Id>>"
+        set_property -dict [list CONFIG.C_CACHE_SETS {<<CacheSets>>} CONFIG.C_CACHE_WAYS {<<CacheWays>>} CONFIG.C_CACHE_LINE_BYTES {<<CacheLineBytes>>} CONFIG.C_MEMIF_DATA_WIDTH {<<MEMIF_DATA_WIDTH>>}] [get_bd_cells "reconos_memif_cache_<<Id>>"]
+
+        connect_bd_intf_net [get_bd_intf_pins "reconos_memif_cache_<<Id>>/MEMIF_Hwt2Mem_In"] [get_bd_intf_pins "reconos_fifo_memif_hwt2mem_<<Id>>/FIFO_S"]
+        connect_bd_intf_net [get_bd_intf_pins "reconos_memif_cache_<<Id>>/MEMIF_Mem2Hwt_In"] [get_bd_intf_pins "reconos_fifo_memif_mem2hwt_<<Id>>/FIFO_M"]
+        connect_bd_intf_net [get_bd_intf_pins "reconos_memif_arbiter_0/MEMIF_Hwt2Mem_<<Id>>"] [get_bd_intf_pins "reconos_memif_cache_<<Id>>/MEMIF_Hwt2Mem_Out"]
+        connect_bd_intf_net [get_bd_intf_pins "reconos_memif_arbiter_0/MEMIF_Mem2Hwt_<<Id>>"] [get_bd_intf_pins "reconos_memif_cache_<<Id>>/MEMIF_Mem2Hwt_Out"]
+
+        # the cache is invalidated on reset of the hwt
+        connect_bd_net [get_bd_pins reconos_clock_0/CLK<<SYSCLK>>_Out] [get_bd_pins "reconos_memif_cache_<<Id>>/SYS_Clk"]
+        connect_bd_net [get_bd_pins "reconos_proc_control_0/PROC_Hwt_Rst_<<Id>>"] [get_bd_pins "reconos_memif_cache_<<Id>>/SYS_Rst"]
+	<<end generate>>
+
 
     #
     # Connections between components
@@ -327,6 +353,12 @@ proc reconos_hw_setup {new_project_name new_project_path reconos_ip_dir} {
     connect_bd_net [get_bd_pins reconos_memif_mmu_zynq_0/MMU_Retry] [get_bd_pins reconos_proc_control_0/MMU_Retry]
     connect_bd_net [get_bd_pins reconos_memif_mmu_zynq_0/MMU_Pgd] [get_bd_pins reconos_proc_control_0/MMU_Pgd]
     connect_bd_net [get_bd_pins reconos_memif_mmu_zynq_0/MMU_Fault_Addr] [get_bd_pins reconos_proc_control_0/MMU_Fault_Addr]
+    connect_bd_net [get_bd_pins reconos_memif_mmu_zynq_0/MMU_Tlb_Hit] [get_bd_pins reconos_proc_control_0/MMU_Tlb_Hit]
+    connect_bd_net [get_bd_pins reconos_memif_mmu_zynq_0/MMU_Tlb_Miss] [get_bd_pins reconos_proc_control_0/MMU_Tlb_Miss]
+    connect_bd_net [get_bd_pins reconos_memif_arbiter_0/PERF_Grant] [get_bd_pins reconos_proc_control_0/PERF_Grant]
+    connect_bd_net [get_bd_pins reconos_memif_arbiter_0/PERF_Rd] [get_bd_pins reconos_proc_control_0/PERF_Rd]
+    connect_bd_net [get_bd_pins reconos_memif_arbiter_0/PERF_Wr] [get_bd_pins reconos_proc_control_0/PERF_Wr]
+    connect_bd_net [get_bd_pins reconos_memif_arbiter_0/PERF_Stall] [get_bd_pins reconos_proc_control_0/PERF_Stall]
     set_property -dict [list CONFIG.C_TLB_SIZE {16}] [get_bd_cells reconos_memif_mmu_zynq_0]
 
     #
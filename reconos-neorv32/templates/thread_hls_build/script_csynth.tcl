@@ -4,7 +4,7 @@ open_project hls
 set_top rt_imp
 add_files reconos_calls.h
 add_files reconos_thread.h
-add_files [ glob *.cpp ]
+add_files [ glob *.cpp ] -cflags "-DMEMIF_DATA_WIDTH=<<MEMIF_DATA_WIDTH>><<generate for HWOPTIONS>> -D<<Option>><<end generate>>"
 open_solution sol
 set_part {<<PART>>}
 create_clock -period <<CLKPRD>> -name default
@@ -0,0 +1,145 @@
+<<reconos_preproc>>
+#include "reconos_calls.h"
+#include "reconos_thread.h"
+
+#include "stdint.h"
+
+/*
+ * Hardware thread processing blocks of BLOCK_BYTES bytes in a dataflow
+ * pipeline. The thread receives the address of a block via the mbox
+ * <<RES_IN>>, streams it through the compute process and writes the
+ * result back in place before acknowledging the address via the mbox
+ * <<RES_OUT>>.
+ *
+ * The pipeline consists of three processes connected by streams, which
+ * run concurrently:
+ *
+ *   <<NAME>>_read    - receives the data from the memif
+ *   <<NAME>>_compute - the kernel, processing one memif word per cycle
+ *   <<NAME>>_memif   - issues the requests to the memif and sends the
+ *                      results
+ *
+ * The memif serves requests in order, so that reads and writes are
+ * interleaved by the memif process. A write is issued only when the data
+ * of all but the last read has been requested, and the input stream
+ * buffers the data of two requests, so that the reads never wait for the
+ * writes behind them.
+ */
+
+#define BLOCK_BYTES (64 * 1024)
+
+#define STREAM_DEPTH (2 * MEMIF_CHUNK_BYTES / MEMIF_DATA_BYTES)
+
+/*
+ * Receives len bytes from the memif.
+ *
+ *   mem2hwt - memif stream from the memory
+ *   in      - stream to the compute process
+ *   len     - number of bytes to receive
+ */
+void <<NAME>>_read(hls::stream<memif_word_t> &mem2hwt,
+                   hls::stream<memif_word_t> &in, uint32_t len) {
+	for (uint32_t i = 0; i < len; i += MEMIF_DATA_BYTES) {
+#pragma HLS pipeline II=1
+		in.write(mem2hwt.read());
+	}
+}
+
+/*
+ * Processes len bytes. Replace the body of the loop by the kernel.
+ *
+ *   in  - stream from the read process
+ *   out - stream to the memif process
+ *   len - number of bytes to process
+ */
+void <<NAME>>_compute(hls::stream<memif_word_t> &in,
+                      hls::stream<memif_word_t> &out, uint32_t len) {
+	for (uint32_t i = 0; i < len; i += MEMIF_DATA_BYTES) {
+#pragma HLS pipeline II=1
+		memif_word_t data = in.read();
+
+		for (uint32_t l = 0; l < MEMIF_DATA_WORDS; l++) {
+#pragma HLS unroll
+			memif_word_set(data, l, memif_word_get(data, l) + 1);
+		}
+
+		out.write(data);
+	}
+}
+
+/*
+ * Reads len bytes from src and writes the results to dst, interleaving
+ * the requests as described above.
+ *
+ *   hwt2mem - memif stream to the memory
+ *   out     - stream from the compute process
+ *   src     - address to read from
+ *   dst     - address to write to
+ *   len     - number of bytes to transfer
+ */
+void <<NAME>>_memif(hls::stream<memif_word_t> &hwt2mem,
+                    hls::stream<memif_word_t> &out,
+                    uint32_t src, uint32_t dst, uint32_t len) {
+	uint32_t rd_addr = src, rd_rem = len, rd_len = 0, rd_done = 0;
+	uint32_t wr_addr = dst, wr_rem = len, wr_len, wr_done = 0;
+
+	while (wr_rem > 0) {
+		if (rd_rem > 0) {
+			rd_done += rd_len;
+			rd_len = memif_request_len(rd_addr, rd_rem);
+			stream_write(hwt2mem, MEMIF_CMD_READ | rd_len);
+			stream_write(hwt2mem, rd_addr);
+			rd_addr += rd_len;
+			rd_rem -= rd_len;
+		} else {
+			rd_done += rd_len;
+			rd_len = 0;
+		}
+
+		wr_len = memif_request_len(wr_addr, wr_rem);
+		while (wr_rem > 0 && wr_done + wr_len <= rd_done) {
+			stream_write(hwt2mem, MEMIF_CMD_WRITE | wr_len);
+			stream_write(hwt2mem, wr_addr);
+			for (uint32_t i = 0; i < wr_len; i += MEMIF_DATA_BYTES) {
+#pragma HLS pipeline II=1
+				hwt2mem.write(out.read());
+			}
+			wr_addr += wr_len;
+			wr_rem -= wr_len;
+			wr_done += wr_len;
+			wr_len = memif_request_len(wr_addr, wr_rem);
+		}
+	}
+}
+
+/*
+ * Processes a block in a dataflow region.
+ */
+void <<NAME>>_block(hls::stream<memif_word_t> &hwt2mem,
+                    hls::stream<memif_word_t> &mem2hwt,
+                    uint32_t src, uint32_t dst, uint32_t len) {
+#pragma HLS dataflow
+	hls::stream<memif_word_t> in;
+	hls::stream<memif_word_t> out;
+	HLS_PRAGMA(HLS stream variable=in depth=STREAM_DEPTH)
+	HLS_PRAGMA(HLS stream variable=out depth=STREAM_DEPTH)
+
+	<<NAME>>_read(mem2hwt, in, len);
+	<<NAME>>_compute(in, out, len);
+	<<NAME>>_memif(hwt2mem, out, src, dst, len);
+}
+
+THREAD_ENTRY() {
+	THREAD_INIT();
+
+	while (1) {
+		uint32_t addr = MBOX_GET(<<RES_IN>>);
+		if (addr == 0xFFFFFFFF) {
+			THREAD_EXIT();
+		}
+
+		<<NAME>>_block(memif_hwt2mem, memif_mem2hwt, addr, addr, BLOCK_BYTES);
+
+		MBOX_PUT(<<RES_OUT>>, addr);
+	}
+}
@@ -17,11 +17,11 @@ entity rt_<<NAME>> is
 		OSIF_Hw2Sw_WE      : out std_logic;
 
 		-- MEMIF FIFO ports
-		MEMIF_Hwt2Mem_Data    : out std_logic_vector(31 downto 0);
+		MEMIF_Hwt2Mem_Data    : out std_logic_vector(<<MEMIF_DATA_WIDTH>> - 1 downto 0);
 		MEMIF_Hwt2Mem_Full    : in  std_logic;
 		MEMIF_Hwt2Mem_WE      : out std_logic;
 
-		MEMIF_Mem2Hwt_Data    : in  std_logic_vector(31 downto 0);
+		MEMIF_Mem2Hwt_Data    : in  std_logic_vector(<<MEMIF_DATA_WIDTH>> - 1 downto 0);
 		MEMIF_Mem2Hwt_Empty   : in  std_logic;
 		MEMIF_Mem2Hwt_RE      : out std_logic;
 
@@ -74,11 +74,11 @@ architecture implementation of rt_<<NAME>> is
 			osif_hw2sw_v_full_n  : in std_logic;
 			osif_hw2sw_v_write   : out std_logic;
 
-			memif_hwt2mem_v_din     : out std_logic_vector (31 downto 0);
+			memif_hwt2mem_v_din     : out std_logic_vector (<<MEMIF_DATA_WIDTH>> - 1 downto 0);
 			memif_hwt2mem_v_full_n  : in std_logic;
 			memif_hwt2mem_v_write   : out std_logic;
 
-			memif_mem2hwt_v_dout    : in std_logic_vector (31 downto 0);
+			memif_mem2hwt_v_dout    : in std_logic_vector (<<MEMIF_DATA_WIDTH>> - 1 downto 0);
 			memif_mem2hwt_v_empty_n : in std_logic;
 			memif_mem2hwt_v_read    : out std_logic
 		);
@@ -92,11 +92,11 @@ architecture implementation of rt_<<NAME>> is
 	signal osif_hw2sw_v_full_n  : std_logic;
 	signal osif_hw2sw_v_write   : std_logic;
 
-	signal memif_hwt2mem_v_din     : std_logic_vector(31 downto 0);
+	signal memif_hwt2mem_v_din     : std_logic_vector(<<MEMIF_DATA_WIDTH>> - 1 downto 0);
 	signal memif_hwt2mem_v_full_n  : std_logic;
 	signal memif_hwt2mem_v_write   : std_logic;
 
-	signal memif_mem2hwt_v_dout    : std_logic_vector(31 downto 0);
+	signal memif_mem2hwt_v_dout    : std_logic_vector(<<MEMIF_DATA_WIDTH>> - 1 downto 0);
 	signal memif_mem2hwt_v_empty_n : std_logic;
 	signal memif_mem2hwt_v_read    : std_logic;
 begin
@@ -122,10 +122,10 @@ begin
 	DEBUG(101 downto 70) <= osif_hw2sw_v_din;
 	DEBUG(69) <= not osif_hw2sw_v_full_n;
 	DEBUG(68) <= osif_hw2sw_v_write;
-	DEBUG(67 downto 36) <= memif_hwt2mem_v_din;
+	DEBUG(67 downto 36) <= memif_hwt2mem_v_din(31 downto 0);
 	DEBUG(35) <= not memif_hwt2mem_v_full_n;
 	DEBUG(34) <= memif_hwt2mem_v_write;
-	DEBUG(33 downto 2) <= memif_mem2hwt_v_dout;
+	DEBUG(33 downto 2) <= memif_mem2hwt_v_dout(31 downto 0);
 	DEBUG(1) <= not memif_mem2hwt_v_empty_n;
 	DEBUG(0) <= memif_mem2hwt_v_read;
 
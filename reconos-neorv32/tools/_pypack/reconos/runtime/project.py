@@ -78,12 +78,16 @@ class Resource:
 # Class representing a slot in the project.
 #
 class Slot:
-	def __init__(self, name, id_, clock, ports):
+	def __init__(self, name, id_, clock, ports, cache=None, osif_fifo_depth=8, memif_fifo_depth=128, memif_weight=1):
 		self.name = name
 		self.id = id_
 		self.clock = clock
 		self.threads = []
 		self.ports = ports
+		self.cache = cache
+		self.osif_fifo_depth = osif_fifo_depth
+		self.memif_fifo_depth = memif_fifo_depth
+		self.memif_weight = memif_weight
 
 	def __str__(self):
 		return "Slot '" + self.name + "' (" + str(self.id) + ")"
@@ -155,6 +159,8 @@ class ImpInfo:
 		self.xil = ""
 		self.xil_path = ""
 		self.hls = ""
+		self.bitcomp = ""
+		self.memif_width = 32
 
 		self.os = ""
 		self.cflags = ""
@@ -267,6 +273,14 @@ class Project:
 			self.impinfo.xil_path = cfg.get("General", "XilinxPath")
 		else:
 			self.impinfo.xil_path = "/opt/Xilinx"
+		if cfg.has_option("General", "BitstreamCompression"):
+			self.impinfo.bitcomp = cfg.get("General", "BitstreamCompression")
+		else:
+			self.impinfo.bitcomp = ""
+		if cfg.has_option("General", "MemifWidth"):
+			self.impinfo.memif_width = cfg.getint("General", "MemifWidth")
+		else:
+			self.impinfo.memif_width = 32
 
 		log.debug("Found project '" + str(self.name) + "' (" + str(self.impinfo.board) + "," + str(self.impinfo.os) + ")")
 
@@ -345,10 +359,35 @@ class Project:
 			else:
 				ports = []
 
+			# optional memif cache given by sets, ways and line size
+			if cfg.has_option(s, "MemifCache"):
+				cache = [int(_) for _ in cfg.get(s, "MemifCache").split(",")]
+				if len(cache) == 2:
+					cache.append(32)
+			else:
+				cache = None
+
+			# depths of the fifos between the slot and the osif and memif
+			if cfg.has_option(s, "OsifFifoDepth"):
+				osif_fifo_depth = cfg.getint(s, "OsifFifoDepth")
+			else:
+				osif_fifo_depth = 8
+
+			if cfg.has_option(s, "MemifFifoDepth"):
+				memif_fifo_depth = cfg.getint(s, "MemifFifoDepth")
+			else:
+				memif_fifo_depth = 128
+
+			# number of requests granted per round of the memif arbiter
+			if cfg.has_option(s, "MemifWeight"):
+				memif_weight = cfg.getint(s, "MemifWeight")
+			else:
+				memif_weight = 1
+
 			for i in r:
 				log.debug("Found slot '" + str(name) + "(" + str(i) + ")" + "' (" + str(id_) + "," + str(clock[0]) + ")")
 
-				slot = Slot(name + "(" + str(i) + ")", id_ + i, clock[0], ports)
+				slot = Slot(name + "(" + str(i) + ")", id_ + i, clock[0], ports, cache, osif_fifo_depth, memif_fifo_depth, memif_weight)
 				self.slots.append(slot)
 
 	#
@@ -419,3 +458,33 @@ class Project:
 		if (hlsNeeded == True) and (self.impinfo.hls==""):
 			log.error("Thread has HLS sources, but no HLS tool is specified. Please specify TargetHls variable in General section in build.cfg")
 			exit(1)
+
+		#
+		# Check if the width of the memif is supported by the hardware
+		#
+		if self.impinfo.memif_width not in [32, 64, 128]:
+			log.error("MemifWidth must be 32, 64 or 128 bit. Please correct MemifWidth in General section in build.cfg")
+			exit(1)
+
+		#
+		# Check if the fifos, weights and memif caches of the slots are
+		# supported by the hardware
+		#
+		def pow2(x):
+			return x > 0 and x & (x - 1) == 0
+		for s in self.slots:
+			if not pow2(s.osif_fifo_depth) or s.osif_fifo_depth < 4:
+				log.error("OsifFifoDepth of slot " + str(s) + " must be a power of two of at least 4. Please correct OsifFifoDepth in build.cfg")
+				exit(1)
+			if not pow2(s.memif_fifo_depth) or s.memif_fifo_depth < 4:
+				log.error("MemifFifoDepth of slot " + str(s) + " must be a power of two of at least 4. Please correct MemifFifoDepth in build.cfg")
+				exit(1)
+			if s.memif_weight < 1 or s.memif_weight > 15:
+				log.error("MemifWeight of slot " + str(s) + " must be between 1 and 15. Please correct MemifWeight in build.cfg")
+				exit(1)
+
+		for s in [_ for _ in self.slots if _.cache is not None]:
+			if len(s.cache) != 3 or not pow2(s.cache[0]) or s.cache[1] < 1 \
+			   or not pow2(s.cache[2]) or s.cache[2] % (self.impinfo.memif_width // 8) != 0 or s.cache[2] > 256:
+				log.error("MemifCache of slot " + str(s) + " must be <sets>,<ways>[,<line bytes>], where sets and line bytes are powers of two and a line holds at least one memif word and at most 256 bytes. Please correct MemifCache in build.cfg")
+				exit(1)
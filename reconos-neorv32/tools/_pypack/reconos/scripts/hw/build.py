@@ -1,5 +1,6 @@
 import reconos.utils.shutil2 as shutil2
 import reconos.utils.template as template
+import reconos.scripts.hw.compress as compress
 
 import logging
 import argparse
@@ -46,3 +47,8 @@ def _build_vivado(prj, hwdir):
 	print()
 
 	shutil2.chdir(prj.dir)
+
+	if prj.impinfo.bitcomp == "rle":
+		compress.compress(prj, hwdir)
+	elif prj.impinfo.bitcomp:
+		log.error("Bitstream compression '" + prj.impinfo.bitcomp + "' not supported")
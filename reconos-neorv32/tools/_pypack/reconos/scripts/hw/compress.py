@@ -0,0 +1,35 @@
+import reconos.utils.shutil2 as shutil2
+import reconos.utils.bitstream as bitstream
+
+import logging
+import argparse
+
+log = logging.getLogger(__name__)
+
+def get_cmd(prj):
+	return "compress_hw"
+
+def get_call(prj):
+	return compress_cmd
+
+def get_parser(prj):
+	parser = argparse.ArgumentParser("compress_hw", description="""
+		Compresses the binary bitstreams (*.bin) of the hardware
+		project to be loaded by the ReconOS runtime.
+		""")
+	parser.add_argument("hwdir", help="alternative export directory", nargs="?")
+	return parser
+
+def compress_cmd(args):
+	compress(args.prj, args.hwdir)
+
+def compress(prj, hwdir):
+	hwdir = hwdir if hwdir is not None else prj.basedir + ".hw"
+
+	if not shutil2.isdir(hwdir):
+		log.error("hardware directory '" + hwdir + "' not found")
+		return
+
+	for f in shutil2.listfiles(hwdir, True, "bin$", False):
+		size, comp = bitstream.compress_file(f, f + ".rle")
+		log.info("compressed '" + f + "' from " + str(size) + " to " + str(comp) + " bytes")
@@ -0,0 +1,60 @@
+import reconos.utils.shutil2 as shutil2
+
+import logging
+import argparse
+
+log = logging.getLogger(__name__)
+
+def get_cmd(prj):
+	return "create_hwt"
+
+def get_call(prj):
+	return create_cmd
+
+def get_parser(prj):
+	parser = argparse.ArgumentParser("create_hwt", description="""
+		Creates the hardware sources of a thread from a template.
+		""")
+	parser.add_argument("-t", "--template", help="template to start from", choices=["dataflow"], default="dataflow")
+	parser.add_argument("thread", help="name of the thread as specified in the project file")
+	return parser
+
+def create_cmd(args):
+	create(args, args.thread, args.template)
+
+def create(args, thread, tmpl):
+	'''
+	Creates the hls sources of a thread in src/rt_<thread>/hls of the
+	project, which are processed by a pipeline of dataflow processes.
+
+	The first two mbox resources of the thread are used to receive the
+	address of a block and to acknowledge it.
+	'''
+	prj = args.prj
+
+	threads = [_ for _ in prj.threads if _.name == thread]
+	if len(threads) != 1:
+		log.error("Thread '" + thread + "' not found")
+		return
+	thread = threads[0]
+
+	srcdir = shutil2.join(prj.dir, "src", "rt_" + thread.name.lower())
+	hwdir = shutil2.join(srcdir, "hls")
+	if shutil2.exists(hwdir):
+		log.error("Hardware sources '" + hwdir + "' already exist")
+		return
+
+	mboxes = [(r.group + "_" + r.name).lower() for r in thread.resources if r.type == "mbox"]
+	if len(mboxes) < 2:
+		log.warning("Thread has less than two mboxes, please adapt the generated sources")
+		mboxes += ["resources_address", "resources_acknowledge"][len(mboxes):]
+
+	dictionary = {}
+	dictionary["NAME"] = thread.name.lower()
+	dictionary["RES_IN"] = mboxes[0]
+	dictionary["RES_OUT"] = mboxes[1]
+
+	log.info("Creating hardware sources in '" + hwdir + "' ...")
+	shutil2.mkdir(shutil2.join(prj.dir, "src"))
+	shutil2.mkdir(srcdir)
+	prj.apply_template("thread_hls_" + tmpl, dictionary, hwdir)
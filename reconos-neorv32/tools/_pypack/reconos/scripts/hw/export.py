@@ -32,6 +32,7 @@ def get_dict(prj):
 	dictionary["SYSCLK"] = prj.clock.id
 	dictionary["SYSRST"] = "SYSRESET"
 	dictionary["TOOL"]   = prj.impinfo.xil[0]
+	dictionary["MEMIF_DATA_WIDTH"] = prj.impinfo.memif_width
 	dictionary["SLOTS"] = []
 	for s in prj.slots:
 		if s.threads:
@@ -45,6 +46,12 @@ def get_dict(prj):
 			d["Clk"] = s.clock.id
 			d["Async"] = "sync" if s.clock == prj.clock else "async"
 			d["Ports"] = s.ports
+			d["OsifFifoAddrWidth"] = s.osif_fifo_depth.bit_length() - 1
+			d["MemifFifoAddrWidth"] = s.memif_fifo_depth.bit_length() - 1
+			d["MemifWeight"] = s.memif_weight
+			d["Cache"] = "cache" if s.cache else "none"
+			if s.cache:
+				d["CacheSets"], d["CacheWays"], d["CacheLineBytes"] = s.cache
 			dictionary["SLOTS"].append(d)
 	dictionary["CLOCKS"] = []
 	for c in prj.clocks:
@@ -108,6 +115,7 @@ def _export_hw_thread_vivado(prj, hwdir, link, thread):
 		dictionary["NAME"] = thread.name.lower()
 		dictionary["MEM"] = thread.mem
 		dictionary["MEM_N"] = not thread.mem
+		dictionary["MEMIF_DATA_WIDTH"] = prj.impinfo.memif_width
 		dictionary["CLKPRD"] = min([_.clock.get_periodns() for _ in thread.slots])
 		srcs = shutil2.join(prj.dir, "src", "rt_" + thread.name.lower(), thread.hwsource)
 		dictionary["SOURCES"] = [srcs]
@@ -134,11 +142,13 @@ def _export_hw_thread_vivado(prj, hwdir, link, thread):
 		dictionary["NAME"] = thread.name.lower()
 		dictionary["MEM"] = thread.mem
 		dictionary["MEM_N"] = not thread.mem
+		dictionary["MEMIF_DATA_WIDTH"] = prj.impinfo.memif_width
 		dictionary["CLKPRD"] = min([_.clock.get_periodns() for _ in thread.slots])
 		srcs = shutil2.join(prj.dir, "src", "rt_" + thread.name.lower(), thread.hwsource)
 		dictionary["SOURCES"] = [srcs]
 		files = shutil2.listfiles(srcs, True)
 		dictionary["FILES"] = [{"File": _} for _ in files]
+		dictionary["HWOPTIONS"] = [{"Option": _.strip()} for _ in thread.hwoptions if _.strip()]
 		dictionary["RESOURCES"] = []
 		for i, r in enumerate(thread.resources):
 			d = {}
@@ -166,6 +176,7 @@ def _export_hw_thread_vivado(prj, hwdir, link, thread):
 		dictionary["NAME"] = thread.name.lower()
 		dictionary["MEM"] = thread.mem
 		dictionary["MEM_N"] = not thread.mem
+		dictionary["MEMIF_DATA_WIDTH"] = prj.impinfo.memif_width
 		srcs = shutil2.join(tmp.name, "hls", "sol", "syn", "vhdl")
 		dictionary["SOURCES"] = [srcs]
 		incls = shutil2.listfiles(srcs, True)
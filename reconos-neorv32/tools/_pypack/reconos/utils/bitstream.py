@@ -0,0 +1,102 @@
+#                                                        ____  _____
+#                            ________  _________  ____  / __ \/ ___/
+#                           / ___/ _ \/ ___/ __ \/ __ \/ / / /\__ \
+#                          / /  /  __/ /__/ /_/ / / / / /_/ /___/ /
+#                         /_/   \___/\___/\____/_/ /_/\____//____/
+# 
+# ======================================================================
+# 
+#   project:      ReconOS - Toolchain
+#   author:       Christoph Rüthing, University of Paderborn
+#   description:  A utils script to compress bitstreams.
+# 
+# ======================================================================
+
+import struct
+
+#
+# Format of compressed bitstreams as decoded by the runtime. All fields
+# are 32 bit little endian words:
+#
+#   magic  - RLE_MAGIC
+#   length - length of the uncompressed bitstream in bytes
+#   blocks - sequence of blocks, each starting with a control word
+#            RLE_RUN | n:  the next word is repeated n times
+#            n:            the next n words are copied
+#
+RLE_MAGIC = 0x454C5252
+RLE_RUN = 0x80000000
+RLE_MAX = 0x7FFFFFFF
+RLE_MIN_RUN = 3
+
+def is_compressed(data):
+	return len(data) >= 8 and struct.unpack_from("<I", data)[0] == RLE_MAGIC
+
+def compress(data):
+	if len(data) % 4 != 0:
+		raise ValueError("bitstream length is not a multiple of 4")
+
+	words = struct.unpack("<" + str(len(data) // 4) + "I", data)
+	out = [RLE_MAGIC, len(data)]
+	literal = []
+
+	def flush():
+		if literal:
+			out.append(len(literal))
+			out.extend(literal)
+			del literal[:]
+
+	i = 0
+	while i < len(words):
+		j = i + 1
+		while j < len(words) and words[j] == words[i] and j - i < RLE_MAX:
+			j += 1
+
+		if j - i >= RLE_MIN_RUN:
+			flush()
+			out.append(RLE_RUN | (j - i))
+			out.append(words[i])
+		else:
+			literal.extend(words[i:j])
+			if len(literal) >= RLE_MAX:
+				flush()
+		i = j
+
+	flush()
+
+	return struct.pack("<" + str(len(out)) + "I", *out)
+
+def decompress(data):
+	magic, length = struct.unpack_from("<II", data)
+	if magic != RLE_MAGIC:
+		raise ValueError("bitstream is not compressed")
+
+	words = struct.unpack("<" + str(len(data) // 4) + "I", data)
+	out = []
+
+	i = 2
+	while i < len(words):
+		if words[i] & RLE_RUN:
+			out.extend([words[i + 1]] * (words[i] & RLE_MAX))
+			i += 2
+		else:
+			out.extend(words[i + 1:i + 1 + words[i]])
+			i += 1 + words[i]
+
+	if len(out) * 4 != length:
+		raise ValueError("corrupted bitstream")
+
+	return struct.pack("<" + str(len(out)) + "I", *out)
+
+def compress_file(src, dst):
+	with open(src, "rb") as f:
+		data = f.read()
+
+	if is_compressed(data):
+		return len(data), len(data)
+
+	comp = compress(data)
+	with open(dst, "wb") as f:
+		f.write(comp)
+
+	return len(data), len(comp)
@@ -249,13 +249,13 @@ cd $WD/linux-xlnx
 if [[ $ROOTFS = 1 ]]; then
   BOOTARGS="    bootargs = \"console=ttyPS0,115200 root=/dev/nfs rw nfsroot=${HOSTIP}:${WD}/nfs,tcp,nfsvers=3 ip=${BOARDIP}:::255.255.255.0:reconos:eth0:off earlyprintk\";"
   sed -i "s|.*bootargs.*|$BOOTARGS|" ${WD}/linux-xlnx/arch/arm/boot/dts/zynq-zed.dts
-  sed -i '/.*drv-vbus.*/a };\namba: amba {\nreconos_osif: reconos_osif@75a00000 {\ncompatible = "upb,reconos-osif-3.1";\nreg = <0x75a00000 0x10000>;\n};\nreconos_osif_intc: reconos_osif_intc@7b400000 {\ncompatible = "upb,reconos-osif-intc-3.1";\nreg = <0x7b400000 0x10000>;\ninterrup-parent = <&intc>;\ninterrupts = <0 58 4>;\n};\nreconos_proc_control: reconos_proc_control@6fe00000 {\ncompatible = "upb,reconos-control-3.1";\nreg = <0x6fe00000 0x10000>;\ninterrupt-parent = <&intc>;\ninterrupts = <0 59 4>;\n};' ${WD}/linux-xlnx/arch/arm/boot/dts/zynq-zed.dts
+  sed -i '/.*drv-vbus.*/a };\namba: amba {\nreconos_osif: reconos_osif@75a00000 {\ncompatible = "upb,reconos-osif-3.1";\nreg = <0x75a00000 0x10000>;\nreconos,osif-stride = <0x1000>;\n};\nreconos_timer: reconos_timer@64a00000 {\ncompatible = "upb,reconos-timer-1.0";\nreg = <0x64a00000 0x10000>;\n};\nreconos_osif_intc: reconos_osif_intc@7b400000 {\ncompatible = "upb,reconos-osif-intc-3.1";\nreg = <0x7b400000 0x10000>;\ninterrup-parent = <&intc>;\ninterrupts = <0 58 4>;\n};\nreconos_proc_control: reconos_proc_control@6fe00000 {\ncompatible = "upb,reconos-control-3.1";\nreg = <0x6fe00000 0x10000>;\ninterrupt-parent = <&intc>;\ninterrupts = <0 59 4>;\n};' ${WD}/linux-xlnx/arch/arm/boot/dts/zynq-zed.dts
   # patch for develop-ic (not tested)
   # sed -i '/.*drv-vbus.*/a };\namba: amba {\nreconos_osif: reconos_osif@75a00000 {\ncompatible = "upb,reconos-osif-3.1";\nreg = <0x75a00000 0x10000>;\ninterrup-parent = <&intc>;\ninterrupts = <0 58 4>;\n};\nreconos_proc_control: reconos_proc_control@6fe00000 {\ncompatible = "upb,reconos-control-3.1";\nreg = <0x6fe00000 0x10000>;\ninterrupt-parent = <&intc>;\ninterrupts = <0 59 4>;\n};' ${WD}/linux-xlnx/arch/arm/boot/dts/zynq-zed.dts
 else
   BOOTARGS="    bootargs = \"console=ttyPS0,115200 root=/dev/ram rw initrd=0x4000000 earlyprintk\";"
   sed -i "s|.*bootargs.*|$BOOTARGS|" ${WD}/linux-xlnx/arch/arm/boot/dts/zynq-zed.dts
-  sed -i '/.*drv-vbus.*/a };\namba: amba {\nreconos_osif: reconos_osif@75a00000 {\ncompatible = "upb,reconos-osif-3.1";\nreg = <0x75a00000 0x10000>;\n};\nreconos_osif_intc: reconos_osif_intc@7b400000 {\ncompatible = "upb,reconos-osif-intc-3.1";\nreg = <0x7b400000 0x10000>;\ninterrup-parent = <&intc>;\ninterrupts = <0 58 4>;\n};\nreconos_proc_control: reconos_proc_control@6fe00000 {\ncompatible = "upb,reconos-control-3.1";\nreg = <0x6fe00000 0x10000>;\ninterrupt-parent = <&intc>;\ninterrupts = <0 59 4>;\n};' ${WD}/linux-xlnx/arch/arm/boot/dts/zynq-zed.dts
+  sed -i '/.*drv-vbus.*/a };\namba: amba {\nreconos_osif: reconos_osif@75a00000 {\ncompatible = "upb,reconos-osif-3.1";\nreg = <0x75a00000 0x10000>;\nreconos,osif-stride = <0x1000>;\n};\nreconos_timer: reconos_timer@64a00000 {\ncompatible = "upb,reconos-timer-1.0";\nreg = <0x64a00000 0x10000>;\n};\nreconos_osif_intc: reconos_osif_intc@7b400000 {\ncompatible = "upb,reconos-osif-intc-3.1";\nreg = <0x7b400000 0x10000>;\ninterrup-parent = <&intc>;\ninterrupts = <0 58 4>;\n};\nreconos_proc_control: reconos_proc_control@6fe00000 {\ncompatible = "upb,reconos-control-3.1";\nreg = <0x6fe00000 0x10000>;\ninterrupt-parent = <&intc>;\ninterrupts = <0 59 4>;\n};' ${WD}/linux-xlnx/arch/arm/boot/dts/zynq-zed.dts
 fi
 
 make -j"$(nproc)" uImage LOADADDR=0x00008000